@@ -38,6 +38,13 @@
    2022-10-07  v1.1  T. JOUBERT  S=Rainbow
    2022-10-16  v2.0  T. JOUBERT  T=text 
    2022-10-22  v2.1  T. JOUBERT  t=text reversed and ON/OFF
+   2026-10-15  v2.2  T. JOUBERT  Serpentine table
+   2026-10-15  v2.3  T. JOUBERT  Non-blocking sequences, HTTP latency
+   2026-10-15  v2.4  T. JOUBERT  HTTP request parser and route table
+   2026-10-15  v2.5  T. JOUBERT  Stage histograms, /stats route
+   2026-10-15  v2.6  T. JOUBERT  Matrix layout from ledmap.h
+   2026-10-15  v2.7  T. JOUBERT  Packed motifs in flash (bigmotif.h)
+   2026-10-15  v2.8  T. JOUBERT  Scrolling viewport, text rasterized once
     ================================================================
 
     Ce code suit la structure generale du code Arduino :
@@ -69,7 +76,7 @@
 
     La sequence d'origine est la 11 avec un texte qui donne la version courante du
     logiciel. Les sequences 0, 7 et 8 sont calculees au moment de l'affichage. Les
-    autres sequences utilisent des motifs definis au debut du code source dans des
+    autres sequences utilisent des motifs definis dans motifsBIG.h dans des
     tableaux d'octets (char) :
         Robot --> inv01 et inv02
         Coeur --> hea01 et hea02
@@ -121,13 +128,34 @@
         2 --> deux LED allumees
         3 --> trois LED allumees
 
+    Ces tableaux ne sont pas compiles dans le firmware : l'outil bigpack les range
+    dans motifsBIG_P.h, en memoire flash (PROGMEM) et sous une forme compacte
+    (bigmotif.h), comme le favicon bigicon, ce qui libere environ 3 Ko de RAM :
+        1-monochrome --> 2 bits par pixel, 22 octets
+        2-polychrome --> les 8 couleurs puis un octet par plage de pixels
+                         identiques (intensite, couleur, longueur de 1 a 8)
+        3-defilant   --> 2 octets par colonne
+        typo         --> 1 octet par colonne, largeurs et index calcules
+    Les pixels monochromes et polychromes sont ranges dans l'ordre de la bande de
+    LED, les fonctions d'affichage les ecrivent directement dans leds[]. Apres une
+    modification de motifsBIG.h : "bigpack -o motifsBIG_P.h" puis "bigpack -check"
+    qui verifie que les LED sont identiques a celles des tableaux de la v2.6.
+
+    Les sequences defilantes ne decalent pas la matrice mxFB1 : le texte est
+    converti une seule fois en colonnes a sa reception (txtCols, un octet par
+    colonne, un blanc avant chaque lettre), les motifs defilants sont deja
+    ranges par colonnes en flash. A chaque pas la fenetre de 11 colonnes
+    (bigmotif::Scroller) avance d'une colonne sur cet anneau, le travail ne
+    depend pas de la longueur du texte. Matrix et Fireworks, qui travaillent
+    sur mxFB1, y recopient la fenetre une seule fois a leur premier pas.
+
     Pour chaque type de motif on dispose d'une fonction d'affichage dédiee :
         1-monochrome --> DrawMono(motif, R, G, B)
         2-polychrome --> DrawMulti(motif)
         3-Defilant   --> DrawScroll(motif, R, G, B, N)
 
     Pour chaque sequence calculee ou texte on dispose d'une fonction :
-        Ligne        --> AnimateLine(on/off, ligne, tempo)
+        Ligne        --> AnimateLine(on/off, ligne, pixel)
         Texte        --> DrawText()
         Texte rev.   --> DrawtxeT()
         Matrix       --> DrawMatrix()
@@ -164,14 +192,36 @@
         10.1.1.1/R  --> ON/OFF du mode sequence aleatoire
         10.1.1.1/F  --> Couleur courante aleatoire
 
-    Le code de chaque sequence contient des pauses (delay(XXX)) qui donnent le
-    rythme de l'animation. Pour ne pas bloquer la fonction loop() trop longtemps,
-    les sequences affichent leurs motifs en plusieurs passes sequentielles gerees
-    avec la variable "stepMotif"
+    La geometrie de la matrice vient de bigmotif.h (BigLayout) : 8 lignes de 11
+    pixels de 3 LED, cablees en serpentin. Les motifs sont ranges ligne par
+    ligne, BigLayout::position() donne la place d'un pixel sur la bande.
+
+    Chaque sequence affiche ses motifs en plusieurs passes sequentielles gerees
+    avec la variable "stepMotif". Une passe ne fait pas de pause, elle donne dans
+    "stepWait" le delai en ms avant la passe suivante (le rythme de l'animation).
+    La fonction loop() ne bloque jamais : tant que l'echeance "stepDue" n'est pas
+    atteinte elle ne fait que surveiller les requetes HTTP. Les echeances suivent
+    le rythme sans deriver, apres un retard de plus d'une passe le rythme repart
+    de l'instant courant. Une requete qui change la sequence l'affiche aussitot.
+
+    La requete HTTP est lue par blocs dans un tampon fixe (httpreq.h), seule sa
+    premiere ligne est conservee. Quand la requete est complete, son chemin
+    choisit une entree de la table routes[] et la fonction de cette entree est
+    appelee. Une requete incomplete apres HTTP_TIMEOUT_MS est abandonnee.
+
+    Apres chaque requete HTTP, la liaison serie donne la latence la plus longue
+    observee depuis le demarrage, en microsecondes : attente (plus long ecart
+    entre deux surveillances HTTP) + traitement (lecture et reponse).
+
+    Le temps passe dans chaque etape est range dans un histogramme de cycles
+    (cyclestat.h) : requete HTTP, passe de sequence (FastLED.show() compris),
+    FastLED.show() seul et passes de loop() inactives (ni requete ni passe).
+    GET /stats les renvoie en JSON, la liaison serie les affiche toutes les
+    STATS_REPORT_MS si ce n'est pas 0. CYCLESTAT a 0 les retire du code.
 
 */
 
-#define bpVersion   ".v2-1....."
+#define bpVersion   ".v2-8....."
 
 #define INITSEQUENCE    11      // initialsequence  0=ligne, 11=version, 99=eteint
 #define INITRANDOM       1      // initial random, 0=no, 1=yes
@@ -179,11 +229,25 @@
 #include <ESP8266WiFi.h>
 //#include <WiFi.h>
 #include <FastLED.h>
-
+#include "bigmotif.h"
+#include "motifsBIG_P.h"
+#include "httpreq.h"
+#define CYCLESTAT 1             // 0 removes the stage histograms
+#include "cyclestat.h"
+
+typedef bigmotif::Layout BigLayout;     // 8 lines of 11 pixels, 3 LEDs each
+
+#define MX_WIDTH    BigLayout::WIDTH            // 11
+#define MX_HEIGHT   BigLayout::HEIGHT           // 8
+#define MX_PIXELS   BigLayout::PIXELS           // 88
+#define LED_PER_PIX BigLayout::LEDS_PER_PIXEL   // 3
 #define LED_PIN     4    // MiniD1 pin D2
-#define NUM_LEDS    264  // (8x11 matrix) x (3 led)
+#define NUM_LEDS    BigLayout::LEDS  // (8x11 matrix) x (3 led)
 #define MAXMSG      100
 #define MAXTYPO     40
+#define MAXCOLS     (MAXMSG*6)  // text columns, a blank + 5 at most per letter
+#define HTTP_TIMEOUT_MS 2000
+#define STATS_REPORT_MS 0       // stage histograms on serial, 0 = off
 
 /* --- BigPix access values --- */
 const char *ssid = "BigPix";
@@ -192,8 +256,9 @@ IPAddress gateway(10,1,1,0);
 IPAddress subnet(255,255,255,0);
 
 WiFiServer server(80);
+http::RequestParser request;   // current HTTP request
 
-char bigicon[252] = {
+const uint8_t bigicon[252] PROGMEM = {
  0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00,
  0x00, 0x00, 0x0D, 0x49, 0x48, 0x44, 0x52, 0x00, 0x00,
  0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x08, 0x02, 0x00,
@@ -223,503 +288,6 @@ char bigicon[252] = {
  0x2F, 0x23, 0x94, 0xB3, 0xFC, 0x7D, 0x00, 0x00, 0x00,
  0x00, 0x49, 0x45, 0x4E, 0x44, 0xAE, 0x42, 0x60, 0x82 };
 
-char inv01[88] = { 0,0,1,0,0,0,0,0,1,0,0,  // robot
-                   0,0,0,1,0,0,0,1,0,0,0,
-                   0,0,1,1,1,1,1,1,1,0,0,
-                   0,1,1,0,1,1,1,0,1,1,0,
-                   1,1,1,1,1,1,1,1,1,1,1,
-                   1,0,1,1,1,1,1,1,1,0,1,
-                   1,0,1,0,0,0,0,0,1,0,1,
-                   0,0,0,1,1,0,1,1,0,0,0 };
-
-char inv02[88] = { 0,0,1,0,0,0,0,0,1,0,0,
-                   1,0,0,1,0,0,0,1,0,0,1,
-                   1,0,1,1,1,1,1,1,1,0,1,
-                   1,1,1,0,1,1,1,0,1,1,1,
-                   1,1,1,1,1,1,1,1,1,1,1,
-                   0,1,1,1,1,1,1,1,1,1,0,
-                   0,0,0,1,0,0,0,1,0,0,0,
-                   0,0,1,0,0,0,0,0,1,0,0 };
-
-char sqi01[88] = { 0,0,0,0,1,1,1,0,0,0,0,   // Squid
-                   0,0,0,1,1,1,1,1,0,0,0,
-                   0,0,1,1,1,1,1,1,1,0,0,
-                   0,1,1,0,1,1,1,0,1,1,0,
-                   0,1,1,1,1,1,1,1,1,1,0,
-                   0,0,1,0,0,0,0,0,1,0,0,
-                   0,1,0,0,0,0,0,0,0,1,0,
-                   0,0,1,0,0,0,0,0,1,0,0 };
-
-char sqi02[88] = { 0,0,0,0,1,1,1,0,0,0,0,
-                   0,0,0,1,1,1,1,1,0,0,0,
-                   0,0,1,1,1,1,1,1,1,0,0,
-                   0,1,1,0,1,1,1,0,1,1,0,
-                   0,1,1,1,1,1,1,1,1,1,0,
-                   0,0,0,1,0,0,0,1,0,0,0,
-                   0,0,1,0,1,0,1,0,1,0,0,
-                   0,1,0,1,0,1,0,1,0,1,0 };
-
-char hea01[88] = { 0,0,0,1,1,0,1,1,0,0,0,   // Heart beat
-                   0,0,1,1,1,1,1,1,1,0,0,
-                   0,1,1,1,1,1,1,1,1,1,0,
-                   0,1,1,1,1,1,1,1,1,1,0,
-                   0,0,1,1,1,1,1,1,1,0,0,
-                   0,0,0,1,1,1,1,1,0,0,0,
-                   0,0,0,0,1,1,1,0,0,0,0,
-                   0,0,0,0,0,1,0,0,0,0,0 };
-
-char hea02[88] = { 0,0,0,0,0,0,0,0,0,0,0,
-                   0,0,0,1,1,0,1,1,0,0,0,
-                   0,0,1,2,2,1,2,2,1,0,0,
-                   0,0,1,2,3,3,3,2,1,0,0,
-                   0,0,0,1,2,3,2,1,0,0,0,
-                   0,0,0,0,1,2,1,0,0,0,0,
-                   0,0,0,0,0,1,0,0,0,0,0,
-                   0,0,0,0,0,0,0,0,0,0,0 };
-
-
-char typIdx[MAXTYPO];
-
-char typWdt[MAXTYPO] = {
-  1,3,2,3,2,3,3,3,3,3,3,3,3,3,3,3,3,3,3,4,3,1,3,4,3,5,4,3,3,3,3,3,3,3,3,5,3,3,3,2 };
-//! + - 0 1 2 3 4 5 6 7 8 9 A B C D E F G H I J K L M N O P Q R S T U V W X Y Z SP
-
-char typo[600] = {
-  1,      // !
-  1,
-  1,
-  0,
-  1,
-
-  0,0,0,  // +
-  0,1,0,
-  1,1,1,
-  0,1,0,
-  0,0,0,
-  
-  0,0,    // -
-  0,0,
-  1,1,
-  0,0,
-  0,0,
-  
-  0,1,0,  // 0
-  1,0,1,
-  1,0,1,
-  1,0,1,
-  0,1,0,
-  
-  0,1,    // 1
-  1,1,
-  0,1,
-  0,1,
-  0,1,
-  
-  1,1,0,  // 2
-  0,0,1,
-  0,1,0,
-  1,0,0,
-  1,1,1,
-
-  1,1,0,  // 3
-  0,0,1,
-  0,1,0,
-  0,0,1,
-  1,1,1,
-
-  0,0,1,  // 4
-  0,1,0,
-  1,0,1,
-  1,1,1,
-  0,0,1,
-  
-  1,1,1,  // 5
-  1,0,0,
-  1,1,0,
-  0,0,1,
-  1,1,1,
-
-  0,1,1,  // 6
-  1,0,0,
-  1,1,1,
-  1,0,1,
-  1,1,1,
-  
-  1,1,1,  // 7
-  0,0,1,
-  0,1,0,
-  1,0,0,
-  1,0,0,
-  
-  1,1,1,  // 8
-  1,0,1,
-  0,1,0,
-  1,0,1,
-  1,1,1,
-  
-  1,1,1,  // 9
-  1,0,1,
-  0,1,1,
-  0,0,1,
-  1,1,1,
-  
-  0,1,0,  // A
-  1,0,1,
-  1,1,1,
-  1,0,1,
-  1,0,1,
-
-  1,1,1,  // B
-  1,0,1,
-  1,1,1,
-  1,0,1,
-  1,1,1,
-  
-  1,1,1,  // C
-  1,0,0,
-  1,0,0,
-  1,0,0,
-  1,1,1,
-
-  1,1,0,  // D
-  1,0,1,
-  1,0,1,
-  1,0,1,
-  1,1,1,
-
-  1,1,1,  // E
-  1,0,0,
-  1,1,0,
-  1,0,0,
-  1,1,1,
-  
-  1,1,1,  // F
-  1,0,0,
-  1,1,0,
-  1,0,0,
-  1,0,0,
-
-  1,1,1,1,  // G
-  1,0,0,0,
-  1,0,1,1,
-  1,0,0,1,
-  1,1,1,1,
-  
-  1,0,1,  // H
-  1,0,1,
-  1,1,1,
-  1,0,1,
-  1,0,1,
-  
-  1,      // I
-  1,
-  1,
-  1,
-  1,
-
-  0,0,1,  // J
-  0,0,1,
-  0,0,1,
-  1,0,1,
-  0,1,1,
-  
-  1,0,0,1, //K
-  1,0,1,0,
-  1,1,0,0,
-  1,0,1,0,
-  1,0,0,1,
-
-  1,0,0,  // L
-  1,0,0,
-  1,0,0,
-  1,0,0,
-  1,1,1,
-
-  1,0,0,0,1, // M
-  1,1,0,1,1,
-  1,0,1,0,1,
-  1,0,0,0,1,
-  1,0,0,0,1,
-  
-  1,0,0,1,  // N
-  1,1,0,1,
-  1,0,1,1,
-  1,0,0,1,
-  1,0,0,1,
-
-  1,1,1,  // O
-  1,0,1,
-  1,0,1,
-  1,0,1,
-  1,1,1,
-
-  1,1,1,  // P
-  1,0,1,
-  1,1,1,
-  1,0,0,
-  1,0,0,
-  
-  1,1,1,  // Q
-  1,0,1,
-  1,0,1,
-  1,1,1,
-  1,1,1,
-  
-  1,1,1,  // R
-  1,0,1,
-  1,1,1,
-  1,1,0,
-  1,0,1,
-  
-  1,1,1,  // S
-  1,0,0,
-  1,1,1,
-  0,0,1,
-  1,1,1,
-  
-  1,1,1,  // T
-  0,1,0,
-  0,1,0,
-  0,1,0,
-  0,1,0,
-  
-  1,0,1,  // U
-  1,0,1,
-  1,0,1,
-  1,0,1,
-  1,1,1,
-  
-  1,0,1,  // V
-  1,0,1,
-  1,0,1,
-  1,0,1,
-  0,1,0,
-  
-  1,0,0,0,1,  // W
-  1,0,0,0,1,
-  1,0,1,0,1,
-  1,1,0,1,1,
-  1,0,0,0,1,
-  
-  1,0,1,  // X
-  1,0,1,
-  0,1,0,
-  1,0,1,
-  1,0,1,
-
-  1,0,1,  // Y
-  1,0,1,
-  0,1,0,
-  0,1,0,
-  0,1,0,
-  
-  1,1,1,  // Z
-  0,0,1,
-  0,1,0,
-  1,0,0,
-  1,1,1,
-
-  0,0,    // space  MAXTYPO-1
-  0,0,
-  0,0,
-  0,0,
-  0,0 };
-  
-/*
-                   1 2 3 4 5 6 7 8 910 1 2 3 4 5 6 7 8 920 1 2 3 4 5 6 7 8 930 1 2 3
-                   ---------------------+++++++++++++++++++++++xxxxxxxxxxxxxxxxxxxxx
-*/
-char apero[264]= { 0,0,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,
-                   0,1,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,1,0,
-                   0,1,1,1,1,1,1,1,0,0,0,1,0,0,1,1,1,0,1,1,0,1,1,1,0,1,1,1,0,1,0,1,0,
-                   0,0,1,1,1,1,1,0,0,0,1,0,1,0,1,0,1,0,1,0,0,1,0,1,0,1,0,1,0,1,0,1,0,
-                   0,0,0,1,1,1,0,0,0,0,1,1,1,0,1,1,1,0,1,1,0,1,1,1,0,1,0,1,0,1,0,1,0,
-                   0,0,0,0,1,0,0,0,0,0,1,0,1,0,1,0,0,0,1,0,0,1,1,0,0,1,0,1,0,1,0,1,0,
-                   0,0,0,0,1,0,0,0,0,0,1,0,1,0,1,0,0,0,1,0,0,1,0,1,0,1,0,1,0,0,0,0,0,
-                   0,0,1,1,1,1,1,0,0,0,1,0,1,0,1,0,0,0,1,1,0,1,0,1,0,1,1,1,0,1,0,1,0
-                   };
-
-char ie22[264]= {  0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0, // BigPix
-                   0,0,0,0,0,0,0,1,0,0,1,0,1,0,1,0,0,0,0,0,0,1,0,1,0,1,0,0,0,0,0,0,0,
-                   0,0,0,0,0,0,1,1,1,0,1,1,0,0,0,0,0,0,0,0,0,1,0,1,0,0,0,0,0,0,0,0,0,
-                   0,0,0,0,0,0,0,1,0,0,1,0,1,0,1,0,1,1,1,0,0,1,1,0,0,1,0,1,0,1,0,0,0,
-                   0,0,0,0,0,0,0,0,0,0,1,0,1,0,1,0,1,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,0,
-                   0,0,0,1,0,0,0,0,0,0,1,1,1,0,1,0,1,1,1,0,0,1,0,0,0,1,0,1,0,1,0,0,0,
-                   0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-                   0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0
-                   };
-
-char eye01[112] = {   0,  0,  0,   // col0   black
-                    130,130,130,   // col1   light grey
-                     10, 10,130,   // col2   light blue
-                     60, 60,130,   // col3   blue
-                     70, 70, 70,   // col4   grey
-                      0,  0,  0,   // col5
-                      0,  0,  0,   // col6
-                      0,  0,  0,   // col7
-                    0,0,1,1,0,0,0,0,1,1,0,
-                    0,1,1,1,1,0,0,1,1,1,1,
-                    1,1,1,1,1,0,1,1,1,1,1,
-                    3,2,3,1,1,0,3,2,3,1,1,
-                    2,4,2,1,1,0,2,4,2,1,1,
-                    2,2,2,1,1,0,2,2,2,1,1,
-                    0,2,3,1,1,0,0,2,3,1,1,
-                    0,0,1,1,0,0,0,0,1,1,0 };
-
-char eye02[112] = {   0,  0,  0,   // col0   black
-                    130,130,130,   // col1   light grey
-                     10, 10,130,   // col2   light blue
-                     60, 60,130,   // col3   blue
-                     70, 70, 70,   // col4   grey
-                      0,  0,  0,   // col5
-                      0,  0,  0,   // col6
-                      0,  0,  0,   // col7
-                    0,0,1,1,0,0,0,0,1,1,0,
-                    0,1,1,1,1,0,0,1,1,1,1,
-                    1,1,1,1,1,0,1,1,1,1,1,
-                    1,1,3,2,3,0,1,1,3,2,3,
-                    1,1,2,4,2,0,1,1,2,4,2,
-                    1,1,2,2,2,0,1,1,2,2,2,
-                    0,1,3,2,3,0,0,1,3,2,3,
-                    0,0,1,1,0,0,0,0,1,1,0 };
-
-char gho01[112] = {   0,  0,  0,   // col0   black
-                    130,130,130,   // col1   light grey
-                    130, 10,130,   // col2   magenta
-                      0,  0,200,   // col3   blue
-                     80, 10, 80,   // col4   light magenta
-                      0,  0,  0,   // col5
-                      0,  0,  0,   // col6
-                      0,  0,  0,   // col7
-                    0,0,0,0,2,2,0,0,0,0,0,
-                    0,0,2,2,2,2,2,2,0,0,0,
-                    0,2,1,3,2,2,1,3,2,0,0,
-                    2,2,1,1,2,2,1,1,2,2,0,
-                    2,2,2,2,2,2,2,2,2,2,0,
-                    2,2,2,2,2,2,2,2,2,2,0,
-                    2,2,2,2,2,2,2,2,2,2,0,
-                    0,2,2,0,0,2,2,0,0,2,0 };
-
-char gho02[112] = {   0,  0,  0,   // col0   black
-                    130,130,130,   // col1   light grey
-                    130, 10,130,   // col2   magenta
-                      0,  0,200,   // col3   blue
-                     80, 10, 80,   // col4   light magenta
-                      0,  0,  0,   // col5
-                      0,  0,  0,   // col6
-                      0,  0,  0,   // col7
-                    0,0,0,0,0,2,2,0,0,0,0,
-                    0,0,0,2,2,2,2,2,2,0,0,
-                    0,0,2,3,1,2,2,3,1,2,0,
-                    0,2,2,1,1,2,2,1,1,2,2,
-                    0,2,2,2,2,2,2,2,2,2,2,
-                    0,2,2,2,2,2,2,2,2,2,2,
-                    0,2,2,2,2,2,2,2,2,2,2,
-                    0,2,0,0,2,2,0,0,2,2,0 };
-
-char sq01[112] = {   0,  0,  0,   // col0   black
-                    215, 10, 90,   // col1   red
-                    132, 10,215,   // col2   maj
-                     10, 90,215,   // col3   blue
-                     10,215,132,   // col4   cyan
-                     90,215, 10,   // col5   green
-                    215,132, 10,   // col6   Yell
-                    90,  90, 90,   // col7   White
-                    11,12,13,14,15,16,11,12,13,14,15,
-                    11,12,13,14,15,16,11,12,13,14,15,
-                    11,12,13,14,15,16,11,12,13,14,15,
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    0,0,0,0,0,0,0,0,0,0,0 };
-
-char sq02[112] = {   0,  0,  0,   // col0   black
-                    215, 10, 90,   // col1   red
-                    132, 10,215,   // col2   maj
-                     10, 90,215,   // col3   blue
-                     10,215,132,   // col4   cyan
-                     90,215, 10,   // col5   green
-                    215,132, 10,   // col6   Yell
-                    90,  90, 90,   // col7   White
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    16,11,12,13,14,15,16,11,12,13,14,
-                    16,11,12,13,14,15,16,11,12,13,14,
-                    16,11,12,13,14,15,16,11,12,13,14,
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    0,0,0,0,0,0,0,0,0,0,0 };
-
-char sq03[112] = {   0,  0,  0,   // col0   black
-                    215, 10, 90,   // col1   red
-                    132, 10,215,   // col2   maj
-                     10, 90,215,   // col3   blue
-                     10,215,132,   // col4   cyan
-                     90,215, 10,   // col5   green
-                    215,132, 10,   // col6   Yell
-                    90,  90, 90,   // col7   White
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    15,16,11,12,13,14,15,16,11,12,13,
-                    15,16,11,12,13,14,15,16,11,12,13,
-                    15,16,11,12,13,14,15,16,11,12,13,
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    0,0,0,0,0,0,0,0,0,0,0 };
-
-char sq04[112] = {   0,  0,  0,   // col0   black
-                    215, 10, 90,   // col1   red
-                    132, 10,215,   // col2   maj
-                     10, 90,215,   // col3   blue
-                     10,215,132,   // col4   cyan
-                     90,215, 10,   // col5   green
-                    215,132, 10,   // col6   Yell
-                    90,  90, 90,   // col7   White
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    14,15,16,11,12,13,14,15,16,11,12,
-                    14,15,16,11,12,13,14,15,16,11,12,
-                    14,15,16,11,12,13,14,15,16,11,12,
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    0,0,0,0,0,0,0,0,0,0,0 };
-
-char sq05[112] = {   0,  0,  0,   // col0   black
-                    215, 10, 90,   // col1   red
-                    132, 10,215,   // col2   maj
-                     10, 90,215,   // col3   blue
-                     10,215,132,   // col4   cyan
-                     90,215, 10,   // col5   green
-                    215,132, 10,   // col6   Yell
-                    90,  90, 90,   // col7   White
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    13,14,15,16,11,12,13,14,15,16,11,
-                    13,14,15,16,11,12,13,14,15,16,11,
-                    13,14,15,16,11,12,13,14,15,16,11,
-                    0,0,0,0,0,0,0,0,0,0,0 };
-                    
-char sq06[112] = {   0,  0,  0,   // col0   black
-                    215, 10, 90,   // col1   red
-                    132, 10,215,   // col2   maj
-                     10, 90,215,   // col3   blue
-                     10,215,132,   // col4   cyan
-                     90,215, 10,   // col5   green
-                    215,132, 10,   // col6   Yell
-                    90,  90, 90,   // col7   White
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    0,0,0,0,0,0,0,0,0,0,0,
-                    12,13,14,15,16,11,12,13,14,15,16,
-                    12,13,14,15,16,11,12,13,14,15,16,
-                    12,13,14,15,16,11,12,13,14,15,16 };
-                    
-                
 char mxFB1[88] = { 1,1,1,1,1,1,1,1,1,1,1,      // Matrix Frame Buffer flip
                    0,0,0,0,0,0,0,0,0,0,0,
                    0,0,0,0,0,0,0,0,0,0,0,
@@ -743,6 +311,10 @@ char fiG[11] = { 0,0,0,0,0,0,0,0,0,0,0 };
 char fiB[11] = { 0,0,0,0,0,0,0,0,0,0,0 };
 
 char msg[MAXMSG] = bpVersion;                // text buffer
+uint8_t txtCols[MAXCOLS];                    // msg rasterized, bit i = line 2+i
+int txtLen = 0;                              // columns in txtCols
+int txtPos = 0;                              // next column to scroll in
+bigmotif::Scroller scroller;                 // view of the scrolling sequences
 
 CRGB leds[NUM_LEDS];    // LED array
 int favicon = 0;        // GET /favicon.ico
@@ -751,12 +323,17 @@ int randomSeq = 0;      // random mode ON/OFF
 int startSeq;           // sequence start time
 int scrollH = 0;        // horizontal scroll step
 int cR, cG, cB;         // current color for mono & text
-int  getMsg = 0;        // flag msg in request
-int  msgIdx = 0;        // current msg character number
-int  typoIndex = 0;     // current msg Typo index
-int  typoCol = 0;       // current Typo column
-int  doSpace = 0;       // inter-character
 int stepMotif = 1;      // Animation step
+unsigned long stepDue = 0;     // deadline of the next step, ms
+unsigned long lastPoll = 0;    // last HTTP poll, us
+unsigned long maxPollGap = 0;  // longest time between two HTTP polls, us
+unsigned long maxServe = 0;    // longest HTTP request service, us
+
+enum Stat { STAT_HTTP, STAT_STEP, STAT_SHOW, STAT_IDLE, NB_STATS };
+const char* const statNames[NB_STATS] = { "http", "step", "show", "idle" };
+cyclestat::Histogram stats[NB_STATS];  // /stats
+unsigned long statsReport = 0;         // last serial print
+int statsRequest = 0;                  // GET /stats
 
 /*
     Initialize Access Point, font, colors, Web server, animation
@@ -767,13 +344,9 @@ void setup()
 
   FastLED.addLeds<WS2812, LED_PIN, GRB>(leds, NUM_LEDS);
   
-  typIdx[0] = 0;
-  for (int i = 1; i < MAXTYPO; i++)       // initialise typo indexes
-  {
-    typIdx[i] = typIdx[i-1] + typWdt[i-1];
-  }
   Serial.begin(115200);
   Serial.println();
+  RasterMsg();                            // version text
 
   Serial.print("Setting soft-AP configuration ... ");
   Serial.println(WiFi.softAPConfig(local_IP, gateway, subnet) ? "Ready" : "Failed!");
@@ -790,226 +363,268 @@ void setup()
   startSeq = millis();                    // line for 7 seconds
 }
 
+/*
+    HTTP request not complete yet, let the WiFi stack run
+*/
+void HttpWait()
+{
+  delay(1);
+}
+
+/*
+    HTTP routes, the request path selects the sequence
+*/
+void RouteFavicon(const char* arg)
+{ favicon = 1; }
+
+void RouteLine(const char* arg)
+{ sequence = 0; randomSeq = 0; }
+
+void RouteRobot(const char* arg)
+{ sequence = 1; randomSeq = 0; }
+
+void RouteBeat(const char* arg)
+{ sequence = 2; randomSeq = 0; }
+
+void RouteBigPix(const char* arg)
+{
+  sequence = 3;
+  scrollH = 0;
+  randomSeq = 0;
+  clearFB();
+}
+
+void RouteGhost(const char* arg)
+{ sequence = 4; randomSeq = 0; }
+
+void RouteSquid(const char* arg)
+{ sequence = 5; randomSeq = 0; }
+
+void RouteEyes(const char* arg)
+{ sequence = 6; randomSeq = 0; }
+
+void RouteMatrix(const char* arg)
+{ sequence = 7; randomSeq = 0; }
+
+void RouteFireworks(const char* arg)
+{
+  sequence = 8;
+  startSeq = millis();
+  randomSeq = 0;
+}
+
+void RouteSquare(const char* arg)
+{ sequence = 9; randomSeq = 0; }
+
+void RouteApero(const char* arg)
+{
+  sequence = 10;
+  scrollH = 0;
+  randomSeq = 0;
+  clearFB();
+}
+
+void RouteText(const char* arg)             // text follows /T
+{
+  sequence = 11;
+  randomSeq = 0;
+  clearFB();
+  SetMsg(arg);
+}
+
+void RoutetxeT(const char* arg)             // text follows /t
+{
+  sequence = 12;
+  randomSeq = 0;
+  clearFB();
+  SetMsg(arg);
+}
+
+void RouteCMY(const char* arg)              // CMY not a sequence
+{
+  if (cR == 0) // cyan
+  { cR = 200; cG =   0; cB = 200; }  // goto Magenta
+  else if (cG == 0) // Magenta
+  { cR = 200; cG = 200; cB =   0; }  // goto Yello
+  else if (cB == 0) // Yellow
+  { cR =   0; cG = 200; cB = 200; }  // goto Cyan
+  else
+  { cR =   0; cG = 200; cB = 200; }  // start with Cyan
+}
+
+void RouteRandom(const char* arg)           // random sequence ON/OFF
+{
+  if (randomSeq == 0)               // clicked goRandom
+  {
+    randomSeq = 1;
+    startSeq = millis();
+    sequence = random(0,11);
+  }
+  else                              // clicked goChoose
+  { 
+    randomSeq = 0;
+    sequence = 99;
+  }
+}
+
+void RouteColor(const char* arg)            // randomColor not a sequence
+{ RandomColor(); }
+
+void RouteStats(const char* arg)            // stage histograms not a sequence
+{ statsRequest = 1; }
+
+const http::Route routes[] = {
+  { "/favicon.ico", true,  RouteFavicon },
+  { "/Z",           false, RouteLine },
+  { "/I",           false, RouteRobot },
+  { "/B",           false, RouteBeat },
+  { "/Bp",          false, RouteBigPix },
+  { "/G",           false, RouteGhost },
+  { "/M",           false, RouteSquid },
+  { "/E",           false, RouteEyes },
+  { "/Mx",          false, RouteMatrix },
+  { "/Wa",          false, RouteFireworks },
+  { "/S",           false, RouteSquare },
+  { "/A",           false, RouteApero },
+  { "/T",           true,  RouteText },
+  { "/t",           true,  RoutetxeT },
+  { "/X",           false, RouteCMY },
+  { "/R",           false, RouteRandom },
+  { "/F",           false, RouteColor },
+  { "/stats",       false, RouteStats },
+};
+const int NB_ROUTES = sizeof(routes)/sizeof(routes[0]);
+
 /*
     General Automaton
 */
 void loop()
 {
 int requestDone = 0;
+int stepWait;                             // ms until the next step
+unsigned long pollTime = micros();
+uint32_t passStart = cyclestat::now();
+uint32_t stepStart;
+bool served = false;                      // HTTP request this time
 WiFiClient client = server.available();   // listen for incoming clients
 
+  if (lastPoll != 0 && pollTime - lastPoll > maxPollGap)
+    maxPollGap = pollTime - lastPoll;     // a request may wait that long
+  lastPoll = pollTime;
+
   if (client.available())                 // if you get a client,
   {
-    String currentLine = "";              // make a String to hold incoming data from the client
-    while (client.connected())            // loop while the client is connected
+    cyclestat::Scope stat(stats[STAT_HTTP]);
+    if (http::readRequest(client, request, millis, HTTP_TIMEOUT_MS, HttpWait))
     {
-      if (client.available())             // if there's bytes to read from the client,
+      requestDone = http::dispatch(routes, NB_ROUTES, request.path()) >= 0 && statsRequest == 0;
+      if (statsRequest == 1)        // stage histograms, JSON
       {
-        char c = client.read();           // read bytes one-by-one, then
-        if (c == '\n')                    // if the byte is a newline character
-        {                                 // got two newline characters in a row.
-          if (currentLine.length() == 0)  // end of HTTP request, so send a response
-          {
-            if (favicon == 1)             // favicon request
-            {
-              favicon = 0;
-              client.print("HTTP/1.1 200 OK\r\n");
-              client.print("Content-type:image/png\r\n");
-              client.print("\r\n");
-              for (int i=0; i< 252; i++)
-                client.write(bigicon[i]);
-            }
-            else                          // command request
-            {
-              client.print("HTTP/1.1 200 OK\r\n");
-              client.print("Content-type:text/html\r\n");
-              client.print("\r\n");
-
-              // the content of the HTTP response follows the header:
-              client.print("<head><style>\r\n");
-              client.print("body {background-color:black;text-decoration:none;}\r\n");
-              client.print("h1 {font-size:120px;font-family:Verdana;}\r\n");
-              client.print("h2 {font-size:80px;color:white;font-family:Lucida Console;}\r\n");
-              client.print("h3 {font-size:80px;color:black;font-family:Lucida Console;}\r\n");
-              client.print("</style></head>\r\n");
-
-              client.print("<html><body>\r\n");
-              client.print("<table border=\"20\" width=\"100%\" height=\"20%\">\r\n");
-              client.print("<tr><td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:#FD4600\" href=\"/B\"><h1>BEAT</a>\r\n");
-              client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:#39E721\" href=\"/Wa\"><h2>Firework</a></tr></table>\r\n");
-
-              client.print("<table border=\"20\" width=\"100%\" height=\"20%\" >\r\n");
-              client.print("<tr><td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/I\"><h2>Robot</a>\r\n");
-              client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/M\"><h2>Squid</a></tr></table>\r\n");
-
-              client.print("<table border=\"20\" width=\"100%\" height=\"20%\" >\r\n");
-              client.print("<tr><td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/G\"><h2>Ghost</a>\r\n");
-              client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/E\"><h2>Eyes</a></tr></table>\r\n");
-
-              client.print("<table border=\"20\" width=\"100%\" height=\"20%\" >\r\n");
-              client.print("<tr><td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/Mx\"><h2>Matrix</a>\r\n");
-              client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/Bp\"><h2>BigPix</a></tr></table>\r\n");
-
-              client.print("<table border=\"20\" width=\"100%\" height=\"20%\" style=\"background-color:#7AECDF\">\r\n");
-              client.print("<tr><td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:#9A1CD1\" href=\"/X\"><h3>C-M-Y</a>\r\n");
-              if (randomSeq == 0)
-                client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:#138B1C\" href=\"/R\"><h3>ON</a></tr></table>\r\n");
-              else
-                client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:#B3162E\" href=\"/R\"><h3>OFF</a></tr></table>\r\n");
-
-              client.print("</body></html>\r\n");
-              client.print("\r\n");           // The HTTP response ends with another blank line
-            }
-            break;                            // break out of loop while (client.connected())
-          }
-          else                                // if newline, then clear currentLine
-          {
-            currentLine = "";
-          }
-        }   //// END   if (c == '\n')
-        else if (c != '\r')                   // anything but carriage return character,
-        {
-          currentLine += c;                   // add it to the end of the currentLine
-          if (getMsg == 1)
-          {
-            if (msgIdx < (MAXMSG-1) && c != ' ')
-              msg[msgIdx++] = c;              // collect text message - stop at space
-            else
-            {
-              msg[msgIdx] = '\0';             // zero string
-              getMsg = 0;
-              msgIdx = 0;
-              initTypo();                     // ready
-              Serial.print("MSG = ");
-              Serial.println(msg);
-            }
-          }
-        }
-
-        // Check the client request
-        if (requestDone == 0)                         // not found request yet
-        {
-          if (currentLine.endsWith("GET /favicon.ico"))   // favicon
-          { favicon = 1; requestDone = 1; }
-          else if (currentLine.endsWith("GET /Z "))   // line
-          { sequence = 0; requestDone = 1; randomSeq = 0; }
-          else if (currentLine.endsWith("GET /I "))   // robot
-          { sequence = 1; requestDone = 1; randomSeq = 0; }
-          else if (currentLine.endsWith("GET /B "))   // beat
-          { sequence = 2; requestDone = 1; randomSeq = 0; }
-          else if (currentLine.endsWith("GET /Bp "))  // BigPix
-          {
-            sequence = 3;
-            scrollH = 0;
-            requestDone = 1; 
-            randomSeq = 0;
-            clearFB();
-          }
-          else if (currentLine.endsWith("GET /G "))   // ghost
-          { sequence = 4; requestDone = 1; randomSeq = 0; }
-          else if (currentLine.endsWith("GET /M "))   // squid
-          { sequence = 5; requestDone = 1; randomSeq = 0; }
-          else if (currentLine.endsWith("GET /E "))   // eyes
-          { sequence = 6; requestDone = 1; randomSeq = 0; }
-          else if (currentLine.endsWith("GET /Mx "))  // Matrix
-          { sequence = 7; requestDone = 1; randomSeq = 0; }
-          else if (currentLine.endsWith("GET /Wa "))  // Fireworks
-          {
-            sequence = 8;
-            startSeq = millis();
-            requestDone = 1;
-            randomSeq = 0;
-          }
-          else if (currentLine.endsWith("GET /S "))   // Square
-          { sequence = 9; requestDone = 1; randomSeq = 0;}
-          else if (currentLine.endsWith("GET /A "))   // apero
-          {
-            sequence = 10;
-            scrollH = 0;
-            requestDone = 1;
-            randomSeq = 0;
-            clearFB();
-          }
-          else if (currentLine.endsWith("GET /T"))    // text
-          { 
-            sequence = 11;
-            getMsg = 1;
-            msgIdx = 0;
-            requestDone = 1;
-            randomSeq = 0;
-            clearFB();
-          }
-          else if (currentLine.endsWith("GET /t"))    // text reversed
-          { 
-            sequence = 12;
-            getMsg = 1;
-            msgIdx = 0;
-            requestDone = 1;
-            randomSeq = 0;
-            clearFB();
-          }
-          else if (currentLine.endsWith("GET /X "))   // CMY not a sequence
-          {
-            if (cR == 0) // cyan
-            { cR = 200; cG =   0; cB = 200; }  // goto Magenta
-            else if (cG == 0) // Magenta
-            { cR = 200; cG = 200; cB =   0; }  // goto Yello
-            else if (cB == 0) // Yellow
-            { cR =   0; cG = 200; cB = 200; }  // goto Cyan
-            else
-            { cR =   0; cG = 200; cB = 200; }  // start with Cyan
-            requestDone = 1;
-          }
-          else if (currentLine.endsWith("GET /R "))  // random sequence ON/OFF
-          {
-            if (randomSeq == 0)               // clicked goRandom
-            {
-              randomSeq = 1;
-              startSeq = millis();
-              sequence = random(0,11);
-            }
-            else                              // clicked goChoose
-            { 
-              randomSeq = 0;
-              
-              sequence = 99;
-            }
-            requestDone = 1;
-          }
-          else if (currentLine.endsWith("GET /F "))  // randomColor not a sequence
-          { RandomColor(); requestDone = 1; }
-        }
-      }  //// END if (client.available())
-    }  //// END while (client.connected())
-
+        statsRequest = 0;
+        client.print("HTTP/1.1 200 OK\r\n");
+        client.print("Content-type:application/json\r\n");
+        client.print("\r\n");
+        cyclestat::writeJson(client, stats, statNames, NB_STATS, millis());
+      }
+      else if (favicon == 1)        // favicon request
+      {
+        favicon = 0;
+        client.print("HTTP/1.1 200 OK\r\n");
+        client.print("Content-type:image/png\r\n");
+        client.print("\r\n");
+        for (int i=0; i< 252; i++)
+          client.write(pgm_read_byte(&bigicon[i]));
+      }
+      else                          // command request
+      {
+        client.print("HTTP/1.1 200 OK\r\n");
+        client.print("Content-type:text/html\r\n");
+        client.print("\r\n");
+
+        // the content of the HTTP response follows the header:
+        client.print("<head><style>\r\n");
+        client.print("body {background-color:black;text-decoration:none;}\r\n");
+        client.print("h1 {font-size:120px;font-family:Verdana;}\r\n");
+        client.print("h2 {font-size:80px;color:white;font-family:Lucida Console;}\r\n");
+        client.print("h3 {font-size:80px;color:black;font-family:Lucida Console;}\r\n");
+        client.print("</style></head>\r\n");
+
+        client.print("<html><body>\r\n");
+        client.print("<table border=\"20\" width=\"100%\" height=\"20%\">\r\n");
+        client.print("<tr><td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:#FD4600\" href=\"/B\"><h1>BEAT</a>\r\n");
+        client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:#39E721\" href=\"/Wa\"><h2>Firework</a></tr></table>\r\n");
+
+        client.print("<table border=\"20\" width=\"100%\" height=\"20%\" >\r\n");
+        client.print("<tr><td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/I\"><h2>Robot</a>\r\n");
+        client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/M\"><h2>Squid</a></tr></table>\r\n");
+
+        client.print("<table border=\"20\" width=\"100%\" height=\"20%\" >\r\n");
+        client.print("<tr><td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/G\"><h2>Ghost</a>\r\n");
+        client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/E\"><h2>Eyes</a></tr></table>\r\n");
+
+        client.print("<table border=\"20\" width=\"100%\" height=\"20%\" >\r\n");
+        client.print("<tr><td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/Mx\"><h2>Matrix</a>\r\n");
+        client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/Bp\"><h2>BigPix</a></tr></table>\r\n");
+
+        client.print("<table border=\"20\" width=\"100%\" height=\"20%\" style=\"background-color:#7AECDF\">\r\n");
+        client.print("<tr><td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:#9A1CD1\" href=\"/X\"><h3>C-M-Y</a>\r\n");
+        if (randomSeq == 0)
+          client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:#138B1C\" href=\"/R\"><h3>ON</a></tr></table>\r\n");
+        else
+          client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:#B3162E\" href=\"/R\"><h3>OFF</a></tr></table>\r\n");
+
+        client.print("</body></html>\r\n");
+        client.print("\r\n");           // The HTTP response ends with another blank line
+      }
+    }
     client.stop();                               // close the connection
+    if (micros() - pollTime > maxServe)
+      maxServe = micros() - pollTime;
+    if (requestDone == 1)
+      stepDue = millis();                        // show the new sequence now
     Serial.print("sequence : ");
     Serial.println(sequence);
+    Serial.print("HTTP latency max us : ");
+    Serial.print(maxPollGap);
+    Serial.print(" + ");
+    Serial.println(maxServe);
+    served = true;
   } //// END if (client.available())
   /// END OF HTTP REQUEST  ////////////////////////////////////////
 
+  if (STATS_REPORT_MS > 0 && millis() - statsReport > STATS_REPORT_MS)
+  {
+    statsReport = millis();
+    cyclestat::writeText(Serial, stats, statNames, NB_STATS);
+  }
+
   if (randomSeq == 1)                           // start a random sequence
   {
     if ( (millis() - startSeq) > 8000 )         // 8 sec sequences
     {
       sequence = random(1,10);                  // last = squares
       startSeq = millis();
+      stepDue = startSeq;
     }
   }
 
+  if ((long)(millis() - stepDue) < 0)           // next step not due yet
+  {
+    if (!served)
+      stats[STAT_IDLE].add(cyclestat::now() - passStart);
+    return;
+  }
+
+  stepStart = cyclestat::now();
   switch (sequence)
   {
-  case 0:                           // line
-    switch(stepMotif)
-    {
-      case 1:
-        AnimateLine(true, 0, 50);
-        break;
-      case 2:
-        AnimateLine(false, 0, 50);
-        break;
-    }
-    if (++stepMotif > 2)
+  case 0:                           // line, one pixel per step
+    if (stepMotif <= 11)
+      AnimateLine(true, 0, stepMotif - 1);
+    else
+      AnimateLine(false, 0, stepMotif - 12);
+    stepWait = 50;
+    if (++stepMotif > 22)
       stepMotif = 1;
     break;
     
@@ -1018,12 +633,12 @@ WiFiClient client = server.available();   // listen for incoming clients
     {
       case 1:
         DrawMono(inv01, cR, cG, cB); // robot base color
-        delay(400);
+        stepWait = 400;
         break;
       case 2:
       default:
         DrawMono(inv02, cR, cG, cB);
-        delay(400);
+        stepWait = 400;
         break;
     }
     if (++stepMotif > 2)
@@ -1035,12 +650,12 @@ WiFiClient client = server.available();   // listen for incoming clients
     {
       case 1:
         DrawMono(hea01, 130, 0, 0);  // red beat
-        delay(800);
+        stepWait = 800;
         break;
       case 2:
       default:
         DrawMono(hea02, 130, 0, 0);
-        delay(200);
+        stepWait = 200;
         break;
     }
     if (++stepMotif > 2)
@@ -1049,7 +664,7 @@ WiFiClient client = server.available();   // listen for incoming clients
 
   case 3:
     DrawScroll(ie22, cR, cG, cB, 33);   // BigPix
-    delay(100);
+    stepWait = 100;
     break;
 
   case 4:
@@ -1057,12 +672,12 @@ WiFiClient client = server.available();   // listen for incoming clients
     {
       case 1:
         DrawMulti(gho01);            // Ghost
-        delay(400);
+        stepWait = 400;
         break;
       case 2:
       default:
         DrawMulti(gho02);
-        delay(400);
+        stepWait = 400;
         break;
     }
     if (++stepMotif > 2)
@@ -1074,12 +689,12 @@ WiFiClient client = server.available();   // listen for incoming clients
     {
       case 1:
         DrawMono(sqi01, cR, cG, cB); // squid
-        delay(200);
+        stepWait = 200;
         break;
       case 2:
       default:
         DrawMono(sqi02, cR, cG, cB);
-        delay(200);
+        stepWait = 200;
         break;
     }
     if (++stepMotif > 2)
@@ -1091,12 +706,12 @@ WiFiClient client = server.available();   // listen for incoming clients
     {
       case 1:
         DrawMulti(eye01);            // Eyes
-        delay(600);
+        stepWait = 600;
         break;
       case 2:
       default:
         DrawMulti(eye02);
-        delay(600);
+        stepWait = 600;
         break;
     }
     if (++stepMotif > 2)
@@ -1105,12 +720,12 @@ WiFiClient client = server.available();   // listen for incoming clients
 
   case 7:
     DrawMatrix();                    // Matrix screen
-    delay(100);
+    stepWait = 100;
     break;
 
   case 8:
     DrawFireworks();                 // Fireworks
-    delay(120);
+    stepWait = 120;
     break;
 
   case 9:
@@ -1118,44 +733,44 @@ WiFiClient client = server.available();   // listen for incoming clients
     {
       case 1:
         DrawMulti(sq01);        
-        delay(100);
+        stepWait = 100;
         break;
       case 2:
         DrawMulti(sq02);
-        delay(100);
+        stepWait = 100;
         break;
       case 3:
         DrawMulti(sq03);
-        delay(100);
+        stepWait = 100;
         break;
       case 4:
         DrawMulti(sq04);
-        delay(100);
+        stepWait = 100;
         break;
       case 5:
         DrawMulti(sq05);
-        delay(100);
+        stepWait = 100;
         break;
       case 6:
         DrawMulti(sq06);
-        delay(100);
+        stepWait = 100;
         break;
       case 7:
         DrawMulti(sq05);
-        delay(100);
+        stepWait = 100;
         break;
       case 8:
         DrawMulti(sq04);
-        delay(100);
+        stepWait = 100;
         break;
       case 9:
         DrawMulti(sq03);
-        delay(100);
+        stepWait = 100;
         break;
       case 10:
       default:
         DrawMulti(sq02);
-        delay(100);
+        stepWait = 100;
         break;
     }
     if (++stepMotif > 10)
@@ -1164,25 +779,39 @@ WiFiClient client = server.available();   // listen for incoming clients
 
   case 10: 
     DrawScroll(apero, cR, cG, cB, 33);   // Apero
-    delay(100);
+    stepWait = 100;
     break;
     
   case 11:
     DrawText(cR, cG, cB);            // text
-    delay(100);
+    stepWait = 100;
     break;
     
   case 12:
     DrawtxeT(cR, cG, cB);            // text reversed
-    delay(100);
+    stepWait = 100;
     break;
 
   default:                           // screen OFF
     clearFB();
     drawFB(0,0,0);
-    delay(500);
+    stepWait = 500;
     break;
   }
+
+  stats[STAT_STEP].add(cyclestat::now() - stepStart);
+  stepDue += stepWait;                          // keep the rhythm
+  if ((long)(millis() - stepDue) > 0)           // more than one step late
+    stepDue = millis() + stepWait;
+}
+
+/*
+ * LED array to the matrix
+ */
+void ShowLeds()
+{
+  cyclestat::Scope stat(stats[STAT_SHOW]);
+  FastLED.show();
 }
 
 /*
@@ -1217,7 +846,7 @@ void RandomColor()
  */
 void DoPixel(int pixel, int red, int green, int blue, int intensite)
 {
-int idpix = 3*pixel;
+int idpix = LED_PER_PIX*pixel;
 
   switch(intensite)
   {
@@ -1258,7 +887,7 @@ int idpix = 3*pixel;
  */
 void ClearPixel(int pixel)
 {
-int idpix = 3*pixel;
+int idpix = LED_PER_PIX*pixel;
 
   leds[idpix] =     CRGB ( 0,   0,   0);
   leds[idpix + 1] = CRGB ( 0,   0,   0);
@@ -1266,60 +895,35 @@ int idpix = 3*pixel;
 }
 
 /*
- * animate a line
+ * animate a line, one pixel per call
  */
-void AnimateLine(bool turnon, int line, int dt)
+void AnimateLine(bool turnon, int line, int pixel)
 {
-int startPixl = line*11;
+int startPixl = line*MX_WIDTH;
 
   if (turnon)
   {
-    for (int i=0; i< 88; i++)
-      ClearPixel(i);
-
-    for (int i=0; i< 11; i++)   // on
+    if (pixel == 0)             // start on a black screen
     {
-      DoPixel(startPixl + i,cR, cG, cB, 1);
-      delay(dt);
-      FastLED.show();
+      for (int i=0; i< MX_PIXELS; i++)
+        ClearPixel(i);
     }
+    DoPixel(startPixl + pixel, cR, cG, cB, 1);   // on
   }
   else
   {
-    for (int i=0; i< 11; i++)   // off
-    {
-      ClearPixel(startPixl + i);
-      delay(dt);
-      FastLED.show();
-    }
+    ClearPixel(startPixl + pixel);               // off
   }
+  ShowLeds();
 }
 
 /*
- *  monochrome shape char[8, 11] = intensity map
+ *  monochrome shape, packed 2-bit intensity map in flash
  */
-void DrawMono(char* motif, int aR, int aG, int aB)
+void DrawMono(const uint8_t* motif, int aR, int aG, int aB)
 {
-int pixel;
-int intensite;
-
-  for (int lin=0; lin < 8; lin++)
-  {
-    for (int col = 0; col < 11; col++)
-    {
-      pixel = (lin*11 + col);
-      if (lin%2 == 0)    // even line
-      {
-        intensite = lin*11 + col;
-      }
-      else               // odd line reversed
-      {
-        intensite = lin*11 +10 - col;
-      }
-      DoPixel(pixel, aR, aG, aB, motif[intensite]);
-    }
-  }
-  FastLED.show();
+  bigmotif::drawMono(leds, motif, aR, aG, aB);   // strip order, no remap
+  ShowLeds();
 }
 
 /*
@@ -1353,81 +957,92 @@ char TypoFromAscii(char asc)
 }
 
 /*
-*   initialize a new letter to display
+*   text message from the request, stop at the end of the buffer
 */
-void initTypo()
+void SetMsg(const char* text)
 {
-  typoIndex = TypoFromAscii(msg[msgIdx]);  // get typo rank
-  typoCol = 0;                             // start width
-  doSpace = 1;
+int i;
+
+  for (i = 0; i < (MAXMSG-1) && text[i] != '\0'; i++)
+    msg[i] = text[i];
+  msg[i] = '\0';                             // zero string
+  RasterMsg();                               // ready
+  Serial.print("MSG = ");
+  Serial.println(msg);
 }
 
 /*
-*   Clear FB matrix
+*   msg to txtCols once: a blank column then the columns of each letter
 */
-void clearFB()
+void RasterMsg()
 {
-   for (int lin=0; lin < 8; lin++)      // draw FB matrix
-    for (int col = 0; col < 11; col++)
-      mxFB1[lin*11 + col] = 0;
-}
+int typoIndex;
+int first;
+int width;
 
-/*
-*   Left shift FB matrix
-*/
-void LshiftFB(int first, int last)
-{
-  for (int lin=first; lin < last; lin++)      // Left shift FB matrix
-    for (int col = 0; col < 10; col++)
-      mxFB1[lin*11 + col] = mxFB1[lin*11 + col + 1];
+  txtLen = 0;
+  for (int i = 0; i == 0 || msg[i] != '\0'; i++)  // empty msg = one space
+  {
+    typoIndex = TypoFromAscii(msg[i]);     // get typo rank
+    first = pgm_read_byte(&typIdx[typoIndex]);
+    width = pgm_read_byte(&typWdt[typoIndex]);
+    txtCols[txtLen++] = 0;                 // inter-character
+    for (int col = 0; col < width; col++)
+      txtCols[txtLen++] = pgm_read_byte(&typo[first + col]);
+  }
+  txtPos = 0;
 }
 
 /*
-*   Right shift FB matrix
+*   Clear FB matrix
 */
-void RshiftFB(int first, int last)
+void clearFB()
 {
-  for (int lin=first; lin < last; lin++)      // Right shift FB matrix
-    for (int col = 10; col > 0; col--)
-      mxFB1[lin*11 + col] = mxFB1[lin*11 + col - 1];
+  scroller.stop();
+  for (int lin=0; lin < MX_HEIGHT; lin++)      // draw FB matrix
+    for (int col = 0; col < MX_WIDTH; col++)
+      mxFB1[lin*MX_WIDTH + col] = 0;
 }
 
 /*
-*   draw FB matrix
+*   draw FB matrix, through the view of the scrolling sequence if any
 */
 void drawFB(int aR, int aG, int aB)
 {
 int pixel;
 int intensite;
 
-  for (int lin=0; lin < 8; lin++)
+  for (int lin=0; lin < MX_HEIGHT; lin++)
   {
-    for (int col = 0; col < 11; col++)
+    for (int col = 0; col < MX_WIDTH; col++)
     {
-      pixel = lin*11 + col;
-      if (lin%2 == 0)    // even line
-      {
-        intensite = lin*11 + col;
-      }
-      else               // odd line reversed
-      {
-        intensite = lin*11 + 10 - col;
-      }
-      DoPixel(pixel,aR, aG, aB, mxFB1[intensite]);
+      pixel = lin*MX_WIDTH + col;
+      intensite = BigLayout::position(pixel);   // odd lines reversed
+      DoPixel(pixel,aR, aG, aB, scroller.pixel(mxFB1, intensite / MX_WIDTH, intensite % MX_WIDTH));
     }
   }
-  FastLED.show();
+  ShowLeds();
 }
 
 /*
- *  monochrome scrollable motif char[8, largeur] = intensity map
- */
-void DrawScroll(char* motif, int aR, int aG, int aB, int largeur)
+*   scroll one column of a strip, the view slides, the FB does not move
+*/
+void ScrollStep(const uint8_t* columns, bool inFlash, int nbColumns, int first, int last, bool leftwards, int column)
 {
-  LshiftFB(0,8);
+  if (!scroller.showing(columns, leftwards))   // new scrolling sequence
+  {
+    scroller.flatten(mxFB1);                   // FB = what is shown
+    scroller.start(columns, inFlash, nbColumns, first, last, leftwards);
+  }
+  scroller.step(column);
+}
 
-  for (int lin = 0; lin < 8; lin++)    // draw last column
-    mxFB1[lin*11 + 10] = motif[lin*largeur + scrollH];
+/*
+ *  monochrome scrollable motif, largeur packed columns of 8 intensities in flash
+ */
+void DrawScroll(const uint8_t* motif, int aR, int aG, int aB, int largeur)
+{
+  ScrollStep(motif, true, largeur, 0, MX_HEIGHT, true, scrollH);   // last column
 
   if (++scrollH > largeur-1)           // restart motif
   {
@@ -1442,34 +1057,12 @@ void DrawScroll(char* motif, int aR, int aG, int aB, int largeur)
  */
 void DrawText(int aR, int aG, int aB)
 {
-  // current letter
-  if (doSpace == 0 && ++typoCol > typWdt[typoIndex])   // end of current typo
+  if (txtPos >= txtLen)
   {
-    msgIdx++;   // next letter in msg
-    if (msg[msgIdx] == '\0')  
-    {
-      msgIdx = 0;     // rewind
-      RandomColor();
-    }
-    initTypo();
-  }
-
-  LshiftFB(2, 7);            // Left shift FB matrix for text
-
-  if (doSpace == 1)
-  {
-    for (int lin = 2; lin < 7; lin++)  // clear last column
-    {
-      mxFB1[lin*11 + 10] = 0;
-    }
-    doSpace = 0;
-  }
-  else
-  {
-    for (int lin = 2; lin < 7; lin++)  // draw last column
-      mxFB1[lin*11 + 10] = typo[typIdx[typoIndex]*5 + (lin-2)*typWdt[typoIndex] + typoCol - 1];
+    txtPos = 0;       // rewind
+    RandomColor();
   }
-  
+  ScrollStep(txtCols, false, txtLen, 2, 7, true, txtPos++);    // last column
   drawFB(aR, aG, aB);
 }
 
@@ -1478,84 +1071,22 @@ void DrawText(int aR, int aG, int aB)
  */
 void DrawtxeT(int aR, int aG, int aB)
 {
-  // current letter
-  if (doSpace == 0 && ++typoCol > typWdt[typoIndex])   // end of current typo
+  if (txtPos >= txtLen)
   {
-    msgIdx++;   // next letter in msg
-    if (msg[msgIdx] == '\0')  
-    {
-      msgIdx = 0;     // rewind
-      RandomColor();
-    }
-    initTypo();
-  }
-
-  RshiftFB(2, 7);            // Right shift FB matrix for text
-
-  if (doSpace == 1)
-  {
-    for (int lin = 2; lin < 7; lin++)  // clear first column
-    {
-      mxFB1[lin*11] = 0;
-    }
-    doSpace = 0;
-  }
-  else
-  {
-    for (int lin = 2; lin < 7; lin++)  // draw first column
-      mxFB1[lin*11] = typo[typIdx[typoIndex]*5 + (lin-2)*typWdt[typoIndex] + typoCol - 1];
+    txtPos = 0;       // rewind
+    RandomColor();
   }
-  
+  ScrollStep(txtCols, false, txtLen, 2, 7, false, txtPos++);   // first column
   drawFB(aR, aG, aB);
 }
 
 /*
- * colored shape char[8, 3] = RGB + char[8, 11] = color & intensity
+ * colored shape, packed palette of 8 RGB + runs of color & intensity in flash
  */
-void DrawMulti(char*  motif)
+void DrawMulti(const uint8_t* motif)
 {
-int idpix;
-int idcolor;
-
-  for (int lin=0; lin < 8; lin++)
-  {
-    for (int col = 0; col < 11; col++)
-    {
-      idpix = 3*(lin*11 + col);
-      if (lin%2 == 0)   // even line
-      {
-        idcolor = motif[24 + lin*11 + col];
-      }
-      else              // odd line reversed
-      {
-        idcolor = motif[24 + lin*11 + 10 - col];
-      }
-
-      if (idcolor > 19)      // 20 to 27  intensity=3
-      {
-        idcolor = 3*(idcolor - 20);  // RGB intensity 3
-        leds[idpix] = CRGB ( motif[idcolor], motif[idcolor+1], motif[idcolor+2]);
-        leds[idpix + 1] = CRGB ( motif[idcolor], motif[idcolor+1], motif[idcolor+2]);
-        leds[idpix + 2] = CRGB ( motif[idcolor], motif[idcolor+1], motif[idcolor+2]);
-
-      }
-      else if (idcolor > 9)  //  10 to 17  intensity=2
-      {
-        idcolor = 3*(idcolor - 10);  // RGB intensity 2
-        leds[idpix] = CRGB ( motif[idcolor], motif[idcolor+1], motif[idcolor+2]);
-        leds[idpix + 1] = CRGB ( 0, 0, 0);
-        leds[idpix + 2] = CRGB ( motif[idcolor], motif[idcolor+1], motif[idcolor+2]);
-      }
-      else                   //  0 to 7  intensity=1
-      {
-        idcolor *= 3;
-        leds[idpix] = CRGB ( 0, 0, 0);
-        leds[idpix + 1] = CRGB ( motif[idcolor], motif[idcolor+1], motif[idcolor+2]);
-        leds[idpix + 2] = CRGB ( 0, 0, 0);
-      }
-    }
-  }
-  FastLED.show();
+  bigmotif::drawMulti(leds, motif);              // strip order, no remap
+  ShowLeds();
 }
 
 /*
@@ -1563,7 +1094,7 @@ int idcolor;
  */
 void DoMxPixel(int pixel, int intensite)
 {
-int idpix = 3*pixel;
+int idpix = LED_PER_PIX*pixel;
 
   switch(intensite)
   {
@@ -1626,48 +1157,42 @@ int pixel;
 char intensite;
 char startval;
 
+  scroller.flatten(mxFB1);           // works on the FB itself
   pixel = random(0,11);
   startval=random(4,7);
   mxFB1[pixel] = startval;
 
-  for (int lin=0; lin < 8; lin++)    // draw matrix 1
+  for (int lin=0; lin < MX_HEIGHT; lin++)    // draw matrix 1
   {
-    for (int col = 0; col < 11; col++)
+    for (int col = 0; col < MX_WIDTH; col++)
     {
-      pixel = lin*11 + col;
-      if (lin%2 == 0)    // even line
-      {
-        intensite = lin*11 + col;
-      }
-      else               // odd line reversed
-      {
-        intensite = lin*11 + 10 - col;
-      }
+      pixel = lin*MX_WIDTH + col;
+      intensite = BigLayout::position(pixel);   // odd lines reversed
       DoMxPixel(pixel, mxFB1[intensite]);
     }
   }
 
-  for (int lin=0; lin < 8; lin++)    // modify matrix 2
+  for (int lin=0; lin < MX_HEIGHT; lin++)    // modify matrix 2
   {
-    for (int col = 0; col < 11; col++)
+    for (int col = 0; col < MX_WIDTH; col++)
     {
-      intensite = mxFB1[lin*11 + col];
+      intensite = mxFB1[lin*MX_WIDTH + col];
       if (intensite > 0)
       {
-        mxFB2[lin*11 + col] = intensite - 1;
+        mxFB2[lin*MX_WIDTH + col] = intensite - 1;
         if (lin < 7)
           mxFB2[(lin+1)*11 + col] = intensite;
       }
     }
   }
-  for (int lin=0; lin < 8; lin++)    // copy 2 to 1
+  for (int lin=0; lin < MX_HEIGHT; lin++)    // copy 2 to 1
   {
-    for (int col = 0; col < 11; col++)
+    for (int col = 0; col < MX_WIDTH; col++)
     {
-      mxFB1[lin*11 + col] = mxFB2[lin*11 + col];
+      mxFB1[lin*MX_WIDTH + col] = mxFB2[lin*MX_WIDTH + col];
     }
   }
-  FastLED.show();
+  ShowLeds();
 }
 
 /*
@@ -1675,7 +1200,7 @@ char startval;
  */
 void DoFwPixel(int pixel, int R, int G, int B,int intensite)
 {
-int idpix = 3*pixel;
+int idpix = LED_PER_PIX*pixel;
 
   switch(intensite)
   {
@@ -1739,6 +1264,7 @@ int column;
 char intensite;
 char startval;
 
+  scroller.flatten(mxFB1);           // works on the FB itself
   for (int i=0; i< 2; i++)
   {
     column = random(0,11);
@@ -1750,42 +1276,35 @@ char startval;
     fiB[column] = cB;
   }
 
-  for (int lin=0; lin < 8; lin++)            // draw matrix 1
+  for (int lin=0; lin < MX_HEIGHT; lin++)            // draw matrix 1
   {
-    for (int col = 0; col < 11; col++)
+    for (int col = 0; col < MX_WIDTH; col++)
     {
-      pixel = lin*11 + col;
-      if (lin%2 == 0)    // even line
-      {
-        intensite = lin*11 + col;
-      }
-      else               // odd line reversed
-      {
-        intensite = lin*11 + 10 - col;
-      }
+      pixel = lin*MX_WIDTH + col;
+      intensite = BigLayout::position(pixel);   // odd lines reversed
       DoFwPixel(pixel, fiR[col],fiG[col],fiB[col], mxFB1[intensite]);
     }
   }
 
-  for (int lin=0; lin < 8; lin++)            // modify matrix 2
+  for (int lin=0; lin < MX_HEIGHT; lin++)            // modify matrix 2
   {
-    for (int col = 0; col < 11; col++)
+    for (int col = 0; col < MX_WIDTH; col++)
     {
-      intensite = mxFB1[lin*11 + col];
+      intensite = mxFB1[lin*MX_WIDTH + col];
       if (intensite > 0)
       {
-        mxFB2[lin*11 + col] = intensite - 1;
+        mxFB2[lin*MX_WIDTH + col] = intensite - 1;
         if (lin < 7)
           mxFB2[(lin+1)*11 + col] = intensite;
       }
     }
   }
-  for (int lin=0; lin < 8; lin++)            // copy 2 to 1
+  for (int lin=0; lin < MX_HEIGHT; lin++)            // copy 2 to 1
   {
-    for (int col = 0; col < 11; col++)
+    for (int col = 0; col < MX_WIDTH; col++)
     {
-      mxFB1[lin*11 + col] = mxFB2[lin*11 + col];
+      mxFB1[lin*MX_WIDTH + col] = mxFB2[lin*MX_WIDTH + col];
     }
   }
-  FastLED.show();
+  ShowLeds();
 }
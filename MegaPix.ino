@@ -33,6 +33,22 @@
    2023-07-21  v1.5  T. JOUBERT  UDP animation
    2023-07-24  v1.6  T. JOUBERT  Overcome UDP MTU
    2023-08-04  v1.7  T. JOUBERT  Updated images
+   2026-10-15  v1.8  T. JOUBERT  MPX decoder from mpx.h
+   2026-10-15  v1.9  T. JOUBERT  Image offset index
+   2026-10-15  v2.0  T. JOUBERT  Decoded images cache
+   2026-10-15  v2.1  T. JOUBERT  Serpentine table, pre-scaled palette
+   2026-10-15  v2.2  T. JOUBERT  HTTP request parser and route table
+   2026-10-15  v2.3  T. JOUBERT  Chunked UDP upload with CRC32 and ACK/NACK
+   2026-10-15  v2.4  T. JOUBERT  Tear-free UDP motif, triple buffer
+   2026-10-15  v2.5  T. JOUBERT  Live frame streaming over UDP
+   2026-10-15  v2.6  T. JOUBERT  Extended MPX with delta images
+   2026-10-15  v2.7  T. JOUBERT  Long runs and packed images
+   2026-10-15  v2.8  T. JOUBERT  MPX validated once, unchecked render
+   2026-10-15  v2.9  T. JOUBERT  Flash store of uploads, played in place
+   2026-10-15  v3.0  T. JOUBERT  Absolute frame deadlines, jitter counters
+   2026-10-15  v3.1  T. JOUBERT  Stage histograms, /stats route
+   2026-10-15  v3.2  T. JOUBERT  HTTP task on core 0, command queues
+   2026-10-15  v3.3  T. JOUBERT  Matrix layout, parallel LED strips
    ================================================================
 
     This code follows the general structure of the Arduino code:
@@ -44,12 +60,36 @@
     A WEB server is open on http://10.1.1.1:80 a single HTML page is
     sent to the browser, it allows you to choose a graphic animation.
     A UDP server is open on 10.1.1.1:2023 to directly receive an image
-    in MPX binary format. The UDP processing callback is initialized as
+    in MPX binary format, cut in chunks by the mpxudp.h protocol (session,
+    chunk index, CRC32, ACK/NACK with the bitmap of the received chunks, see
+    SendMotifUDP.cpp). Files up to UDP_MAX_MPX bytes are rebuilt in the back
+    buffer of udpMotif and shown once complete and checked. The former raw
+    packets (one or two packets less than one second apart) are still accepted.
+    udpMotif is a triple buffer (tribuf.h): the UDP task publishes a complete
+    motif with one atomic exchange, loop() takes it before drawing the next
+    image. loop() never waits for the network and never sees a partial motif.
+    The same port receives live frames (mpxlive.h, see livesend.cpp): palette
+    indices, deltas of them or R,G,B, each with a sequence number and the
+    sender time. The UDP task only queues them (liveRing), loop() decodes them
+    into a jitter buffer of a few frames and shows each one LIVE_DELAY_MS after
+    its earliest arrival; frames older than the one shown are dropped. The
+    first live packet of a stream selects sequence 8, fps, latency, lost and
+    late frames are printed every LIVE_REPORT_MS on the serial line.
+    Chunked uploads are written once into the flash store (mpxstore.h) of
+    the "mpx" data partition (partitions.csv; the SPIFFS partition of the
+    default tables otherwise): a log of records, each one erased, programmed
+    chunk by chunk as they arrive and committed by its header once the CRC32
+    matches. The UDP guest sequence plays the newest record straight from
+    memory-mapped flash, without a copy in RAM; it is still there after a
+    reboot and it may be as big as the partition. The record played and the
+    newest one are never erased by the next upload (storePinned,
+    storeLatest). Without the partition uploads go to udpMotif as before.
+    The UDP processing callback is initialized as
     a lambda expression in the setup function.
     
     In the loop() function the firmware checks if an HTTP request has been sent
     to read and analyze it. Then and systematically the firmware displays an
-    animated sequence out of seven in the current version:
+    animated sequence out of nine in the current version:
       0 - Animate a color line (default)
       1 - Heart beat
       2 - Palette
@@ -58,8 +98,9 @@
       5 - TJO
       6 - Vermeer
       7 - UDP motif
+      8 - UDP live stream
       
-    All of the above patterns are in MPX format:
+    All of the above patterns are in MPX format, decoded with mpx.h:
     The MPX Header:
         data[0] --> Nb of colors - excluding pal[0]=Black and pal[1]=White
         data[1] --> Nb of images (max 10)
@@ -83,6 +124,28 @@
         each line is encoded separately, the maximum repetition number is 1F
         (31 repeated pixels). So a black line is coded with two bytes:
         0x20, 0x1F,
+
+    Extended MPX (mpx.h): data[0] = 0xE0 | flags, then the classic header
+    and palette, with flag 0x02 the byte after data[0] is the tempo unit in
+    100us (1ms with 10) instead of 10ms. Each image is tempo, coding, payload
+    size (16 bits), payload.
+    A delta image only draws the pixels that changed since the previous
+    image, it is decoded directly over the previous image in the LED array.
+    Long runs go across lines and up to 287 pixels; a packed image holds 1, 2
+    or 4 bits per pixel, indices into its own list of up to 16 palette colors,
+    and is drawn with one lookup per pixel.
+    The images of an animation are shown in order; when leds[] does not hold
+    the previous image (other sequence, brightness change) the images are
+    drawn again from the last full image.
+    An animation is validated once when it becomes current (mpx::validate():
+    header, image offsets, color codes inside its palette, runs inside the
+    512 pixels); its images are then drawn without any check. A motif that
+    fails is not drawn, the embedded motifs are checked at boot.
+    Each image is due at the deadline of the previous one plus its tempo
+    (pacer.h), the decode and show times do not delay the animation. An image
+    whose tempo is already over when it is due is dropped. The jitter (how
+    late the show of the images starts), shown and dropped counts are printed every
+    FRAME_REPORT_MS.
         
     ---- CONTENT OF AN MPX DATA PACKET ----
 
@@ -133,22 +196,89 @@
     testing the matrix during LED assembly). They also allow you to go up/down the
     global brightness, to control consumption. The basic brightness is 1, it will 
     go to a maximum of 3.
+
+    Decoded images are kept in a cache of FRAME_CACHE_BYTES, once an image has
+    been decoded it is displayed again with a single copy into the LED array.
+    The images of an animation that do not fit in the cache are decoded each
+    time they are displayed. The cache is cleared when another animation is
+    selected, received or when the brightness changes.
+
+    The palette is scaled to the brightness once, when the cache is cleared,
+    and each run of the RLE is copied as one span per line into the LED array.
+    The serpentine order of the LEDs comes from a table built by the compiler
+    (ledmap.h).
+
+    The matrix may be wired as MPX_STRIPS parallel strips of 16 / MPX_STRIPS
+    lines, on LED_PIN, LED_PIN2... each strip starting as the first line.
+    FastLED writes the strips at the same time (one RMT channel each), so
+    FastLED.show() lasts the time of one strip: 15 ms for the 512 LEDs on one
+    pin, 8 ms on two, 4 ms on four.
+
+    The HTTP request is read by chunks into a fixed buffer (httpreq.h), only
+    its first line is kept. Once the request is complete its path selects an
+    entry of the routes[] table and the handler of that entry is called. The
+    request is dropped if it is not complete after HTTP_TIMEOUT_MS.
+
+    The time spent in each stage goes to a histogram of cycles (cyclestat.h):
+    HTTP request, UDP packet (UDP task), decode of DrawMPX, FastLED.show()
+    (about 15 ms for the 512 LEDs) and idle loop() passes, that neither apply
+    a command nor show. GET /stats answers them in JSON, they are also printed
+    on the serial line every STATS_REPORT_MS if it is not 0. CYCLESTAT 0
+    compiles them out.
+
+    The network runs beside the animation: the HTTP server has its own task
+    on NET_CORE (core 0, with the WiFi stack), loop() renders on core 1 and
+    AsyncUDP calls back from its task. Neither writes the state of the
+    animation: a route or an upload pushes a command into its own lock-free
+    queue (cmdqueue.h, one producer, one consumer) and loop() applies the
+    commands before the next image, so web traffic never delays a frame and
+    the 15 ms FastLED.show() never delays a request.
  
 */
 
-#define Version   "MegaPix-v1.7 (c)TJO 2023"
+#define Version   "MegaPix-v3.3 (c)TJO 2023"
 
 #include <WiFi.h>            // comment for ESP8266
 //#include <ESP8266WiFi.h>   // uncomment for ESP8266
 #include <FastLED.h>
 #include <AsyncUDP.h>
 #include "motifsMPX.h"
-
-#define LED_PIN       16
-#define NUM_LEDS      512
+#include "mpx.h"
+#define MPX_STRIPS    1              // parallel LED strips: 1, 2 or 4
+#include "mpxrender.h"
+#include "httpreq.h"
+#include "mpxudp.h"
+#include "tribuf.h"
+#include "mpxlive.h"
+#include "mpxstore.h"
+#include "pacer.h"
+#define CYCLESTAT 1                  // 0 removes the stage histograms
+#include "cyclestat.h"
+#include "cmdqueue.h"
+
+#define LED_PIN       16                                     // first strip
+#define LED_PIN2      17
+#define LED_PIN3      18
+#define LED_PIN4      19
+#define NUM_LEDS      mpx::LedMap::LEDS                      // 512
+#define STRIP_LEDS    mpx::LedMap::STRIP_LEDS
+#if MPX_STRIPS != 1 && MPX_STRIPS != 2 && MPX_STRIPS != 4
+#error "MPX_STRIPS must be 1, 2 or 4"
+#endif
 #define INITSEQUENCE  0
 #define MAX_INTENSITY 3
-#define TEMPO_UNIT_MS 10
+#define HTTP_TIMEOUT_MS 2000
+#define UDP_MAX_MPX   (16*1024)                              // biggest MPX upload
+#define FRAME_CACHE_BYTES  (32*NUM_LEDS*3)                   // 48 KB decoded images
+#define FRAME_CACHE_IMAGES (FRAME_CACHE_BYTES/(NUM_LEDS*3))
+#define LIVE_DELAY_MS 50                                     // jitter buffer playout delay
+#define LIVE_QUEUE    8                                      // packets UDP task -> loop()
+#define LIVE_REPORT_MS 5000
+#define STORE_LABEL   "mpx"                                  // data partition of the uploads
+#define FRAME_REPORT_MS 5000
+#define STATS_REPORT_MS 0                                    // stage histograms on serial, 0 = off
+#define NET_CORE      0                                      // HTTP task, loop() is on core 1
+#define NET_STACK     4096
 
 /* --- MegaPix access values --- */
 const char *ssid = "MegaPix";
@@ -157,38 +287,111 @@ IPAddress gateway(10,1,1,0);
 IPAddress subnet(255,255,255,0);
 
 WiFiServer server(80);  // HTTP server
+http::RequestParser request; // current HTTP request
 AsyncUDP udp;           // UDP receiver
 CRGB leds[NUM_LEDS];    // LED matrix
 
 //
 // MPX Display structures
 //
-char udpmotif[2300];    // UDP receiver structure
-unsigned char palCol[680]; // current palette, saves stack
+TripleBuffer<UDP_MAX_MPX + 1> udpMotif; // UDP motif, written by the UDP task
+mpxudp::Receiver uploader(udpMotif.writeBuffer(), UDP_MAX_MPX);
+unsigned char palCol[mpx::PAL_SIZE*3]; // current palette, saves stack
+CRGB palScaled[mpx::PAL_SIZE];         // palCol at cacheIntensity
+mpx::Animation anim;                   // validated current animation
+const char* indexedMotif = NULL;       // animation in anim, NULL = to validate
+const char* rejectedMotif = NULL;      // failed validation, not drawn
+CRGB frameCache[FRAME_CACHE_IMAGES][NUM_LEDS]; // decoded images of indexedMotif
+int  cacheTempo[FRAME_CACHE_IMAGES];   // tempo of cached images, -1 = not decoded
+int  cacheIntensity = -1;              // intensity of palScaled and cached images
+int  ledsImage = -1;                   // image of indexedMotif in leds[], -1 = none
+int  ledsSequence = -1;                // sequence that drew leds[]
+long tempoUnit = mpx::TEMPO_US;        // us, tempo unit of anim
+Pacer pacer;                           // image deadlines, us
+unsigned long frameReport = 0;         // last jitter print
+
+//
+// Flash store of the uploads
+//
+typedef mpxstore::Store<mpxstore::PartitionFlash> MpxStore;
+mpxstore::PartitionFlash flash;        // memory-mapped data partition
+MpxStore store(flash);                 // written by the UDP task only
+std::atomic<uint32_t> storeLatest(mpxstore::NONE);  // newest record, UDP task
+std::atomic<uint32_t> storePinned(mpxstore::NONE);  // record played by loop()
+mpxstore::Upload<MpxStore> storeUpload(store, storeLatest, storePinned);
+bool storeReady = false;               // uploads go to the store
+uint32_t takenRecord = mpxstore::NONE; // newest record taken by loop()
+const char* guestMotif = NULL;         // UDP guest sequence
+int  guestSize = 0;
+
+//
+// Live stream structures
+//
+mpxlive::PacketRing<LIVE_QUEUE, mpxlive::MAX_PACKET> liveRing; // from the UDP task
+mpxlive::Player live(LIVE_DELAY_MS);   // jitter buffer, loop() only
+uint8_t livePacket[mpxlive::MAX_PACKET];
+unsigned long liveLast = 0;            // last live packet, UDP task
+unsigned long liveReport = 0;          // last counters print
 
 int sequence  = 0;      // current sequence
-int randomSeq = 0;      // random mode ON/OFF
+std::atomic<int> randomSeq(0);  // random mode ON/OFF, shown by the HTTP task
 int intensity = 1;      // LED level
 int animLine  = 0;      // first line to animate
 int cR, cG, cB;         // current color for line & text
 int stepMotif = 1;      // animation step number
 int imgdone   = 0;      // animation state automaton
+int lineStep  = 0;      // line pixel, WIDTH on then WIDTH off
+unsigned long lineDue = 0;      // deadline of the next line pixel, ms
 int tempoAnim;          // current image temporisation
-int startSeq;           // sequence start time
 int startUDP = 0;       // sequence start time
 int offsetUDP = 0;      // UDP multi packet because MTU=1470
 int UDPfirstSz = 0;     // first UDP packet size
+
+//
+// Stage histograms, /stats
+//
+enum Stat { STAT_HTTP, STAT_UDP, STAT_DECODE, STAT_SHOW, STAT_IDLE, NB_STATS };
+const char* const statNames[NB_STATS] = { "http", "udp", "decode", "show", "idle" };
+cyclestat::Histogram stats[NB_STATS];
+unsigned long showCount = 0;           // FastLED.show() calls of loop()
+unsigned long showStart = 0;           // us, start of the last FastLED.show()
+unsigned long statsReport = 0;         // last serial print
+int statsRequest = 0;                  // GET /stats, HTTP task
+
+//
+// Commands of the network tasks, applied by loop()
+//
+enum CommandOp { CMD_SHOW, CMD_RESTART, CMD_NEXT, CMD_PREV };  // arg: sequence
+CommandQueue<> httpCommands;           // HTTP task -> loop()
+CommandQueue<> udpCommands;            // UDP task -> loop()
 //
 //  initialize LED, HTTP and UDP
 //
 void setup()
 {
-  FastLED.addLeds<WS2812, LED_PIN, GRB>(leds, NUM_LEDS); // init LED object
+  FastLED.addLeds<WS2812, LED_PIN, GRB>(leds, 0, STRIP_LEDS); // init LED object, one per strip
+#if MPX_STRIPS > 1
+  FastLED.addLeds<WS2812, LED_PIN2, GRB>(leds, STRIP_LEDS, STRIP_LEDS);
+#endif
+#if MPX_STRIPS > 2
+  FastLED.addLeds<WS2812, LED_PIN3, GRB>(leds, 2*STRIP_LEDS, STRIP_LEDS);
+  FastLED.addLeds<WS2812, LED_PIN4, GRB>(leds, 3*STRIP_LEDS, STRIP_LEDS);
+#endif
   Serial.begin(115200);
   Serial.println(Version);
   Serial.println();
 
-  for (int i = 0; i< 256; i++)            // clear matrix
+  const char* embedded[] = { heart, palette, donald, mickey, tjo, perle };
+  const int embeddedSz[] = { sizeof(heart), sizeof(palette), sizeof(donald),
+                             sizeof(mickey), sizeof(tjo), sizeof(perle) };
+  for (int i = 0; i < 6; i++)             // embedded motifs, checked once
+    if (!mpx::validate((const uint8_t*)embedded[i], embeddedSz[i], anim))
+    {
+      Serial.print("Embedded motif rejected: ");
+      Serial.println(i);
+    }
+
+  for (int i = 0; i < NUM_LEDS; i++)      // clear matrix
     leds[i] = CRGB(0,0,0);
   Serial.print("Setting soft-AP configuration ... ");
   Serial.println(WiFi.softAPConfig(local_IP, gateway, subnet) ? "Ready" : "Failed!");
@@ -200,10 +403,24 @@ void setup()
   { cR = 200; cG = 0; cB = 0; }           // red line = WiFi NOK
   sequence = INITSEQUENCE;                // initial display sequence
   server.begin();
+  xTaskCreatePinnedToCore(NetTask, "http", NET_STACK, NULL, 1, NULL, NET_CORE);
   Serial.println("HTTP server started");
   
-  memcpy(udpmotif,perle,sizeof(perle));   // init UDP zone
-  //dumpMem(udpmotif, sizeof(perle));
+  memcpy(udpMotif.writeBuffer(),perle,sizeof(perle));   // init UDP zone
+  udpMotif.publish(sizeof(perle));
+  uploader.setBuffer(udpMotif.writeBuffer());
+  //dumpMem(perle, sizeof(perle));
+
+  if (flash.begin(STORE_LABEL) && store.mount())
+  {                                       // uploads in flash, newest one is the guest
+    storeReady = true;
+    uploader.setStorage(&storeUpload);
+    if (store.count() > 0)
+      storeLatest = store.record(store.count() - 1).offset;
+    Serial.printf("MPX store: %d records, %u KB\n", store.count(), flash.size() / 1024);
+  }
+  else
+    Serial.println("MPX store not found, uploads in RAM");
   
   if(udp.listen(2023))                    // Listen UDP
   {
@@ -212,6 +429,46 @@ void setup()
 
     udp.onPacket([](AsyncUDPPacket packet)
     {
+        cyclestat::Scope stat(stats[STAT_UDP]);
+        if (mpxlive::isLive(packet.data(), packet.length()))
+        {                                 // live frame, loop() decodes it
+          liveRing.push(packet.data(), packet.length());
+          if (millis() - liveLast > mpxlive::TIMEOUT_MS)
+            Post(udpCommands, CMD_SHOW, 8);  // a new stream starts
+          liveLast = millis();
+          return;
+        }
+        if (mpxudp::isFramed(packet.data(), packet.length()))
+        {                                 // chunked upload
+          uint8_t reply[mpxudp::REPLY_SIZE];
+          size_t size;
+          size_t nb = uploader.onPacket(packet.data(), packet.length(), reply);
+          if (nb > 0)
+            packet.write(reply, nb);      // ACK / NACK to the sender
+          if (!uploader.takeComplete(size))
+            return;
+          Serial.print("UDP upload complete, length= ");
+          Serial.println(size);
+          if (storeReady)                 // written in flash, header last
+          {
+            mpxstore::Record rec;
+            if (!store.commit(rec))
+            {
+              Serial.println("MPX store commit failed");
+              return;
+            }
+            storeLatest = rec.offset;     // loop() takes it
+          }
+          else
+          {
+            udpMotif.writeBuffer()[size] = 0;
+            udpMotif.publish(size);       // loop() takes it
+            uploader.setBuffer(udpMotif.writeBuffer());
+          }
+          Post(udpCommands, CMD_SHOW, 7); // set as current sequence
+          return;
+        }
+
         if (millis() - startUDP > 1000)   // first packet 1470 bytes
         { 
           Serial.print("First UDP Packet, length= ");
@@ -226,150 +483,236 @@ void setup()
           offsetUDP = UDPfirstSz;
         }
         Serial.println(packet.length());
-
-        memcpy(udpmotif+offsetUDP,packet.data(),packet.length());  // copy to local data
-        udpmotif[offsetUDP+packet.length()] = 0;
-        //dumpMem(udpmotif, packet.length()+1);
-        sequence = 7;                                    // set as current sequence
-        imgdone = 0;
-        randomSeq = 0;
+        if (offsetUDP + packet.length() > UDP_MAX_MPX)
+          return;                         // does not fit
+
+        uint8_t* motif = udpMotif.writeBuffer();
+        if (offsetUDP > 0)                // first packet is the last published
+          memcpy(motif, udpMotif.lastPublished(), offsetUDP);
+        memcpy(motif+offsetUDP,packet.data(),packet.length());  // copy to local data
+        motif[offsetUDP+packet.length()] = 0;
+        udpMotif.publish(offsetUDP + packet.length());          // loop() takes it
+        uploader.setBuffer(udpMotif.writeBuffer());
+        //dumpMem((char*)motif, packet.length()+1);
+        Post(udpCommands, CMD_SHOW, 7);                  // set as current sequence
     });
   }
 }
 
 //
-//  Play current animation while listening to HTTP requests
+//  HTTP request not complete yet, one tick to the other tasks (IDLE0)
 //
-void loop()
+void HttpWait()
+{
+  delay(1);
+}
+
+//
+//  HTTP routes, the request path selects the sequence, loop() applies it
+//
+void RouteHeart(const char* arg)
+{ Post(httpCommands, CMD_SHOW, 1);
+}
+
+void RouteNext(const char* arg)
+{ Post(httpCommands, CMD_NEXT, 0);
+}
+
+void RoutePrev(const char* arg)
+{ Post(httpCommands, CMD_PREV, 0);
+}
+
+void RoutePalette(const char* arg)
+{ Post(httpCommands, CMD_SHOW, 2);
+}
+
+void RouteDonald(const char* arg)
+{ Post(httpCommands, CMD_SHOW, 3);
+}
+
+void RouteMickey(const char* arg)
+{ Post(httpCommands, CMD_SHOW, 4);
+}
+
+void RouteAnimation(const char* arg)
+{ Post(httpCommands, CMD_RESTART, 5);
+}
+
+void RoutePerle(const char* arg)
+{ Post(httpCommands, CMD_SHOW, 6);
+}
+
+void RouteGuest(const char* arg)
+{ Post(httpCommands, CMD_RESTART, 7);
+}
+
+void RouteStats(const char* arg)     // not a sequence
+{ statsRequest = 1;
+}
+
+const http::Route routes[] = {
+  { "/B",  false, RouteHeart },
+  { "/I",  false, RouteNext },
+  { "/M",  false, RoutePrev },
+  { "/Wa", false, RoutePalette },
+  { "/G",  false, RouteDonald },
+  { "/E",  false, RouteMickey },
+  { "/Mx", false, RouteAnimation },
+  { "/Bp", false, RoutePerle },
+  { "/X",  false, RouteGuest },
+  { "/stats", false, RouteStats },
+};
+const int NB_ROUTES = sizeof(routes)/sizeof(routes[0]);
+
+//
+//  HTTP task on NET_CORE: the requests become commands for loop()
+//
+void NetTask(void* param)
+{
+  for (;;)
+  {
+    ServeHttp();
+    vTaskDelay(1);                        // next poll in a tick
+  }
+}
+
+void ServeHttp()
 {
-  int requestDone = 0;
   WiFiClient client = server.available(); // listen for incoming clients
 
   if (client.available())                 // if you get a client,
   {
-    String currentLine = "";              // make a String to hold incoming data from the client
-    while (client.connected())            // loop while the client is connected
+    cyclestat::Scope stat(stats[STAT_HTTP]);
+    if (http::readRequest(client, request, millis, HTTP_TIMEOUT_MS, HttpWait))
     {
-      if (client.available())             // if there's bytes to read from the client,
+      http::dispatch(routes, NB_ROUTES, request.path());
+      if (statsRequest == 1)              // statistics, JSON
       {
-        char c = client.read();           // read bytes one-by-one, then
-        if (c == '\n')                    // if the byte is a newline character
-        {                                 // got two newline characters in a row.
-          if (currentLine.length() == 0)  // end of HTTP request, so send a response
-          {
-              client.print("HTTP/1.1 200 OK\r\n");
-              client.print("Content-type:text/html\r\n");
-              client.print("\r\n");
-
-              // the content of the HTTP response follows the header:
-              client.print("<head><style>\r\n");
-              client.print("body {background-color:black;text-decoration:none;}\r\n");
-              client.print("h1 {font-size:120px;font-family:Verdana;}\r\n");
-              client.print("h2 {font-size:80px;color:white;font-family:Lucida Console;}\r\n");
-              client.print("h3 {font-size:80px;color:black;font-family:Lucida Console;}\r\n");
-              client.print("</style></head>\r\n");
-
-              client.print("<html><body>\r\n");
-              client.print("<table border=\"20\" width=\"100%\" height=\"20%\">\r\n");
-              client.print("<tr><td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:#FD4600\" href=\"/B\"><h1>BEAT</a>\r\n");
-              client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:#39E721\" href=\"/Wa\"><h2>Palette</a></tr></table>\r\n");
-
-              client.print("<table border=\"20\" width=\"100%\" height=\"20%\" >\r\n");
-              client.print("<tr><td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/I\"><h2>next</a>\r\n");
-              client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/M\"><h2>prev</a></tr></table>\r\n");
-
-              client.print("<table border=\"20\" width=\"100%\" height=\"20%\" >\r\n");
-              client.print("<tr><td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/G\"><h2>Donald</a>\r\n");
-              client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/E\"><h2>Mickey</a></tr></table>\r\n");
-
-              client.print("<table border=\"20\" width=\"100%\" height=\"20%\" >\r\n");
-              client.print("<tr><td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/Mx\"><h2>Anim</a>\r\n");
-              client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/Bp\"><h2>Perle</a></tr></table>\r\n");
-
-              client.print("<table border=\"20\" width=\"100%\" height=\"20%\" style=\"background-color:#7AECDF\">\r\n");
-              client.print("<tr><td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:#9A1CD1\" href=\"/X\"><h3>Guest</a>\r\n");
-              if (randomSeq == 0)
-                client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:#138B1C\" href=\"/R\"><h3>ON</a></tr></table>\r\n");
-              else
-                client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:#B3162E\" href=\"/R\"><h3>OFF</a></tr></table>\r\n");
-
-              client.print("</body></html>\r\n");
-              client.print("\r\n");           // The HTTP response ends with another blank line
-            break;                            // break out of loop while (client.connected())
-          }
-          else                                // if newline, then clear currentLine
-          { currentLine = "";
-          }
-        }   //// END   if (c == '\n')
-        else if (c != '\r')                   // anything but carriage return character,
-        { currentLine += c;                   // add it to the end of the currentLine
-        }
+        statsRequest = 0;
+        client.print("HTTP/1.1 200 OK\r\n");
+        client.print("Content-type:application/json\r\n");
+        client.print("\r\n");
+        cyclestat::writeJson(client, stats, statNames, NB_STATS, millis());
+      }
+      else                                // command request
+      {
+        client.print("HTTP/1.1 200 OK\r\n");
+        client.print("Content-type:text/html\r\n");
+        client.print("\r\n");
+
+        // the content of the HTTP response follows the header:
+        client.print("<head><style>\r\n");
+        client.print("body {background-color:black;text-decoration:none;}\r\n");
+        client.print("h1 {font-size:120px;font-family:Verdana;}\r\n");
+        client.print("h2 {font-size:80px;color:white;font-family:Lucida Console;}\r\n");
+        client.print("h3 {font-size:80px;color:black;font-family:Lucida Console;}\r\n");
+        client.print("</style></head>\r\n");
+
+        client.print("<html><body>\r\n");
+        client.print("<table border=\"20\" width=\"100%\" height=\"20%\">\r\n");
+        client.print("<tr><td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:#FD4600\" href=\"/B\"><h1>BEAT</a>\r\n");
+        client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:#39E721\" href=\"/Wa\"><h2>Palette</a></tr></table>\r\n");
+
+        client.print("<table border=\"20\" width=\"100%\" height=\"20%\" >\r\n");
+        client.print("<tr><td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/I\"><h2>next</a>\r\n");
+        client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/M\"><h2>prev</a></tr></table>\r\n");
+
+        client.print("<table border=\"20\" width=\"100%\" height=\"20%\" >\r\n");
+        client.print("<tr><td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/G\"><h2>Donald</a>\r\n");
+        client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/E\"><h2>Mickey</a></tr></table>\r\n");
+
+        client.print("<table border=\"20\" width=\"100%\" height=\"20%\" >\r\n");
+        client.print("<tr><td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/Mx\"><h2>Anim</a>\r\n");
+        client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:white\" href=\"/Bp\"><h2>Perle</a></tr></table>\r\n");
+
+        client.print("<table border=\"20\" width=\"100%\" height=\"20%\" style=\"background-color:#7AECDF\">\r\n");
+        client.print("<tr><td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:#9A1CD1\" href=\"/X\"><h3>Guest</a>\r\n");
+        if (randomSeq == 0)
+          client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:#138B1C\" href=\"/R\"><h3>ON</a></tr></table>\r\n");
+        else
+          client.print("<td width=\"50%\" align=\"center\"><a style=\"text-decoration:none;color:#B3162E\" href=\"/R\"><h3>OFF</a></tr></table>\r\n");
+
+        client.print("</body></html>\r\n");
+        client.print("\r\n");           // The HTTP response ends with another blank line
+      }
+    }
+    client.stop();                        // close the connection
+    Serial.print("request : ");
+    Serial.println(request.path());
+  } //// END if (client.available())
+}
 
-        // Check the client request
-        if (requestDone == 0)                         // not found request yet
-        {
-          if (currentLine.endsWith("GET /B "))        // Heart
-          { sequence = 1;
-            requestDone = 1;
-          }
-          else if (currentLine.endsWith("GET /I "))   // next
-          { sequence = 0;
-            requestDone = 1;
-            if (intensity < 3)
-              intensity++;
-            RandomColor();
-            if (++animLine > 15)
-              animLine = 0;
-          }
-          else if (currentLine.endsWith("GET /M "))  // prev
-          { sequence = 0;
-            requestDone = 1;
-            if (intensity > 1)
-              intensity--;
-            RandomColor();
-            if (--animLine < 0)
-              animLine = 0;
-          }
-          else if (currentLine.endsWith("GET /Wa ")) // palette
-          { sequence = 2;
-            requestDone = 1;
-          }
-          else if (currentLine.endsWith("GET /G "))  // donald
-          { sequence = 3;
-            requestDone = 1;
-          }
-          else if (currentLine.endsWith("GET /E "))  // mickey
-          { sequence = 4;
-            requestDone = 1;
-          }
-          else if (currentLine.endsWith("GET /Mx ")) // Animation
-          { sequence = 5;
-            requestDone = 1;
-            stepMotif = 0;
-          }
-          else if (currentLine.endsWith("GET /Bp ")) // perle
-          { sequence = 6;
-            requestDone = 1;
-          }
-          else if (currentLine.endsWith("GET /X "))  // UDP guest
-          { sequence = 7;
-            requestDone = 1;
-            stepMotif = 0;
-          }
-           
-          if (requestDone == 1)     // prepare display
-          { imgdone = 0;
-            randomSeq = 0;
-          }
-        }
-      }  //// END if (client.available())
-    }  //// END while (client.connected())
+//
+// Command of a network task for loop(), dropped if its queue is full
+//
+void Post(CommandQueue<>& queue, uint8_t op, uint8_t seq)
+{
+  Command cmd = { op, seq };
 
-    client.stop();                               // close the connection
-    Serial.print("sequence : ");
-    Serial.println(sequence);
-  } //// END if (client.available())
-  /// END OF HTTP REQUEST  ////////////////////////////////////////
+  if (!queue.push(cmd))
+    Serial.println("command queue full");
+}
+
+//
+// Commands of one queue into the animation state, count applied
+//
+int RunCommands(CommandQueue<>& queue)
+{
+  Command cmd;
+  int n = 0;
+
+  while (queue.pop(cmd))
+  {
+    switch (cmd.op)
+    {
+    case CMD_NEXT:
+      sequence = 0;
+      if (intensity < 3)
+        intensity++;
+      RandomColor();
+      if (++animLine > 15)
+        animLine = 0;
+      break;
+
+    case CMD_PREV:
+      sequence = 0;
+      if (intensity > 1)
+        intensity--;
+      RandomColor();
+      if (--animLine < 0)
+        animLine = 0;
+      break;
+
+    case CMD_RESTART:               // from the first image
+      stepMotif = 0;
+      sequence = cmd.arg;
+      break;
+
+    default:
+      sequence = cmd.arg;
+      break;
+    }
+    imgdone = 0;                    // prepare display
+    randomSeq = 0;
+    n++;
+  }
+  return n;
+}
+
+//
+//  Play current animation, commands of the network tasks first
+//
+void loop()
+{
+  uint32_t passStart = cyclestat::now();
+  unsigned long passShows = showCount;
+  int commands = RunCommands(httpCommands) + RunCommands(udpCommands);
+
+  if (sequence != ledsSequence)           // another drawing goes to leds[]
+  {
+    ledsSequence = sequence;
+    ledsImage = -1;
+  }
 
   switch (sequence)
   {
@@ -378,33 +721,64 @@ void loop()
     break;
 
    case 1:                          // Beat
-    AnimateMPX(heart);
+    AnimateMPX(heart, sizeof(heart));
     break;
 
   case 2:                           // palette
-    AnimateMPX(palette);
+    AnimateMPX(palette, sizeof(palette));
     break;
 
   case 3:                           // donald
-    DisplayMPX(donald);
+    DisplayMPX(donald, sizeof(donald));
     break;
 
   case 4:                           // mickey
-    DisplayMPX(mickey);
+    DisplayMPX(mickey, sizeof(mickey));
     break;
 
   case 5:                           // Animation ///////////////////
-    AnimateMPX(tjo);
+    AnimateMPX(tjo, sizeof(tjo));
     break;
 
   case 6:                           // Perle
-    AnimateMPX(perle);
+    AnimateMPX(perle, sizeof(perle));
     break;
 
   case 7:                           // UDP guest
-    AnimateMPX(udpmotif);
+    if (udpMotif.acquire())         // a new motif has been published
+    {
+      guestMotif = (const char*)udpMotif.readBuffer();
+      guestSize = udpMotif.readSize();
+      indexedMotif = rejectedMotif = NULL;   // validate it
+    }
+    if (storeLatest.load() != takenRecord)
+      TakeRecord();                 // a new upload in flash
+    AnimateMPX(guestMotif, guestSize);
+    break;
+
+  case 8:                           // UDP live stream
+    PlayLive();
     break;
   }
+
+  if (commands == 0 && showCount == passShows)  // nothing to do this time
+    stats[STAT_IDLE].add(cyclestat::now() - passStart);
+  if (STATS_REPORT_MS > 0 && millis() - statsReport > STATS_REPORT_MS)
+  {
+    statsReport = millis();
+    cyclestat::writeText(Serial, stats, statNames, NB_STATS);
+  }
+}
+
+//
+// LED array to the matrix, about 15 ms for 512 WS2812
+//
+void ShowLeds()
+{
+  cyclestat::Scope stat(stats[STAT_SHOW]);
+  showStart = micros();
+  FastLED.show();
+  showCount++;
 }
 
 //
@@ -412,14 +786,7 @@ void loop()
 //
 void DoPixel(int li, int co, char red, char green, char blue, char intensite)
 {
-int idpix;
-
-  if (li%2 == 0)   // even line
-  { idpix = co + li*32;
-  }
-  else             // odd line reversed
-  { idpix = (31 - co) + li*32;
-  }
+int idpix = mpx::LedMap::led[co + li*mpx::WIDTH];   // odd lines reversed
 
   switch(intensite)
   {
@@ -450,34 +817,41 @@ int idpix;
 //
 void ClearPixel(int li, int co)
 {
-  int idpix = co + li*32;
+  int idpix = mpx::LedMap::led[co + li*mpx::WIDTH];
   leds[idpix] =     CRGB ( 0,   0,   0);
 }
 
 //
-// animate a line
+// animate a line, one pixel every dt ms
 //
 void AnimateLine(int line, int dt)
 {
-  int startPixl = line*32;
+  unsigned long now = millis();
 
-  for (int i=0; i< 16; i++)
-    for (int j=0; j<32; j++)
-      ClearPixel(i,j);
-
-  for (int i=0; i< 32; i++)   // on
+  if (imgdone == 0)                   // new pass now
   {
-    DoPixel(line,i, cR, cG, cB, intensity);
-    delay(dt);
-    FastLED.show();
-  }
-
-  for (int i=0; i< 32; i++)   // off
-  {
-    ClearPixel(line, 31-i);
-    delay(dt);
-    FastLED.show();
+    lineStep = 0;
+    lineDue = now;
+    imgdone = 1;
   }
+  else if ((long)(now - lineDue) < 0)
+    return;
+
+  if (lineStep == 0)                  // start on a black screen
+    for (int i=0; i< mpx::HEIGHT; i++)
+      for (int j=0; j<mpx::WIDTH; j++)
+        ClearPixel(i,j);
+
+  if (lineStep < mpx::WIDTH)          // on
+    DoPixel(line, lineStep, cR, cG, cB, intensity);
+  else                                // off
+    ClearPixel(line, 2*mpx::WIDTH-1-lineStep);
+  ShowLeds();
+
+  lineStep = (lineStep + 1) % (2*mpx::WIDTH);
+  lineDue += dt;                      // keep the rhythm
+  if ((long)(now - lineDue) > 0)      // more than one pixel late
+    lineDue = now + dt;
 }
 
 //
@@ -543,136 +917,238 @@ void RandomColor()
 }
 
 //
-// MPX image with 224 color palette and animation
+// Newest record of the store becomes the guest motif, played in place. It is
+// pinned first, then checked to be still the newest: the UDP task reads the
+// pin before erasing, so it never erases the record drawn here.
 //
-void DrawMPX(char*  motif, int animidx)
+void TakeRecord()
 {
-int lipix = 0;
-int copix = 0;
-int idcolor;
-char data;
-int imgidx;
-int imagenb;
-int currimage = 0;
-
-  // palette initialization
-  palCol[0] = 0;     // pal0 = Black  0xEE
-  palCol[1] = 0;
-  palCol[2] = 0;
-  palCol[3] = 255;   // pal1 = White  0xFF
-  palCol[4] = 255;
-  palCol[5] = 255;
-
-  // byte 0 is number of colors after B&W
-  imgidx = (motif[0]*3) + 2;            // index of the first image byte
-  imagenb  = motif[1];                  // number of images in animation
-
-  for (int i=2; i < imgidx; i++)        // copy palette bytes to palCol array
-     palCol[i+4] = motif[i];
-
-  while (currimage < animidx%imagenb)   // go to requested animidx image
+  uint32_t latest = storeLatest.load();
+  mpxstore::Record rec;
+
+  for (;;)
   {
-    while ((data = motif[imgidx]) != 0) // jumps over images
-    { imgidx++;
-    }
-    currimage++;
-    imgidx++;
+    storePinned.store(latest);
+    uint32_t again = storeLatest.load();
+    if (again == latest)
+      break;
+    latest = again;
   }
-
-  //Serial.print("   currimage: ");
-  //Serial.println(currimage);
-  tempoAnim = motif[imgidx];            // first image byte is tempo information
-  imgidx++;
-  
-  while ((data = motif[imgidx]) != 0)   // read pixels data
+  takenRecord = latest;
+  if (store.recordAt(latest, rec))
   {
-    if (data >= 0x20)     // color code
+    guestMotif = (const char*)store.data(rec);
+    guestSize = rec.length;
+  }
+  indexedMotif = rejectedMotif = NULL;   // validate it, may be at the same place
+}
+
+//
+// MPX image with 224 color palette and animation
+//
+void DrawMPX(const char* motif, int motifSz, int animidx)
+{
+const uint8_t* data = (const uint8_t*)motif;
+
+int frame;
+
+  if (motif != indexedMotif)
+  {                                             // new animation, checked once
+    if (motif == rejectedMotif)
+      return;
+    if (!mpx::validate(data, motifSz, anim))    // not a sound MPX
     {
-      idcolor = data - 0x20;
-      DoPixel(lipix,copix, palCol[idcolor*3], palCol[idcolor*3 + 1], palCol[idcolor*3 + 2], intensity);
-      copix++;
-      if (copix > 31)     // line done
-      { copix = 0;
-        lipix++;
-      }
+      Serial.println("MPX rejected");
+      rejectedMotif = motif;
+      indexedMotif = NULL;
+      return;
     }
-    else                  // RLE information
-    {
-      while (data > 0)
-      {
-        DoPixel(lipix,copix, palCol[idcolor*3], palCol[idcolor*3 + 1], palCol[idcolor*3 + 2], intensity);
-        copix++;
-        if (copix > 31)  // line done
-        { copix = 0;
-          lipix++;
-        }
-        data--;
-      }
+    mpx::readPalette(data, anim.hdr, palCol);   // B&W + MPX palette
+    tempoUnit = anim.hdr.tempoUs;
+    indexedMotif = motif;
+    cacheIntensity = -1;
+  }
+  if (intensity != cacheIntensity)
+  {
+    mpx::scalePalette(palCol, mpx::PAL_SIZE, intensity, palScaled);
+    for (int i = 0; i < FRAME_CACHE_IMAGES; i++)
+      cacheTempo[i] = -1;                       // empty cache
+    cacheIntensity = intensity;
+    ledsImage = -1;
+  }
+  frame = animidx%anim.idx.nbImages;
+
+  {
+    cyclestat::Scope stat(stats[STAT_DECODE]);
+    if (ledsImage != frame - 1 && (frame >= FRAME_CACHE_IMAGES || cacheTempo[frame] < 0))
+    {                                           // a delta image needs the previous one
+      for (int k = mpx::keyImage(data, anim.idx, frame); k < frame; k++)
+        RenderImage(data, k);
     }
-    imgidx++;
+    RenderImage(data, frame);
+  }
+  ShowLeds();
+}
+
+//
+// Image of the indexed animation into leds[], from the cache if decoded
+//
+void RenderImage(const uint8_t* data, int frame)
+{
+mpx::Image img;
+
+  ledsImage = frame;
+  if (frame < FRAME_CACHE_IMAGES && cacheTempo[frame] >= 0)
+  {                                             // already decoded
+    memcpy(leds, frameCache[frame], sizeof(leds));
+    tempoAnim = cacheTempo[frame];
+    return;
+  }
+
+  mpx::indexedImage(data, anim.idx, frame, img);
+  tempoAnim = img.tempo;                        // first image byte is tempo information
+
+  mpx::renderVerified(img, palScaled, leds);    // validated, a delta over leds[]
+
+  if (frame < FRAME_CACHE_IMAGES)               // keep it for the next loops
+  {
+    memcpy(frameCache[frame], leds, sizeof(leds));
+    cacheTempo[frame] = tempoAnim;
   }
-  FastLED.show();
 }
 
 //
 // Still Image automaton
 //
-void DisplayMPX(char* motif)
+void DisplayMPX(const char* motif, int motifSz)
 {
   if (imgdone == 0)
   {
     if (intensity <= MAX_INTENSITY)
-      DrawMPX(motif, 0);
+      DrawMPX(motif, motifSz, 0);
     else
-      DrawPalette(motif);
+      DrawPalette(motif, motifSz);
 
     imgdone = 1;
   }
 }
 
 //
-// Animation automaton
+// Drop the images of the validated animation whose tempo is over: the next
+// one drawn is on time. A whole loop late, the timeline starts again.
 //
-void AnimateMPX(char* motif)
+void SkipLateImages(const char* motif, unsigned long now)
 {
-  if (imgdone == 0)
+mpx::Image img;
+
+  if (motif != indexedMotif)
+    return;
+  for (int n = 0; n < anim.idx.nbImages; n++)
   {
-    if (intensity <= MAX_INTENSITY)
-      DrawMPX(motif, stepMotif++);
-    else
-      DrawPalette(motif);
+    mpx::indexedImage((const uint8_t*)motif, anim.idx, stepMotif%anim.idx.nbImages, img);
+    if (!pacer.skip(now, img.tempo*tempoUnit))
+      return;
+    stepMotif++;
+  }
+  pacer.restart(now);
+}
 
-    startSeq = millis();
-    imgdone = 1;
+//
+// Animation automaton, each image at its deadline
+//
+void AnimateMPX(const char* motif, int motifSz)
+{
+  unsigned long now = micros();
+
+  if (imgdone == 0)
+    pacer.restart(now);           // first image now
+  else if (!pacer.isDue(now))
+    return;
+
+  showStart = now;                // no show when the motif is rejected
+  if (intensity <= MAX_INTENSITY)
+  {
+    SkipLateImages(motif, now);
+    DrawMPX(motif, motifSz, stepMotif++);
   }
   else
+    DrawPalette(motif, motifSz);
+
+  pacer.shown(showStart, tempoAnim*tempoUnit);   // jitter without the show time
+  imgdone = 1;
+
+  if (millis() - frameReport > FRAME_REPORT_MS)
   {
-    if (millis() - startSeq > TEMPO_UNIT_MS*tempoAnim)
-      imgdone = 0;                // here we go again
+    const PacerStats& st = pacer.stats();
+    frameReport = millis();
+    Serial.printf("frames: shown %u, dropped %u, jitter %u/%u/%u us\n",
+                  st.shown, st.dropped, st.shown ? st.jitterMin : 0, st.jitterMean(),
+                  st.jitterMax);
+    pacer.resetStats();
+  }
+}
+
+//
+// Live stream: queued packets into the jitter buffer, frame when due
+//
+void PlayLive()
+{
+  size_t len;
+  unsigned long now = millis();
+
+  while (liveRing.pop(livePacket, len))
+  {
+    if (!live.active(now))          // new stream, new counters
+      live.reset();
+    live.onPacket(livePacket, len, now);
+  }
+
+  const uint8_t* rgb = live.frame(now);
+  if (rgb != NULL)
+  {
+    mpx::renderRgb(rgb, intensity, leds);
+    ShowLeds();
+  }
+
+  if (live.active(now) && now - liveReport > LIVE_REPORT_MS)
+  {
+    const mpxlive::Stats& st = live.stats();
+    liveReport = now;
+    Serial.printf("live: %u fps, shown %u, late %u, lost %u, overflow %u, delta miss %u\n",
+                  st.fps, st.shown, st.late, st.lost, st.overflow, st.deltaMiss);
+    Serial.printf("      latency %u/%u ms, jitter %u ms, queue full %u\n",
+                  st.shown ? st.latencySum / st.shown : 0, st.latencyMax, st.jitter,
+                  liveRing.rejected());
   }
 }
 
 //
 // Draw first 16 palette enties of MPX image
 //
-void DrawPalette(char*  motif)
+void DrawPalette(const char* motif, int motifSz)
 {
 int colpix = 0;
 int idcolor = 0;
+mpx::Header hdr;
 
+  if (!mpx::readHeader((const uint8_t*)motif, motifSz, hdr))
+    return;
+  ledsImage = -1;                                 // leds[] changed
   for (int ipal=0; ipal < 16; ipal++)
   {
     //Serial.print("palette : ");
     //Serial.println(ipal);
     colpix = ipal*2;
-    idcolor = ipal*3 + 8;   // skip header and B&W
+    idcolor = ipal*3 + hdr.palette + 6;   // skip header and B&W
+    if (idcolor + 2 >= motifSz)           // small palette, end of the MPX
+      break;
 
     DoPixel(0,colpix, motif[idcolor], motif[idcolor + 1], motif[idcolor + 2], 3);
     DoPixel(0,colpix+1, motif[idcolor], motif[idcolor + 1], motif[idcolor + 2], 3);
     DoPixel(1,colpix, motif[idcolor], motif[idcolor + 1], motif[idcolor + 2], 3);
     DoPixel(1,colpix+1, motif[idcolor], motif[idcolor + 1], motif[idcolor + 2], 3);
   }
-  FastLED.show();
+  ShowLeds();
 }
 
 
@@ -27,8 +27,15 @@
 // --> arg#1  bmp file prefix (aa for aa1.bmp, aa2.bmp...)
 // --> arg#2  number of bmp files to process
 // --> arg#3  common images tempo (if 0, will ask if no args#5) 
-// --> arg#4  output file is a C source ('C') or an MPX binary ('M')
+// --> arg#4  output file is a C source ('C') or an MPX binary ('M'), 'D' for
+//            an extended MPX binary when it is smaller, each image in its
+//            smallest coding (RLE, long runs, packed indices or delta)
+//            a second letter dithers the quantized images: 'O' ordered,
+//            'F' Floyd-Steinberg ("MO", "DF"...)
 // --> [arg#5+] images tempos (arg#3 must be 0, will ask if missing)
+// --> images over 222 colors together get one palette from quantize.h instead
+//     of an error, the error and time of each image are printed
+// --> prints the time spent reading, building the palette, encoding and writing
 //
 // T. JOUBERT
 // v0.1   03 Jul. 2023     ASCII and binaire
@@ -36,6 +43,11 @@
 // v1.2   23 Jul. 2023     Global tempo
 // v1.3   28 Jul. 2023     Refactoring
 // v1.4   18 Aug. 2023     Tempo values as args
+// v1.5   15 Oct. 2026     Palette and RLE from the mpx.h codec
+// v1.6   15 Oct. 2026     Hashed palette, stage timings, too many colors error
+// v1.7   15 Oct. 2026     Extended MPX with delta images ('D')
+// v1.8   15 Oct. 2026     Long runs and packed images in the extended MPX
+// v1.9   15 Oct. 2026     Quantization and dithering over 222 colors
 // 
 
 /*   ----CONTENT OF AN MPX FILE----
@@ -83,6 +95,16 @@
     |  0x00          |  /
     +----------------+
 
+    ----EXTENDED MPX ('D')----
+
+    0xE0 | flags, then the header and palette above. Each image is its tempo,
+    a coding byte (1 = RLE, 2 = delta, 3 = long runs, 4 = packed), the
+    payload size on 16 bits (little endian) and the payload, without 0x00.
+    A delta payload only draws the pixels that changed since the previous
+    image, long runs go across lines and up to 287 pixels, packed images
+    hold 1, 2 or 4 bits per pixel for images of 16 colors or less (see
+    mpx.h). Each image is written in its smallest coding.
+
 */
 
 #define _CRT_SECURE_NO_WARNINGS
@@ -96,31 +118,29 @@
 #include<math.h>
 #include "..\RGBconvert\EasyBMP.h"
 #include<windows.h>
+#include<chrono>
+#include "mpx.h"
+#include "quantize.h"
 
-#define VERSION "v1.4  2023-08-18"
+#define VERSION "v1.9  2026-10-15"
 
-//--------------------------------------------------------
-// STRUCTS
-//--------------------------------------------------------
-typedef struct
-{
-  unsigned char R;
-  unsigned char G;
-  unsigned char B;
-} RGBdec;
+typedef std::chrono::steady_clock Clock;
 
 //--------------------------------------------------------
 // FUNCTION PROTOTYPES
 //--------------------------------------------------------
 int filter_exception(LPEXCEPTION_POINTERS);
+double msSince(Clock::time_point start);
 
 // -----------
 // Data
 // -----------
-#define MAXCOLORS 230
-RGBdec allColors[MAXCOLORS];
+mpx::PaletteBuilder allColors;    // B&W + colors of all images
 
 bool asciiOut = false;            // ASCII or binary output
+bool deltaOut = false;            // extended MPX
+bool quantized = false;           // too many colors, one palette of the quantizer
+quant::Dither dither = quant::DITHER_NONE;
 
 //---------------------------------------------------------------------------------
 // Main
@@ -128,19 +148,21 @@ bool asciiOut = false;            // ASCII or binary output
 int main(int argc, char** argv)
 {
   BMP bmp;
-  RGBdec pixRGB;
   RGBApixel pix;
-  unsigned char* mapCol[10];
+  unsigned char** mapCol = NULL;        // color map of each image
+  unsigned char* rgbAll = NULL;         // pixels of all images, quantizer
   int nbFiles = 0;
   int idmap = 0;
-  unsigned char colCour;
-  int nbRepet;
   // binary output
   unsigned char buffer[2300];
   int  idb = 0;
+  bool classicFits = true;              // classic MPX within buffer
+  unsigned char image[2*mpx::PIXELS];   // one RLE image
+  unsigned char extBuffer[2300];        // extended MPX
+  int* imgTempos = NULL;                // tempo of each image
+  size_t lineEnd[mpx::HEIGHT];          // end of each line in image
+  size_t imgBytes;
   ////////////////
-  int  nbCol = 0;
-  int  nbLin = 0;
   int nbColors = 0;
   int totalBytes = 0;
 
@@ -155,22 +177,35 @@ int main(int argc, char** argv)
   unsigned char baseTempo = 30;
   int imgTempo;
 
+  Clock::time_point t0;               // stage timings in ms
+  double tRead = 0;
+  double tPalette = 0;
+  double tEncode = 0;
+  double tWrite = 0;
+
   if (argc < 5)
   {
     goto syntax;
   }
   try
   {
-    nbFiles = atoi(argv[2]);        // number of BMP, can't be zero
-    if (nbFiles == 0)
+    nbFiles = atoi(argv[2]);        // number of BMP, 1 to MAX_IMAGES
+    if (nbFiles <= 0 || nbFiles > mpx::MAX_IMAGES)
         goto syntax;
 
     if (argv[4][0] == 'C')          // argv[4] --> out to .c file else to .mpx
     {
       asciiOut = true;
     }
-    allColors[nbColors++] = { 0,0,0 };          // Black
-    allColors[nbColors++] = { 255, 255, 255 };  // White
+    deltaOut = argv[4][0] == 'D';
+    if (toupper(argv[4][1]) == 'O')    // dithering of the quantized images
+      dither = quant::DITHER_ORDERED;
+    else if (toupper(argv[4][1]) == 'F')
+      dither = quant::DITHER_DIFFUSION;
+    rgbAll = (unsigned char*)malloc((size_t)nbFiles * mpx::PIXELS * 3);
+    mapCol = (unsigned char**)calloc(nbFiles, sizeof(unsigned char*));
+    imgTempos = (int*)calloc(nbFiles, sizeof(int));
+    allColors.clear();                          // Black & White
 
     baseTempo = (unsigned char)atoi(argv[3]);   // Animation Tempo
 
@@ -193,10 +228,12 @@ int main(int argc, char** argv)
       _itoa(fileindex + 1, filenum, 10);
       strcat(infilename, filenum);
       strcat(infilename, ".bmp");
-      bmp.ReadFromFile(infilename);     // !!must be a 16x32 BMP image
+      t0 = Clock::now();
+      bmp.ReadFromFile(infilename);     // !!must be a mpx::HEIGHT x mpx::WIDTH BMP image
+      tRead += msSince(t0);
 
-      if (bmp.TellHeight() != 16 || bmp.TellWidth() != 32) {
-          printf("\n!!! %s is not a 16x32 image !!!\n", infilename);
+      if (bmp.TellHeight() != mpx::HEIGHT || bmp.TellWidth() != mpx::WIDTH) {
+          printf("\n!!! %s is not a %dx%d image !!!\n", infilename, mpx::HEIGHT, mpx::WIDTH);
           return 0;
       }
 
@@ -204,68 +241,77 @@ int main(int argc, char** argv)
       idmap = 0;      // re-init mapCol index
 
       ///////////////// collect colors and do the color map /////////////
+      t0 = Clock::now();
       for (int j = 0; j < bmp.TellHeight(); j++)
       {
         for (int i = 0; i < bmp.TellWidth(); i++)
         {
           pix = bmp.GetPixel(i, j);     // input pixel
-          pixRGB.R = pix.Red;
-          pixRGB.G = pix.Green;
-          pixRGB.B = pix.Blue;
+          unsigned char* rgb = rgbAll + 3 * ((size_t)fileindex * mpx::PIXELS + idmap);
+          rgb[0] = pix.Red;
+          rgb[1] = pix.Green;
+          rgb[2] = pix.Blue;
 
-          int idcolPx = -1;             // check existing color
-          for (int k = 0; k < nbColors; k++)
-          {
-            if (allColors[k].B == pixRGB.B &&
-              allColors[k].G == pixRGB.G &&
-              allColors[k].R == pixRGB.R)
-            {
-              idcolPx = k;
-              break;
-            }
-          }
-          if (-1 == idcolPx)            // unknown color in palette, add it
+          int idcolPx = quantized ? 0 : allColors.index(pix.Red, pix.Green, pix.Blue);  // known or added
+          if (-1 == idcolPx)            // palette is full, quantized after the last BMP
           {
-            allColors[nbColors] = pixRGB;
-            //printf("%d -  %3u, %3u, %3u \n",nbColors, pixRGB.R, pixRGB.G, pixRGB.B);
-            idcolPx = nbColors;
-            nbColors++;
+            printf("\n%s brings the MPX over %d colors, quantized\n", infilename, mpx::ENC_COLORS);
+            quantized = true;
           }
-          (mapCol[fileindex])[idmap++] = idcolPx + 0x20;  // image map
-          //printf("%02x, ", idcolPx + 0xEE);
+          (mapCol[fileindex])[idmap++] = idcolPx;   // image map
         }
       }
-      printf("%s ---> %d colors\n", infilename, nbColors);
+      tPalette += msSince(t0);
+      nbColors = allColors.size();
+      if (!quantized)
+        printf("%s ---> %d colors\n", infilename, nbColors);
       fileindex++;
     } // All BMP have been processed
 
+    ///////////////// one palette for all images when there are too many colors /////////
+    if (quantized)
+    {
+      quant::Quantizer quantizer;
+      unsigned char remap[quant::MAX_COLORS];
+
+      t0 = Clock::now();
+      quantizer.build(rgbAll, (size_t)nbFiles * mpx::PIXELS, mpx::ENC_COLORS);
+      allColors.clear();
+      for (int k = 0; k < quantizer.size(); k++)   // two colors may round the same
+        remap[k] = (unsigned char)allColors.index(quantizer.color(k).R, quantizer.color(k).G,
+                                                  quantizer.color(k).B);
+      nbColors = allColors.size();
+      printf("palette of %d colors in %.3f ms\n", nbColors - 2, msSince(t0));
+      tPalette += msSince(t0);
+      for (fileindex = 0; fileindex < nbFiles; fileindex++)
+      {
+        t0 = Clock::now();
+        quant::ImageError err = quantizer.map(rgbAll + (size_t)fileindex * mpx::PIXELS * 3,
+                                              mpx::WIDTH, mpx::HEIGHT, dither, mapCol[fileindex]);
+        for (int p = 0; p < mpx::PIXELS; p++)
+          mapCol[fileindex][p] = remap[mapCol[fileindex][p]];
+        double ms = msSince(t0);
+        tPalette += ms;
+        printf("image %d ---> error mean %.2f max %.2f, %.3f ms\n", fileindex + 1, err.mean, err.max, ms);
+      }
+    }
+    free(rgbAll);
+
     ///////////////// write the colors palette in output file /////////////// 
     printf("TOTAL %d colors in MPX\n", nbColors - 2);
+    t0 = Clock::now();
     if (asciiOut)
     {
       fprintf(fp, "                           \n%3d, ", nbColors - 2);   // nbcolors no B&W
       fprintf(fp, "%3d,\n", atoi(argv[2]));  // nb images
     }
-    else
-    {
-      buffer[idb++] = (unsigned char)nbColors - 2;
-      buffer[idb++] = (unsigned char)atoi(argv[2]);
-    }
     totalBytes += 2;
 
     for (int i = 2; i < nbColors; i++)
     {
       if (asciiOut)
       {
-        fprintf(fp, "%3u, %3u, %3u, ", allColors[i].R, allColors[i].G, allColors[i].B);
-        //printf("%3u, %3u, %3u\n", allColors[i].R, allColors[i].G, allColors[i].B);
-      }
-      else
-      {
-        buffer[idb++] = allColors[i].R;
-        buffer[idb++] = allColors[i].G;
-        buffer[idb++] = allColors[i].B;
-        //printf("%02X, %02X, %02X\n", allColors[i].R, allColors[i].G, allColors[i].B);
+        fprintf(fp, "%3u, %3u, %3u, ", allColors.color(i).R, allColors.color(i).G, allColors.color(i).B);
       }
       totalBytes += 3;
       coline += 3;
@@ -282,6 +328,20 @@ int main(int argc, char** argv)
     {
       fprintf(fp, "\n");
     }
+    else
+    {
+      idb = (int)mpx::encodeHeader(buffer, sizeof(buffer), allColors, nbFiles);
+      if (idb == 0)
+      {
+        classicFits = false;
+        if (!deltaOut)                // the extended MPX may still fit
+        {
+          printf("\n!!! MPX is bigger than %d bytes !!!\n", (int)sizeof(buffer));
+          return 0;
+        }
+      }
+    }
+    tWrite += msSince(t0);
 
     ///////////////// write the images maps in output file ///////////////////
     fileindex = 0;                     // Re-init to process 
@@ -302,99 +362,30 @@ int main(int argc, char** argv)
         imgTempo = baseTempo;
       }
       printf("image %d - Tempo %d\n", fileindex + 1, imgTempo);
-      if (asciiOut)
-      {
-        fprintf(fp, " %3d,\n", imgTempo);  // given tempo
-        //printf("0x%02X, ", mapCol[fileindex][idmap]);
-      }
-      else
-      {
-        buffer[idb++] = (unsigned char)imgTempo;
-      }
-      totalBytes++;
+      imgTempos[fileindex] = imgTempo;
 
       // RLE compression of the image color map
-      idmap = 0;
-      colCour = 0;
-      nbRepet = 0;
-      for (int j = 0; j < bmp.TellHeight(); j++)
+      t0 = Clock::now();
+      imgBytes = mpx::encodeImage(image, sizeof(image), mapCol[fileindex], imgTempo, lineEnd);
+      tEncode += msSince(t0);
+
+      t0 = Clock::now();
+      if (asciiOut)
       {
-        for (int i = 0; i < bmp.TellWidth(); i++)
+        fprintf(fp, " %3d,\n", imgTempo);  // given tempo
+        size_t k = 1;
+        for (int j = 0; j < mpx::HEIGHT; j++)
         {
-
-          if (colCour == 0)           // initialization
+          for (; k < lineEnd[j]; k++)
           {
-            if (asciiOut)
-            {
-              fprintf(fp, "0x%02X, ", mapCol[fileindex][idmap]);
-              //printf("0x%02X, ", mapCol[fileindex][idmap]);
-            }
+            if (k + 1 == lineEnd[j] && image[k] < mpx::CODE_BASE)
+              fprintf(fp, "0x%02x, ", image[k]);    // RLE information at end of line
             else
-            {
-              buffer[idb++] = mapCol[fileindex][idmap];
-            }
-            totalBytes++;
-            colCour = mapCol[fileindex][idmap];
-            nbRepet = 0;
-          }
-          else                        // inside map
-          {
-            if (mapCol[fileindex][idmap] == colCour)  // same index
-            {
-              nbRepet++;
-            }
-            else                      // new color index
-            {
-              if (nbRepet > 0)        // write RLE byte
-              {
-                if (asciiOut)
-                {
-                  fprintf(fp, "0x%02X, ", nbRepet);
-                }
-                else
-                {
-                  buffer[idb++] = nbRepet;
-                }
-                totalBytes++;
-              }
-              if (asciiOut)           // write new color index
-              {
-                fprintf(fp, "0x%02X, ", mapCol[fileindex][idmap]);
-              }
-              else
-              {
-                buffer[idb++] = mapCol[fileindex][idmap];
-              }
-              totalBytes++;
-              colCour = mapCol[fileindex][idmap];
-              nbRepet = 0;
-            }
-          }
-          idmap++;                    // next pixel in the mapcolor
-        }
-
-        if (nbRepet > 0)              // End of a pixel line, write RLE information 
-        {
-          if (asciiOut)
-          {
-            fprintf(fp, "0x%02x, ", nbRepet);
-          }
-          else
-          {
-            buffer[idb++] = nbRepet;
+              fprintf(fp, "0x%02X, ", image[k]);
           }
-          totalBytes++;
-          colCour = 0;
+          fprintf(fp, "\n");            // newline in the source file
         }
-        if (asciiOut)                 // newline in the source file
-        {
-          fprintf(fp, "\n");
-        }
-      }
-
-      if (asciiOut)                   // End of image = 0x00
-      {
-        if (fileindex + 1 < atoi(argv[2]))  // check last image
+        if (fileindex + 1 < atoi(argv[2]))  // End of image = 0x00, check last image
         {
           fprintf(fp, "0x00,\n");
         }
@@ -405,13 +396,65 @@ int main(int argc, char** argv)
       }
       else
       {
-        buffer[idb++] = 0;
+        if (classicFits && idb + imgBytes > sizeof(buffer))
+        {
+          classicFits = false;
+          if (!deltaOut)              // the extended MPX may still fit
+          {
+            printf("\n!!! MPX is bigger than %d bytes !!!\n", (int)sizeof(buffer));
+            return 0;
+          }
+        }
+        if (classicFits)              // else only its size is counted
+          memcpy(buffer + idb, image, imgBytes);
+        idb += (int)imgBytes;
       }
-      totalBytes++;
-      free(mapCol[fileindex]);        // clean Heap
+      tWrite += msSince(t0);
+      totalBytes += (int)imgBytes;
       fileindex++;
     }
 
+    ///////////////// extended MPX, images in their smallest coding ///////////
+    if (deltaOut)
+    {
+      int extBytes = 0;
+      int nbDelta = 0;
+
+      t0 = Clock::now();
+      size_t nb = mpx::encodeExtHeader(extBuffer, sizeof(extBuffer), allColors, nbFiles,
+                                       mpx::FLAG_DELTA);
+      for (fileindex = 0; fileindex < nbFiles && nb > 0; fileindex++)
+      {
+        extBytes += (int)nb;
+        nb = mpx::encodeExtImage(extBuffer + extBytes, sizeof(extBuffer) - extBytes,
+                                 mapCol[fileindex], fileindex > 0 ? mapCol[fileindex - 1] : NULL,
+                                 imgTempos[fileindex]);
+        if (nb > 0 && extBuffer[extBytes + 1] == mpx::CODING_DELTA)
+          nbDelta++;
+      }
+      extBytes += (int)nb;
+      tEncode += msSince(t0);
+
+      if (nb > 0 && (extBytes < totalBytes || !classicFits))
+      {
+        printf("%d delta images, %d bytes instead of %d\n", nbDelta, extBytes, totalBytes);
+        memcpy(buffer, extBuffer, extBytes);
+        totalBytes = extBytes;
+      }
+      else if (!classicFits)          // neither coding fits
+      {
+        printf("\n!!! MPX is bigger than %d bytes, extended MPX too !!!\n", (int)sizeof(buffer));
+        return 0;
+      }
+      else
+        printf("no gain with the extended MPX, classic MPX\n");
+    }
+    for (fileindex = 0; fileindex < nbFiles; fileindex++)
+      free(mapCol[fileindex]);        // clean Heap
+    free(mapCol);
+    free(imgTempos);
+
+    t0 = Clock::now();
     if (asciiOut)                     // write array size in source file
     {
       fseek(fp, 0, SEEK_SET);
@@ -422,9 +465,12 @@ int main(int argc, char** argv)
       fwrite(buffer, totalBytes, 1, fp);
       //printf("totalBytes = %d   idb = %d\n", totalBytes + 1, idb);
     }
+    tWrite += msSince(t0);
     printf("\n+------------------------------------+\n");
     printf("| %4d bytes in %20s |\n", totalBytes, outfilename);
     printf("+------------------------------------+\n");
+    printf("read %.3f ms, palette %.3f ms, encode %.3f ms, write %.3f ms\n",
+           tRead, tPalette, tEncode, tWrite);
 
     fclose(fp);
   }
@@ -436,12 +482,26 @@ int main(int argc, char** argv)
 
 syntax:
   printf("Version %s\n\n", VERSION);
-  printf("Syntaxe %s bmp_name_prefix number_of_bmp tempo_or_0 C_or_M [tempo_values]\n", argv[0]);
+  printf("Syntaxe %s bmp_name_prefix number_of_bmp tempo_or_0 C_or_M_or_D [tempo_values]\n", argv[0]);
+  printf("    a second letter O or F dithers the images over %d colors (ordered, Floyd-Steinberg)\n",
+         mpx::ENC_COLORS);
   printf("    ex: %s aa 3 30 M\n", argv[0]);
   printf("        Will export aa1.bmp aa2.bmp aa3.bmp in aa.mpx with tempo 30\n");
   printf("    ex: %s bb 2 0 C\n", argv[0]);
   printf("        Will export bb1.bmp bb2.bmp in bb.c asking for tempos\n");
   printf("    ex: %s z 2 0 M 10 100\n", argv[0]);
   printf("        Will export z1.bmp z2.bmp in z.mpx with tempos 10 and 100\n");
+  printf("    ex: %s cc 8 5 D\n", argv[0]);
+  printf("        Will export cc1.bmp to cc8.bmp in cc.mpx, images in their smallest coding\n");
+  printf("    ex: %s photo 4 20 DF\n", argv[0]);
+  printf("        Same with Floyd-Steinberg dithering if the images are over %d colors\n", mpx::ENC_COLORS);
   return 0;
 }
+
+//---------------------------------------------------------------------------------
+// Milliseconds elapsed since start
+//---------------------------------------------------------------------------------
+double msSince(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
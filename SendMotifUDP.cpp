@@ -24,112 +24,231 @@
 // SendMotifUDP.cpp 
 //
 // 1. Send an MPX binary file to the sky
-// --> UDP transfer
-// --> Max size is 2300 bytes
+// --> UDP transfer, chunked upload of mpxudp.h: no size limit on this side,
+//     missing chunks are sent again, the device checks the CRC32
+// --> -raw sends the former one or two packets (firmware before v2.3)
+// --> builds with Winsock on Windows, BSD sockets on Linux
 //
 // T. JOUBERT
 // v1.0   28 Jun. 2023     UDP socket
 // v1.1   24 Jul. 2023     Multi packets
+// v1.2   15 Oct. 2026     Chunked upload with ACK/NACK, Linux build
 // 
 
 #define _CRT_SECURE_NO_WARNINGS
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "mpxudp.h"
+
+#ifdef _WIN32
 #include <winsock2.h>
 #include <ws2tcpip.h>
 
 #pragma comment(lib, "ws2_32.lib")
+#else
+#include <errno.h>
+#include <unistd.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+typedef int SOCKET;
+#define INVALID_SOCKET      (-1)
+#define SOCKET_ERROR        (-1)
+#define closesocket         close
+#define WSAGetLastError()   errno
+#define Sleep(ms)           usleep((ms) * 1000)
+#endif
 
 #define SERVER_IP "10.1.1.1"
 #define SERVER_PORT 2023
-#define MAX_BUF     2300 // biggest MPX accepted by MegaPix firmware
+#define MAX_RAW     2300 // biggest MPX accepted by the -raw firmware
 #define UDP_MTU     1470 // UDP maximum transfer = 1472 
+#define WINDOW      4    // chunks between two queries
+#define TIMEOUT_MS  200  // device answer
+
+#define VERSION "v1.2  2026-10-15"
 
-#define VERSION "v1.1  2023-07-24"
+//
+// mpxudp::upload() link over the UDP socket
+//
+struct UdpLink
+{
+    SOCKET sock;
+    struct sockaddr_in addr;
+
+    bool send(const uint8_t* data, size_t len)
+    {
+        return sendto(sock, (const char*)data, (int)len, 0, (struct sockaddr*)&addr, sizeof(addr)) != SOCKET_ERROR;
+    }
 
-char buffer[MAX_BUF] = { 0 };
+    int recv(uint8_t* data, size_t size, int timeoutMs)
+    {
+        fd_set readable;
+        struct timeval tv;
+
+        FD_ZERO(&readable);
+        FD_SET(sock, &readable);
+        tv.tv_sec = timeoutMs / 1000;
+        tv.tv_usec = (timeoutMs % 1000) * 1000;
+        if (select((int)sock + 1, &readable, NULL, NULL, &tv) <= 0)
+            return 0;
+        return (int)recvfrom(sock, (char*)data, (int)size, 0, NULL, NULL);
+    }
+};
+
+//
+// Former protocol: one packet, or two packets 500 ms apart
+//
+static int sendRaw(UdpLink& link, const char* buffer, size_t result)
+{
+    if (result > MAX_RAW)
+    {
+        printf("!!%zd bytes, too big - limit is %d bytes!!\n", result, MAX_RAW);
+        return 1;
+    }
+    if (result > UDP_MTU)                   // cut the buffer if bigger than UDP_MTU
+    {
+        printf("Sending %d bytes\n", UDP_MTU);
+        if (!link.send((const uint8_t*)buffer, UDP_MTU)) {
+            printf("!!Socket Erreur : %d!!\n", WSAGetLastError());
+        }
+        Sleep(500);
+        printf("Sending %zd bytes\n", result - UDP_MTU);
+        if (!link.send((const uint8_t*)buffer + UDP_MTU, result - UDP_MTU)) {
+            printf("!!Socket Erreur : %d!!\n", WSAGetLastError());
+        }
+    }
+    else
+    {
+        printf("Sending %zd bytes\n", result);
+        if (!link.send((const uint8_t*)buffer, result)) {
+            printf("Échec de l'envoi du message. Erreur : %d\n", WSAGetLastError());
+        }
+    }
+    return 0;
+}
 
 int main(int argc, char** argv)
 {
+#ifdef _WIN32
     WSADATA wsaData;
-    SOCKET clientSocket;
-    struct sockaddr_in serverAddress;
+#endif
+    UdpLink link;
+    const char* fileName = NULL;
+    const char* serverIp = SERVER_IP;
+    int serverPort = SERVER_PORT;
+    bool raw = false;
+    int nbArgs = 0;
 
     long file_size;
     size_t result;
+    char* buffer;
     FILE* fp;
 
-    if (argc < 2)
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-raw") == 0)
+            raw = true;
+        else if (nbArgs == 0)
+            fileName = argv[i], nbArgs++;
+        else if (nbArgs == 1)
+            serverIp = argv[i], nbArgs++;
+        else
+            serverPort = atoi(argv[i]);
+    }
+    if (fileName == NULL)
     {
         printf("Version: %s \n\n", VERSION);
-        printf("syntaxe: %s fichier_MPX_binaire\n", argv[0]);
+        printf("syntaxe: %s [-raw] fichier_MPX_binaire [IP [port]]\n", argv[0]);
         printf("     ex: %s snoopy.mpx\n", argv[0]);
+        printf("     ex: %s snoopy.mpx 127.0.0.1 2023\n", argv[0]);
         return 1;
     }
-    
+
+#ifdef _WIN32
     if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) { // Winsock Init
         printf("Échec de l'initialisation de Winsock. Erreur : %d\n", WSAGetLastError());
         return 1;
     }
+#endif
 
-    clientSocket = socket(AF_INET, SOCK_DGRAM, 0);  // UDP socket
-    if (clientSocket == INVALID_SOCKET) {
+    link.sock = socket(AF_INET, SOCK_DGRAM, 0);  // UDP socket
+    if (link.sock == INVALID_SOCKET) {
         printf("Échec de la création du socket. Erreur : %d\n", WSAGetLastError());
-        WSACleanup();
         return 1;
     }
 
-    serverAddress.sin_family = AF_INET;     // Server address
-    serverAddress.sin_port = htons(SERVER_PORT);
-    if (inet_pton(AF_INET, SERVER_IP, &(serverAddress.sin_addr)) <= 0) {
-        printf("Server IP:%s is invalid.\n", SERVER_IP);
-        closesocket(clientSocket);
-        WSACleanup();
+    memset(&link.addr, 0, sizeof(link.addr));
+    link.addr.sin_family = AF_INET;     // Server address
+    link.addr.sin_port = htons((unsigned short)serverPort);
+    if (inet_pton(AF_INET, serverIp, &(link.addr.sin_addr)) <= 0) {
+        printf("Server IP:%s is invalid.\n", serverIp);
+        closesocket(link.sock);
         return 1;
     }
 
-    fp = fopen(argv[1], "rb");
+    fp = fopen(fileName, "rb");
+    if (fp == NULL) {
+        printf("!!cannot open %s!!\n", fileName);
+        return 1;
+    }
 
     fseek(fp, 0, SEEK_END);                 // get file size
     file_size = ftell(fp);
     rewind(fp);
-    if (file_size > MAX_BUF)
-    {
-        printf("!!file %s is %ld bytes, too big - limit is %d bytes!!\n", argv[1],file_size, MAX_BUF);
-        return 1;
-    }
+    buffer = (char*)malloc(file_size > 0 ? file_size : 1);
     result = fread(buffer, sizeof(char), file_size, fp); // read file bytes
 
-    if (result != file_size) {
-        printf("!!fread %s error!!\n", argv[1]);
+    if (result != (size_t)file_size) {
+        printf("!!fread %s error!!\n", fileName);
         return 1;
     }
 
     fclose(fp);
-    printf("Got %zd bytes from %s\n", result, argv[1]);
+    printf("Got %zd bytes from %s\n", result, fileName);
 
-    if (result > UDP_MTU)                   // cut the buffer if bigger than UDP_MTU
-    {
-        printf("Sending %ld bytes\n", UDP_MTU);
-        if (sendto(clientSocket, buffer, UDP_MTU, 0, (struct sockaddr*)&serverAddress, sizeof(serverAddress)) == SOCKET_ERROR) {
-            printf("!!Socket Erreur : %d!!\n", WSAGetLastError());
-        }
-        Sleep(500);
-        printf("Sending %zd bytes\n", result - UDP_MTU);
-        if (sendto(clientSocket, buffer+UDP_MTU, (int)(result-UDP_MTU), 0, (struct sockaddr*)&serverAddress, sizeof(serverAddress)) == SOCKET_ERROR) {
-            printf("!!Socket Erreur : %d!!\n", WSAGetLastError());
-        } 
-    }
+    int status = 0;
+    if (raw)
+        status = sendRaw(link, buffer, result);
     else
     {
-        printf("Sending %zd bytes\n", result);
-        if (sendto(clientSocket, buffer, (int)result, 0, (struct sockaddr*)&serverAddress, sizeof(serverAddress)) == SOCKET_ERROR) {
-            printf("Échec de l'envoi du message. Erreur : %d\n", WSAGetLastError());
+        mpxudp::Stats stats;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        uint16_t session = (uint16_t)(start.time_since_epoch().count() ^ (start.time_since_epoch().count() >> 16));
+
+        status = mpxudp::upload(link, (const uint8_t*)buffer, result, session, WINDOW, TIMEOUT_MS, stats);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        switch (status)
+        {
+        case mpxudp::OK:
+            printf("Sent %zd bytes in %d chunks, %.1f ms, %.1f KB/s\n", result,
+                   mpxudp::chunkCount(result), ms, result / ms);
+            break;
+        case mpxudp::TOO_BIG:
+            printf("!!file %s is %zd bytes, too big for the device!!\n", fileName, result);
+            break;
+        case mpxudp::CRC_ERROR:
+            printf("!!CRC error, upload abandoned!!\n");
+            break;
+        default:
+            printf("!!no answer from %s:%d!!\n", serverIp, serverPort);
+            break;
         }
+        printf("%d packets, %d sent again, %d queries, %d timeouts\n", stats.packets,
+               stats.resent, stats.queries, stats.timeouts);
     }
 
-    closesocket(clientSocket);                 // Cleanup
+    free(buffer);
+    closesocket(link.sock);                 // Cleanup
+#ifdef _WIN32
     WSACleanup();
+#endif
 
-    return 0;
+    return status == 0 ? 0 : 1;
 }
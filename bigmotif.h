@@ -0,0 +1,230 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// bigmotif.h
+//
+// 1. Packed motifs of BigPix, read from the flash (PROGMEM)
+// --> mono frame: 2 bits per pixel (intensity 0..3), four pixels per byte,
+//     MONO_BYTES bytes in the order of the pixels along the strip
+// --> multi frame: the 8 RGB colors of the palette (PALETTE_BYTES) then the
+//     runs of pixels along the strip, one byte each: intensity - 1 on bits
+//     7-6, color on bits 5-3, length - 1 on bits 2-0
+// --> scrolling motif: one column after the other, COLUMN_BYTES bytes each,
+//     line l on bits 2l+1..2l (intensity 0..3)
+// --> font: one byte per column of the glyphs, line l of the glyph on bit l
+// --> Scroller: the scrolling sequences as a view sliding over a strip of
+//     columns (a packed motif in flash or a text rasterized in RAM), a step
+//     adds one column without moving the frame buffer
+// --> drawMono() and drawMulti() write the LED array directly, a pixel is
+//     LEDS_PER_PIXEL LEDs: intensity 1 = middle LED, 2 = outer LEDs,
+//     3 = all of them
+// --> the packed arrays are generated from the readable motifs
+//     (motifsBIG.h) by bigpack, which also checks that they render the
+//     same LEDs as the old char arrays
+// --> plain C++11, the LED type only needs a (r, g, b) constructor
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     2-bit frames, runs, column packed scrolling and font
+// v1.1   15 Oct. 2026     Scroller: viewport over a ring of columns
+//
+
+#ifndef BIGMOTIF_H
+#define BIGMOTIF_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ledmap.h"
+
+#ifndef PROGMEM                   // host tools
+#define PROGMEM
+#endif
+#ifndef pgm_read_byte
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#endif
+
+namespace bigmotif
+{
+
+typedef ledmap::Layout<11, 8, ledmap::SERPENTINE, 3> Layout;   // 8 lines of 11 pixels, 3 LEDs each
+
+const int MONO_BYTES    = (Layout::PIXELS + 3) / 4;     // 22
+const int PALETTE_BYTES = 8 * 3;                        // color 0 is black
+const int MAX_RUN       = 8;
+const int COLUMN_BYTES  = (Layout::HEIGHT + 3) / 4;     // 2
+const int FONT_LINES    = 5;
+
+//
+// Pixel of the strip (pointed by led) at intensity 0..3 of color on
+//
+template <class LED>
+inline void setPixel(LED* led, const LED& on, int intensity)
+{
+  const LED off(0, 0, 0);
+
+  led[0] = intensity >= 2 ? on : off;
+  led[1] = intensity & 1 ? on : off;
+  led[2] = intensity >= 2 ? on : off;
+}
+
+//
+// Mono frame in color (r, g, b)
+//
+template <class LED>
+void drawMono(LED* leds, const uint8_t* frame, uint8_t r, uint8_t g, uint8_t b)
+{
+  const LED on(r, g, b);
+  uint8_t bits = 0;
+
+  for (int pixel = 0; pixel < Layout::PIXELS; pixel++)
+  {
+    if (pixel % 4 == 0)
+      bits = pgm_read_byte(frame + pixel / 4);
+    setPixel(leds + pixel * Layout::LEDS_PER_PIXEL, on, bits & 3);
+    bits >>= 2;
+  }
+}
+
+//
+// Multi frame, its runs stop at the end of the strip
+//
+template <class LED>
+void drawMulti(LED* leds, const uint8_t* motif)
+{
+  const uint8_t* run = motif + PALETTE_BYTES;
+  int pixel = 0;
+
+  while (pixel < Layout::PIXELS)
+  {
+    uint8_t code = pgm_read_byte(run++);
+    const uint8_t* rgb = motif + 3 * ((code >> 3) & 7);
+    const LED on(pgm_read_byte(rgb), pgm_read_byte(rgb + 1), pgm_read_byte(rgb + 2));
+    int end = pixel + (code & 7) + 1;
+
+    if (end > Layout::PIXELS)
+      end = Layout::PIXELS;
+    for (; pixel < end; pixel++)
+      setPixel(leds + pixel * Layout::LEDS_PER_PIXEL, on, (code >> 6) + 1);
+  }
+}
+
+//
+// Intensity of (column, line) of a scrolling motif
+//
+inline uint8_t scrollPixel(const uint8_t* motif, int column, int line)
+{
+  return (pgm_read_byte(motif + column * COLUMN_BYTES + line / 4) >> (2 * (line % 4))) & 3;
+}
+
+//
+// Pixel (column, line) of the font, column counted from the first glyph
+//
+inline uint8_t fontPixel(const uint8_t* font, int column, int line)
+{
+  return (pgm_read_byte(font + column) >> line) & 1;
+}
+
+//
+// View of W columns sliding over a strip of columns read as a ring: a step
+// brings in the next column on the right (leftwards) or on the left, the
+// columns already brought in are read from the strip at the age of their
+// place in the view. The lines [first, last) scroll, the other lines and the
+// places no column has reached yet show the frame buffer, moved by the number
+// of steps, the same pixels as shifting the frame buffer at every step
+//
+class Scroller
+{
+public:
+  Scroller() : strip(NULL), flash(false), length(1), first(0), last(0),
+               leftwards(true), newest(0), fill(0) {}
+
+  // strip of nbColumns columns: packed scrolling motif in flash, or one byte
+  // per column in RAM with line first + i on bit i
+  void start(const uint8_t* columns, bool inFlash, int nbColumns, int firstLine, int lastLine, bool toLeft)
+  {
+    strip = columns;
+    flash = inFlash;
+    length = nbColumns > 0 ? nbColumns : 1;
+    first = firstLine;
+    last = lastLine;
+    leftwards = toLeft;
+    newest = 0;
+    fill = 0;
+  }
+
+  bool showing(const uint8_t* columns, bool toLeft) const { return strip == columns && leftwards == toLeft; }
+
+  void stop() { strip = NULL; fill = 0; }
+
+  // column of the strip brought in by this step
+  void step(int column)
+  {
+    newest = column;
+    if (fill < Layout::WIDTH)
+      fill++;
+  }
+
+  // intensity of a pixel, fb = frame buffer line by line
+  uint8_t pixel(const char* fb, int line, int col) const
+  {
+    if (strip == NULL || line < first || line >= last)
+      return fb[line * Layout::WIDTH + col];
+
+    int age = leftwards ? Layout::WIDTH - 1 - col : col;
+    if (age >= fill)
+      return fb[line * Layout::WIDTH + (leftwards ? col + fill : col - fill)];
+
+    int column = ((newest - age) % length + length) % length;
+    if (flash)
+      return scrollPixel(strip, column, line - first);
+    return (strip[column] >> (line - first)) & 1;
+  }
+
+  // writes the view into the frame buffer and stops, for the sequences that
+  // work on the frame buffer itself
+  void flatten(char* fb)
+  {
+    if (strip == NULL)
+      return;
+    for (int line = first; line < last; line++)
+      for (int i = 0; i < Layout::WIDTH; i++)
+      {
+        int col = leftwards ? i : Layout::WIDTH - 1 - i;    // read before written
+        fb[line * Layout::WIDTH + col] = (char)pixel(fb, line, col);
+      }
+    stop();
+  }
+
+private:
+  const uint8_t* strip;
+  bool flash;
+  int  length;
+  int  first;
+  int  last;
+  bool leftwards;
+  int  newest;            // column of the last step
+  int  fill;              // steps since start, up to WIDTH
+};
+
+} // namespace bigmotif
+
+#endif // BIGMOTIF_H
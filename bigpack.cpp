@@ -0,0 +1,590 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// bigpack.cpp
+//
+// 1. Packer of the BigPix motifs (bigmotif.h)
+// --> packs the readable motifs of motifsBIG.h: mono frames on 2 bits per
+//     pixel, multi frames in runs, scrolling motifs and the font by columns
+// --> -o writes the PROGMEM arrays included by BigPix.ino (motifsBIG_P.h)
+// --> -check renders every motif of the motifsBIG_P.h compiled in with the
+//     decoders of bigmotif.h and with the char array code of BigPix v2.6
+//     (DrawMono, DrawMulti, DrawScroll, DrawText), the LEDs must be the same
+//     at every step; it also fails when motifsBIG_P.h is older than
+//     motifsBIG.h
+// --> -check also scrolls random strips over random frame buffers with the
+//     Scroller view and with the shifted frame buffer of v2.7, both ways
+//
+// usage: bigpack [-o motifsBIG_P.h] [-check]
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     2-bit frames, runs, columns, pixel-identical check
+// v1.1   15 Oct. 2026     Scroller check
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "bigmotif.h"
+#include "motifsBIG.h"
+#define BIGMOTIF_INDEX
+#include "motifsBIG_P.h"
+
+#define VERSION "v1.1  2026-10-15"
+
+typedef bigmotif::Layout Layout;
+typedef std::vector<uint8_t> Bytes;
+
+struct Rgb
+{
+  uint8_t r, g, b;
+
+  Rgb() : r(0), g(0), b(0) {}
+  Rgb(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+};
+
+typedef Rgb Leds[Layout::LEDS];
+
+struct Packed
+{
+  std::string name;
+  const char* comment;
+  Bytes       data;
+};
+
+//
+// ---- packing of motifsBIG.h ----
+//
+
+static bool packMono(const char* motif, Bytes& out)
+{
+  out.assign(bigmotif::MONO_BYTES, 0);
+  for (int pixel = 0; pixel < Layout::PIXELS; pixel++)
+  {
+    uint8_t v = (uint8_t)motif[Layout::position(pixel)];
+    if (v > 3)
+      return false;
+    out[pixel / 4] |= (uint8_t)(v << (2 * (pixel % 4)));
+  }
+  return true;
+}
+
+static bool packMulti(const char* motif, Bytes& out)
+{
+  out.assign(motif, motif + bigmotif::PALETTE_BYTES);
+  for (int pixel = 0; pixel < Layout::PIXELS; )
+  {
+    uint8_t code = (uint8_t)motif[bigmotif::PALETTE_BYTES + Layout::position(pixel)];
+    int level = code > 19 ? 2 : code > 9 ? 1 : 0;
+    int color = code - 10 * level;
+    if (color > 7)
+      return false;
+
+    int run = 1;
+    while (run < bigmotif::MAX_RUN && pixel + run < Layout::PIXELS
+           && (uint8_t)motif[bigmotif::PALETTE_BYTES + Layout::position(pixel + run)] == code)
+      run++;
+    out.push_back((uint8_t)(level << 6 | color << 3 | (run - 1)));
+    pixel += run;
+  }
+  return true;
+}
+
+static bool packScroll(const char* motif, int width, Bytes& out)
+{
+  out.assign(width * bigmotif::COLUMN_BYTES, 0);
+  for (int col = 0; col < width; col++)
+    for (int lin = 0; lin < Layout::HEIGHT; lin++)
+    {
+      uint8_t v = (uint8_t)motif[lin * width + col];
+      if (v > 3)
+        return false;
+      out[col * bigmotif::COLUMN_BYTES + lin / 4] |= (uint8_t)(v << (2 * (lin % 4)));
+    }
+  return true;
+}
+
+// typo[] of v2.6: glyph after glyph, each one line after line
+static bool packFont(Bytes& widths, Bytes& first, Bytes& font)
+{
+  int column = 0;
+
+  widths.assign(bigsrc::typWdt, bigsrc::typWdt + bigsrc::MAXTYPO);
+  first.clear();
+  font.clear();
+  for (int g = 0; g < bigsrc::MAXTYPO; g++)
+  {
+    const char* glyph = bigsrc::typo + column * bigmotif::FONT_LINES;
+    int width = bigsrc::typWdt[g];
+    if (column > 255 || (column + width) * bigmotif::FONT_LINES > (int)sizeof(bigsrc::typo))
+      return false;
+    first.push_back((uint8_t)column);
+    for (int col = 0; col < width; col++, column++)
+    {
+      uint8_t bits = 0;
+      for (int lin = 0; lin < bigmotif::FONT_LINES; lin++)
+      {
+        uint8_t v = (uint8_t)glyph[lin * width + col];
+        if (v > 1)
+          return false;
+        bits |= (uint8_t)(v << lin);
+      }
+      font.push_back(bits);
+    }
+  }
+  return true;
+}
+
+static bool packAll(std::vector<Packed>& out)
+{
+  static const char* const comments[] = { "mono", "multi", "scroll" };
+
+  for (int i = 0; i < bigsrc::NB_MOTIFS; i++)
+  {
+    const bigsrc::Motif& m = bigsrc::motifs[i];
+    Packed p = { m.name, comments[m.type], Bytes() };
+    bool ok = m.type == bigsrc::MONO  ? packMono(m.data, p.data)
+            : m.type == bigsrc::MULTI ? packMulti(m.data, p.data)
+            :                           packScroll(m.data, m.width, p.data);
+    if (!ok)
+    {
+      printf("!!! %s: value out of the %s format !!!\n", m.name, p.comment);
+      return false;
+    }
+    out.push_back(p);
+  }
+
+  Packed widths = { "typWdt", "glyph widths", Bytes() };
+  Packed first  = { "typIdx", "first column of the glyphs", Bytes() };
+  Packed font   = { "typo", "font, one byte per column", Bytes() };
+  if (!packFont(widths.data, first.data, font.data))
+  {
+    printf("!!! typo: value out of the font format !!!\n");
+    return false;
+  }
+  out.push_back(widths);
+  out.push_back(first);
+  out.push_back(font);
+  return true;
+}
+
+static bool writeHeader(const char* path, const std::vector<Packed>& packed)
+{
+  FILE* f = fopen(path, "w");
+  if (f == NULL)
+    return false;
+
+  // license of the sources
+  static const char* const license =
+    "/*\n"
+    "  ---------------------------------- license ------------------------------------\n"
+    "  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.\n"
+    "\n"
+    "  Permission is hereby granted, free of charge, to any person obtaining a copy of\n"
+    "  this software and associated documentation files (the \"Software\"), to deal in\n"
+    "  the Software without restriction, including without limitation the rights to\n"
+    "  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of\n"
+    "  the Software, and to permit persons to whom the Software is furnished to do so,\n"
+    "  subject to the following conditions:\n"
+    "\n"
+    "  The above copyright notice and this permission notice shall be included in all\n"
+    "  copies or substantial portions of the Software.\n"
+    "\n"
+    "  THE SOFTWARE IS PROVIDED \"AS IS\", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR\n"
+    "  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS\n"
+    "  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR\n"
+    "  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER\n"
+    "  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN\n"
+    "  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.\n"
+    "  -------------------------------------------------------------------------------\n"
+    "*/\n";
+
+  fprintf(f, "%s\n", license);
+  fprintf(f, "// motifsBIG_P.h\n"
+             "//\n"
+             "// 1. Packed motifs of BigPix (bigmotif.h), in the flash\n"
+             "// --> generated by bigpack %s from motifsBIG.h, do not edit\n"
+             "//\n\n"
+             "#ifndef MOTIFSBIG_P_H\n"
+             "#define MOTIFSBIG_P_H\n\n"
+             "#include \"bigmotif.h\"\n", VERSION);
+
+  for (size_t i = 0; i < packed.size(); i++)
+  {
+    const Packed& p = packed[i];
+    fprintf(f, "\nconst uint8_t %s[%d] PROGMEM = {   // %s\n", p.name.c_str(), (int)p.data.size(), p.comment);
+    for (size_t j = 0; j < p.data.size(); j++)
+      fprintf(f, "%s0x%02X%s", j % 12 == 0 ? "  " : " ", p.data[j],
+              j + 1 == p.data.size() ? " };\n" : j % 12 == 11 ? ",\n" : ",");
+  }
+
+  fprintf(f, "\n#ifdef BIGMOTIF_INDEX   // bigpack -check\n"
+             "struct PackedMotif { const char* name; const uint8_t* data; int size; };\n\n"
+             "const PackedMotif packedMotifs[] = {\n");
+  for (size_t i = 0; i < packed.size(); i++)
+    fprintf(f, "  { \"%s\", %s, (int)sizeof(%s) }%s\n", packed[i].name.c_str(), packed[i].name.c_str(),
+            packed[i].name.c_str(), i + 1 == packed.size() ? " };" : ",");
+  fprintf(f, "#endif\n\n#endif // MOTIFSBIG_P_H\n");
+  return fclose(f) == 0;
+}
+
+//
+// ---- BigPix v2.6 rendering of the char arrays ----
+//
+
+static void refPixel(Rgb* leds, int pixel, const Rgb& c, int intensite)   // DoPixel
+{
+  Rgb* led = leds + Layout::LEDS_PER_PIXEL * pixel;
+  const Rgb off;
+
+  switch (intensite)
+  {
+  case 0:  led[0] = off; led[1] = off; led[2] = off; break;
+  case 2:  led[0] = c;   led[1] = off; led[2] = c;   break;
+  case 3:  led[0] = c;   led[1] = c;   led[2] = c;   break;
+  case 1:
+  default: led[0] = off; led[1] = c;   led[2] = off; break;
+  }
+}
+
+static void refMono(Rgb* leds, const char* motif, const Rgb& c)   // DrawMono
+{
+  for (int pixel = 0; pixel < Layout::PIXELS; pixel++)
+    refPixel(leds, pixel, c, (uint8_t)motif[Layout::position(pixel)]);
+}
+
+static void refMulti(Rgb* leds, const char* motif)                  // DrawMulti
+{
+  const uint8_t* m = (const uint8_t*)motif;
+
+  for (int pixel = 0; pixel < Layout::PIXELS; pixel++)
+  {
+    int idcolor = m[24 + Layout::position(pixel)];
+    int level = idcolor > 19 ? 3 : idcolor > 9 ? 2 : 1;
+    idcolor = 3 * (idcolor - 10 * (level - 1));
+    refPixel(leds, pixel, Rgb(m[idcolor], m[idcolor + 1], m[idcolor + 2]), level);
+  }
+}
+
+// frame buffer of the scrolling sequences: shifted left, new last column
+struct ScrollFB
+{
+  uint8_t fb[Layout::PIXELS];
+
+  ScrollFB() { memset(fb, 0, sizeof(fb)); }
+
+  void push(int first, int last, const uint8_t* column)     // LshiftFB + last column
+  {
+    for (int lin = first; lin < last; lin++)
+    {
+      memmove(fb + lin * Layout::WIDTH, fb + lin * Layout::WIDTH + 1, Layout::WIDTH - 1);
+      fb[lin * Layout::WIDTH + Layout::WIDTH - 1] = column[lin];
+    }
+  }
+
+  void pushRight(int first, int last, const uint8_t* column) // RshiftFB + first column
+  {
+    for (int lin = first; lin < last; lin++)
+    {
+      memmove(fb + lin * Layout::WIDTH + 1, fb + lin * Layout::WIDTH, Layout::WIDTH - 1);
+      fb[lin * Layout::WIDTH] = column[lin];
+    }
+  }
+
+  void draw(Rgb* leds, const Rgb& c) const                   // drawFB
+  {
+    for (int pixel = 0; pixel < Layout::PIXELS; pixel++)
+      refPixel(leds, pixel, c, fb[Layout::position(pixel)]);
+  }
+};
+
+//
+// ---- check of the motifs compiled in ----
+//
+
+static const uint8_t* findPacked(const char* name, int& size)
+{
+  for (size_t i = 0; i < sizeof(packedMotifs) / sizeof(packedMotifs[0]); i++)
+    if (strcmp(packedMotifs[i].name, name) == 0)
+    {
+      size = packedMotifs[i].size;
+      return packedMotifs[i].data;
+    }
+  size = 0;
+  return NULL;
+}
+
+static int firstDiff(const Leds& a, const Leds& b)
+{
+  for (int i = 0; i < Layout::LEDS; i++)
+    if (a[i].r != b[i].r || a[i].g != b[i].g || a[i].b != b[i].b)
+      return i;
+  return -1;
+}
+
+static bool checkMotif(const bigsrc::Motif& m, const uint8_t* packed, int size)
+{
+  static const Rgb colors[] = { Rgb(250, 0, 0), Rgb(10, 200, 30), Rgb(255, 255, 255) };
+  Leds ref, out;
+  int diff = -1;
+  int steps = 1;
+
+  if (m.type == bigsrc::MONO)
+  {
+    for (int i = 0; i < 3 && diff < 0; i++)
+    {
+      refMono(ref, m.data, colors[i]);
+      bigmotif::drawMono(out, packed, colors[i].r, colors[i].g, colors[i].b);
+      diff = firstDiff(ref, out);
+    }
+  }
+  else if (m.type == bigsrc::MULTI)
+  {
+    refMulti(ref, m.data);
+    bigmotif::drawMulti(out, packed);
+    diff = firstDiff(ref, out);
+  }
+  else                             // DrawScroll twice over the motif
+  {
+    ScrollFB refFB, outFB;
+    uint8_t refCol[Layout::HEIGHT], outCol[Layout::HEIGHT];
+
+    steps = 2 * m.width;
+    for (int step = 0; step < steps && diff < 0; step++)
+    {
+      int scrollH = step % m.width;
+      for (int lin = 0; lin < Layout::HEIGHT; lin++)
+      {
+        refCol[lin] = (uint8_t)m.data[lin * m.width + scrollH];
+        outCol[lin] = bigmotif::scrollPixel(packed, scrollH, lin);
+      }
+      refFB.push(0, Layout::HEIGHT, refCol);
+      outFB.push(0, Layout::HEIGHT, outCol);
+      refFB.draw(ref, colors[1]);
+      outFB.draw(out, colors[1]);
+      diff = firstDiff(ref, out);
+    }
+  }
+
+  printf("%-7s %-7s %4d -> %3d bytes, %3d frames  %s\n", m.name, m.type == bigsrc::MONO ? "mono" :
+         m.type == bigsrc::MULTI ? "multi" : "scroll", m.type == bigsrc::SCROLL ? m.width * Layout::HEIGHT :
+         m.type == bigsrc::MULTI ? bigmotif::PALETTE_BYTES + Layout::PIXELS : Layout::PIXELS,
+         size, steps, diff < 0 ? "ok" : "DIFFERENT");
+  if (diff >= 0)
+    printf("!!! %s: LED %d differs !!!\n", m.name, diff);
+  return diff < 0;
+}
+
+// DrawText over every glyph, a blank column between two glyphs
+static bool checkFont(const uint8_t* widths, const uint8_t* first, const uint8_t* font, int size)
+{
+  ScrollFB refFB, outFB;
+  uint8_t refCol[Layout::HEIGHT] = { 0 }, outCol[Layout::HEIGHT] = { 0 };
+  Leds ref, out;
+  int steps = 0;
+  int diff = -1;
+  int typIdx = 0;
+
+  for (int g = 0; g < bigsrc::MAXTYPO && diff < 0; g++)
+  {
+    int width = bigsrc::typWdt[g];
+    if (pgm_read_byte(widths + g) != width || pgm_read_byte(first + g) != typIdx)
+    {
+      printf("!!! typo: glyph %d, width or first column differs !!!\n", g);
+      return false;
+    }
+    for (int typoCol = 0; typoCol <= width && diff < 0; typoCol++, steps++)
+    {
+      for (int lin = 2; lin < 7; lin++)
+      {
+        refCol[lin] = typoCol == 0 ? 0 : (uint8_t)bigsrc::typo[typIdx * 5 + (lin - 2) * width + typoCol - 1];
+        outCol[lin] = typoCol == 0 ? 0 : bigmotif::fontPixel(font, pgm_read_byte(first + g) + typoCol - 1, lin - 2);
+      }
+      refFB.push(2, 7, refCol);
+      outFB.push(2, 7, outCol);
+      refFB.draw(ref, Rgb(0, 250, 250));
+      outFB.draw(out, Rgb(0, 250, 250));
+      diff = firstDiff(ref, out);
+    }
+    typIdx += width;
+  }
+
+  printf("%-7s %-7s %4d -> %3d bytes, %3d frames  %s\n", "typo", "font",
+         (int)(sizeof(bigsrc::typo) + 2 * bigsrc::MAXTYPO), size, steps, diff < 0 ? "ok" : "DIFFERENT");
+  if (diff >= 0)
+    printf("!!! typo: LED %d differs !!!\n", diff);
+  return diff < 0;
+}
+
+// Scroller against the shifted frame buffer: random frame buffers scrolled
+// out by two strips one after the other (motif in flash or text), both ways,
+// strips shorter and longer than the view, then flatten()
+static bool checkScroller()
+{
+  int steps = 0;
+  bool ok = true;
+
+  srand(2023);
+  for (int run = 0; run < 500 && ok; run++)
+  {
+    ScrollFB refFB;
+    char fb[Layout::PIXELS];
+    bigmotif::Scroller view;
+    Bytes strips[2];
+
+    for (int i = 0; i < Layout::PIXELS; i++)
+      fb[i] = (char)(refFB.fb[i] = (uint8_t)(rand() % 4));
+
+    for (int part = 0; part < 2 && ok; part++)
+    {
+      bool text = rand() % 2 == 0;
+      bool leftwards = rand() % 2 == 0;
+      int length = 1 + rand() % 40;
+      int first = text ? 2 : 0;
+      int last = text ? 7 : Layout::HEIGHT;
+      int pos = rand() % length;
+      int nbSteps = 1 + rand() % 30;
+      Bytes& strip = strips[part];
+
+      strip.resize(length * bigmotif::COLUMN_BYTES);
+      for (size_t i = 0; i < strip.size(); i++)
+        strip[i] = (uint8_t)(text ? rand() % 32 : rand() % 256);
+      view.flatten(fb);
+      view.start(strip.data(), !text, length, first, last, leftwards);
+
+      for (int step = 0; step < nbSteps && ok; step++, steps++)
+      {
+        uint8_t column[Layout::HEIGHT];
+        for (int lin = first; lin < last; lin++)
+          column[lin] = text ? (strip[pos] >> (lin - first)) & 1 : bigmotif::scrollPixel(strip.data(), pos, lin);
+        if (leftwards)
+          refFB.push(first, last, column);
+        else
+          refFB.pushRight(first, last, column);
+        view.step(pos);
+        pos = (pos + 1) % length;
+
+        for (int i = 0; i < Layout::PIXELS && ok; i++)
+          ok = view.pixel(fb, i / Layout::WIDTH, i % Layout::WIDTH) == refFB.fb[i];
+      }
+    }
+    view.flatten(fb);
+    for (int i = 0; i < Layout::PIXELS && ok; i++)
+      ok = (uint8_t)fb[i] == refFB.fb[i];
+  }
+
+  printf("%-7s %-7s %4d steps of random strips             %s\n", "view", "scroll", steps, ok ? "ok" : "DIFFERENT");
+  if (!ok)
+    printf("!!! Scroller differs from the shifted frame buffer !!!\n");
+  return ok;
+}
+
+static bool check(const std::vector<Packed>& packed)
+{
+  bool ok = true;
+  int before = 0, after = 0;
+
+  for (int i = 0; i < bigsrc::NB_MOTIFS; i++)
+  {
+    int size;
+    const uint8_t* data = findPacked(bigsrc::motifs[i].name, size);
+    if (data == NULL)
+    {
+      printf("!!! %s: missing in motifsBIG_P.h !!!\n", bigsrc::motifs[i].name);
+      ok = false;
+      continue;
+    }
+    ok = checkMotif(bigsrc::motifs[i], data, size) && ok;
+  }
+  ok = checkFont(typWdt, typIdx, typo, (int)(sizeof(typWdt) + sizeof(typIdx) + sizeof(typo))) && ok;
+  ok = checkScroller() && ok;
+
+  for (size_t i = 0; i < packed.size(); i++)    // same bytes as a new packing
+  {
+    int size;
+    const uint8_t* data = findPacked(packed[i].name.c_str(), size);
+    if (data == NULL || size != (int)packed[i].data.size() || memcmp(data, packed[i].data.data(), size) != 0)
+    {
+      printf("!!! %s: motifsBIG_P.h is not up to date, run bigpack -o motifsBIG_P.h !!!\n", packed[i].name.c_str());
+      ok = false;
+    }
+  }
+
+  for (int i = 0; i < bigsrc::NB_MOTIFS; i++)
+  {
+    const bigsrc::Motif& m = bigsrc::motifs[i];
+    before += m.type == bigsrc::SCROLL ? m.width * Layout::HEIGHT :
+              m.type == bigsrc::MULTI ? bigmotif::PALETTE_BYTES + Layout::PIXELS : Layout::PIXELS;
+  }
+  before += (int)sizeof(bigsrc::typo) + 2 * bigsrc::MAXTYPO;
+  for (size_t i = 0; i < sizeof(packedMotifs) / sizeof(packedMotifs[0]); i++)
+    after += packedMotifs[i].size;
+  printf("\nRAM %d bytes of char arrays -> flash %d bytes, %s\n", before, after,
+         ok ? "pixel-identical" : "FAILED");
+  return ok;
+}
+
+int main(int argc, char** argv)
+{
+  const char* output = NULL;
+  bool doCheck = false;
+  bool usage = argc < 2;
+
+  printf("%s %s\n\n", argv[0], VERSION);
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+      output = argv[++i];
+    else if (strcmp(argv[i], "-check") == 0)
+      doCheck = true;
+    else
+      usage = true;
+  }
+  if (usage)
+  {
+    printf("syntaxe: %s [-o motifsBIG_P.h] [-check]\n", argv[0]);
+    printf("         -o     packs the motifs of motifsBIG.h into a PROGMEM header\n");
+    printf("         -check compares the LEDs of the packed motifs compiled in with v2.6\n");
+    return 1;
+  }
+
+  std::vector<Packed> packed;
+  if (!packAll(packed))
+    return 1;
+
+  if (output != NULL)
+  {
+    if (!writeHeader(output, packed))
+    {
+      printf("!!! cannot write %s !!!\n", output);
+      return 1;
+    }
+    printf("%s written, %d arrays\n", output, (int)packed.size());
+  }
+
+  if (doCheck && !check(packed))
+    return 1;
+  return 0;
+}
@@ -0,0 +1,144 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// bmpfile.h
+//
+// 1. Minimal BMP reader and writer for the host tools, no EasyBMP needed
+// --> reads uncompressed 24 and 32 bit BMP, bottom-up or top-down
+// --> R,G,B triplets line by line from the top, as EasyBMP GetPixel(i, j)
+// --> writes 24 bit bottom-up BMP (test images)
+// --> caller-supplied buffers, no heap
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     24/32 bit read, 24 bit write
+//
+
+#ifndef BMPFILE_H
+#define BMPFILE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace bmpfile
+{
+
+const size_t FILE_HEADER = 14;
+const size_t INFO_HEADER = 40;
+
+inline uint32_t get32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+inline void put32(uint8_t* p, uint32_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24); }
+inline void put16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+
+//
+// Reads name into rgb (capacity in pixels), width and height receive the
+// image size. False if the file is missing, not a supported BMP or bigger
+// than capacity.
+//
+inline bool read(const char* name, uint8_t* rgb, size_t capacity, int& width, int& height)
+{
+  uint8_t hdr[FILE_HEADER + INFO_HEADER];
+  uint8_t line[4 * 1024];
+  FILE* fp = fopen(name, "rb");
+
+  if (fp == NULL)
+    return false;
+  bool ok = fread(hdr, 1, sizeof(hdr), fp) == sizeof(hdr) && hdr[0] == 'B' && hdr[1] == 'M';
+  uint32_t offset = get32(hdr + 10);
+  int32_t  w = (int32_t)get32(hdr + 18);
+  int32_t  h = (int32_t)get32(hdr + 22);
+  int      bpp = hdr[28] | (hdr[29] << 8);
+  uint32_t compression = get32(hdr + 30);
+  bool     topDown = h < 0;
+
+  if (topDown)
+    h = -h;
+  size_t stride = ((size_t)w * (bpp / 8) + 3) & ~(size_t)3;
+  ok = ok && (bpp == 24 || bpp == 32) && (compression == 0 || (bpp == 32 && compression == 3)) &&
+       w > 0 && h > 0 && (size_t)w * h <= capacity && stride <= sizeof(line) &&
+       fseek(fp, offset, SEEK_SET) == 0;
+  for (int32_t y = 0; ok && y < h; y++)
+  {
+    if (fread(line, 1, stride, fp) != stride)
+    {
+      ok = false;
+      break;
+    }
+    uint8_t* out = rgb + 3 * (size_t)w * (topDown ? y : h - 1 - y);
+    const uint8_t* in = line;
+    for (int32_t x = 0; x < w; x++, in += bpp / 8, out += 3)
+    {
+      out[0] = in[2];                    // B,G,R in the file
+      out[1] = in[1];
+      out[2] = in[0];
+    }
+  }
+  fclose(fp);
+  width = w;
+  height = h;
+  return ok;
+}
+
+//
+// Writes the width x height rgb triplets to name as a 24 bit BMP
+//
+inline bool write(const char* name, const uint8_t* rgb, int width, int height)
+{
+  uint8_t hdr[FILE_HEADER + INFO_HEADER] = { 0 };
+  uint8_t line[4 * 1024] = { 0 };
+  size_t  stride = ((size_t)width * 3 + 3) & ~(size_t)3;
+
+  if (stride > sizeof(line))
+    return false;
+  hdr[0] = 'B';
+  hdr[1] = 'M';
+  put32(hdr + 2, (uint32_t)(sizeof(hdr) + stride * height));
+  put32(hdr + 10, (uint32_t)sizeof(hdr));
+  put32(hdr + 14, (uint32_t)INFO_HEADER);
+  put32(hdr + 18, (uint32_t)width);
+  put32(hdr + 22, (uint32_t)height);
+  put16(hdr + 26, 1);                    // planes
+  put16(hdr + 28, 24);
+  put32(hdr + 34, (uint32_t)(stride * height));
+
+  FILE* fp = fopen(name, "wb");
+  if (fp == NULL)
+    return false;
+  bool ok = fwrite(hdr, 1, sizeof(hdr), fp) == sizeof(hdr);
+  for (int y = height - 1; ok && y >= 0; y--)
+  {
+    const uint8_t* in = rgb + 3 * (size_t)width * y;
+    for (int x = 0; x < width; x++, in += 3)
+    {
+      line[3*x]     = in[2];
+      line[3*x + 1] = in[1];
+      line[3*x + 2] = in[0];
+    }
+    ok = fwrite(line, 1, stride, fp) == stride;
+  }
+  return fclose(fp) == 0 && ok;
+}
+
+} // namespace bmpfile
+
+#endif // BMPFILE_H
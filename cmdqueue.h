@@ -0,0 +1,55 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// cmdqueue.h
+//
+// 1. Commands from the network tasks to the render loop of MegaPix
+// --> one producer, one consumer: the HTTP task or the UDP task pushes,
+//     loop() pops, each with its own queue
+// --> a fixed ring of N commands (spscring.h): no lock, no wait on either
+//     side, a full queue drops the command and counts it, the producer
+//     never waits for the renderer
+// --> Command by default, its op and argument are given by the firmware;
+//     any trivially copyable T works, cmdstress runs them with std::thread
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Lock-free command queue between the two cores
+// v1.1   16 Oct. 2026     Built on SpscRing, shared with the live packets
+//
+
+#ifndef CMDQUEUE_H
+#define CMDQUEUE_H
+
+#include <stdint.h>
+#include "spscring.h"
+
+struct Command
+{
+  uint8_t op;
+  uint8_t arg;
+};
+
+template <class T = Command, int N = 16>
+using CommandQueue = SpscRing<T, N>;
+
+#endif // CMDQUEUE_H
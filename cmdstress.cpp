@@ -0,0 +1,286 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// cmdstress.cpp
+//
+// 1. Stress test of the command queues of MegaPix (cmdqueue.h)
+// --> queue: two producer threads, "http" and "udp", push numbered commands
+//     as fast as they can, each in its own queue; the consumer drains both,
+//     every command must arrive once and in order. A full queue is retried
+//     here to check the count, the firmware drops the command.
+// --> frames: the render loop paced as AnimateMPX (pacer.h) with a decode
+//     and a show time, HTTP requests arriving at random with a serving time
+//       single : the requests are served between two frames, as before v3.2
+//       split  : a network thread serves them and posts a command, the
+//                render loop applies it between two frames
+//     the same arrivals in both runs; the jitter of the frames and the
+//     latency of the requests are compared
+// --> the threads stand for the two cores of the ESP32, pinned to two CPUs
+//     when the host has them
+//
+// usage: cmdstress [commands] [ms]
+//        a ThreadSanitizer build checks the memory ordering:
+//        cmake -S . -B tsan -DCMAKE_CXX_FLAGS=-fsanitize=thread
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Queue ordering, render jitter with and without the split
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include "cmdqueue.h"
+#include "pacer.h"
+
+#define VERSION "v1.0  2026-10-15"
+
+#define COMMANDS     2000000
+#define RUN_MS       3000
+
+#define FRAME_US     33333           // 30 fps
+#define DECODE_US    2000            // DrawMPX of a 24x24 image
+#define SHOW_US      17300           // 576 WS2812 LEDs
+#define REQUEST_MS   40              // mean time between two HTTP requests
+#define SERVE_US     6000            // read the request, send the page
+
+typedef std::chrono::steady_clock Clock;
+
+static Clock::time_point origin = Clock::now();
+
+static uint32_t nowUs()
+{
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - origin).count();
+}
+
+//
+// Busy for us, the task holds its core as FastLED.show() or the web server
+//
+static void work(uint32_t us)
+{
+  uint32_t end = nowUs() + us;
+  while ((int32_t)(nowUs() - end) < 0)
+    ;
+}
+
+//
+// Network threads on CPU 0, the render loop (main) on CPU 1, as NET_CORE
+//
+static void pin(std::thread* t, int cpu)
+{
+#ifdef __linux__
+  if (std::thread::hardware_concurrency() < 2)
+    return;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  pthread_setaffinity_np(t ? t->native_handle() : pthread_self(), sizeof(set), &set);
+#else
+  (void)t;
+  (void)cpu;
+#endif
+}
+
+//
+// Numbered commands of one producer
+//
+struct Stamped
+{
+  uint32_t seq;
+  uint32_t us;                                 // arrival of the request
+};
+
+static bool runQueue(uint32_t commands)
+{
+  CommandQueue<Stamped> queues[2];
+  uint32_t retries[2] = {0, 0};
+  std::atomic<int> ended(0);
+  Clock::time_point start = Clock::now();
+
+  auto producer = [&](int q)
+  {
+    for (uint32_t seq = 0; seq < commands; seq++)
+    {
+      Stamped cmd = {seq, 0};
+      while (!queues[q].push(cmd))
+      {
+        retries[q]++;
+        std::this_thread::yield();
+      }
+    }
+    ended.fetch_add(1, std::memory_order_release);
+  };
+  std::thread http(producer, 0);
+  std::thread udp(producer, 1);
+  pin(&http, 0);
+  pin(&udp, 0);
+
+  uint32_t received[2] = {0, 0};
+  uint32_t disorder = 0;
+  bool last = false;
+  while (!last)
+  {
+    last = ended.load(std::memory_order_acquire) == 2;   // one more pass after the end
+    bool any = false;
+    for (int q = 0; q < 2; q++)
+    {
+      Stamped cmd;
+      while (queues[q].pop(cmd))
+      {
+        if (cmd.seq != received[q])
+          disorder++;
+        received[q] = cmd.seq + 1;
+        any = true;
+      }
+    }
+    if (!any)
+      std::this_thread::yield();
+  }
+  http.join();
+  udp.join();
+  double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+  bool ok = disorder == 0 && received[0] == commands && received[1] == commands &&
+            queues[0].rejected() == retries[0] && queues[1].rejected() == retries[1];
+  printf("queue  : 2 x %u commands in %.0f ms, %u out of order, full %u + %u, %s\n",
+         (unsigned)commands, ms, (unsigned)disorder,
+         (unsigned)queues[0].rejected(), (unsigned)queues[1].rejected(), ok ? "OK" : "FAILED");
+  return ok;
+}
+
+//
+// Render loop for ms with the requests of arrivals (us from the start)
+//
+static bool runFrames(bool split, const std::vector<uint32_t>& arrivals, uint32_t ms)
+{
+  CommandQueue<Stamped> httpCommands;
+  std::atomic<bool> stop(false);
+  uint32_t start = nowUs();
+  uint32_t latencyMax = 0;
+  uint64_t latencySum = 0;
+  uint32_t applied = 0;
+
+  std::thread net;
+  if (split)
+  {
+    net = std::thread([&]()
+    {
+      for (uint32_t seq = 0; seq < arrivals.size() && !stop.load(); seq++)
+      {
+        while ((int32_t)(nowUs() - (start + arrivals[seq])) < 0 && !stop.load())
+          std::this_thread::sleep_for(std::chrono::microseconds(200));
+        work(SERVE_US);
+        Stamped cmd = {seq, start + arrivals[seq]};
+        httpCommands.push(cmd);
+      }
+    });
+    pin(&net, 0);
+  }
+
+  Pacer pacer;
+  size_t served = 0;
+  uint32_t end = start + ms * 1000;
+  pacer.restart(nowUs());
+  for (uint32_t now = nowUs(); (int32_t)(now - end) < 0; now = nowUs())
+  {
+    Stamped cmd;
+    if (split)
+    {
+      while (httpCommands.pop(cmd))
+      {
+        uint32_t latency = nowUs() - cmd.us;
+        latencySum += latency;
+        latencyMax = latency > latencyMax ? latency : latencyMax;
+        applied++;
+      }
+    }
+    else
+    {
+      while (served < arrivals.size() && (int32_t)(now - (start + arrivals[served])) >= 0)
+      {
+        work(SERVE_US);
+        uint32_t latency = nowUs() - (start + arrivals[served++]);
+        latencySum += latency;
+        latencyMax = latency > latencyMax ? latency : latencyMax;
+        applied++;
+        now = nowUs();
+      }
+    }
+
+    if (!pacer.isDue(now))
+    {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+      continue;
+    }
+    while (pacer.skip(now, FRAME_US))
+      ;
+    work(DECODE_US);
+    work(SHOW_US);
+    pacer.shown(nowUs(), FRAME_US);
+  }
+  stop = true;
+  if (net.joinable())
+    net.join();
+
+  const PacerStats& st = pacer.stats();
+  printf("%-7s: %u shown, %u dropped, jitter %u/%u/%u us, %u requests, latency %u/%u us\n",
+         split ? "split" : "single", (unsigned)st.shown, (unsigned)st.dropped,
+         (unsigned)st.jitterMin, (unsigned)st.jitterMean(), (unsigned)st.jitterMax,
+         (unsigned)applied, applied ? (unsigned)(latencySum / applied) : 0, (unsigned)latencyMax);
+  return st.shown > 0;
+}
+
+int main(int argc, char* argv[])
+{
+  printf("cmdstress %s\n", VERSION);
+  if (argc > 3 || (argc > 1 && atoi(argv[1]) <= 0) || (argc > 2 && atoi(argv[2]) <= 0))
+  {
+    printf("syntaxe: cmdstress [commands] [ms]\n");
+    return 1;
+  }
+  uint32_t commands = argc > 1 ? (uint32_t)atoi(argv[1]) : COMMANDS;
+  uint32_t ms = argc > 2 ? (uint32_t)atoi(argv[2]) : RUN_MS;
+  printf("%u CPU, frames of %u us: decode %u us, show %u us, requests every %u ms for %u us\n",
+         std::thread::hardware_concurrency(), FRAME_US, DECODE_US, SHOW_US, REQUEST_MS, SERVE_US);
+
+  pin(NULL, 1);
+  bool ok = runQueue(commands);
+
+  std::mt19937 rnd(2026);
+  std::exponential_distribution<double> gap(1.0 / (REQUEST_MS * 1000));
+  std::vector<uint32_t> arrivals;
+  for (double t = gap(rnd); t < ms * 1000.0; t += gap(rnd))
+    arrivals.push_back((uint32_t)t);
+
+  ok = runFrames(false, arrivals, ms) && ok;
+  ok = runFrames(true, arrivals, ms) && ok;
+  printf("%s\n", ok ? "OK" : "FAILED");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,219 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// cyclestat.h
+//
+// 1. Time spent per stage of the firmwares: HTTP, UDP, decode, show, idle...
+// --> Scope reads the cycle counter when it is built and when it goes out of
+//     scope, the difference goes to the histogram of its stage
+// --> fixed size histograms, one bucket per power of two of the cycles, with
+//     count, min, mean and max: no heap, a few instructions per sample
+// --> writeJson() for the /stats route, writeText() for the serial line
+// --> one writer per histogram (loop() or the UDP task), a reader may see a
+//     sample half added: counts are approximate while the show runs
+// --> with CYCLESTAT defined to 0 before the include, the histograms are
+//     empty classes and the scopes do nothing: the compiler removes them
+// --> Xtensa cycle counter on the ESP32 and ESP8266, nanoseconds elsewhere
+//     (host emulator)
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Stage histograms, JSON and serial reports
+//
+
+#ifndef CYCLESTAT_H
+#define CYCLESTAT_H
+
+#include <stdint.h>
+#include <stdio.h>
+#if !defined(__XTENSA__)
+#include <chrono>
+#endif
+
+#ifndef CYCLESTAT
+#define CYCLESTAT 1
+#endif
+
+namespace cyclestat
+{
+
+const int NB_BUCKETS = 32;                     // bucket i: 2^i to 2^(i+1)-1 cycles
+
+#if defined(__XTENSA__)
+const uint32_t PER_US = F_CPU / 1000000;       // cycles per us
+
+inline uint32_t cycles()
+{
+  uint32_t c;
+  __asm__ __volatile__("rsr %0, ccount" : "=a"(c));
+  return c;
+}
+#else
+const uint32_t PER_US = 1000;
+
+inline uint32_t cycles()
+{
+  return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+#if CYCLESTAT
+
+inline uint32_t now() { return cycles(); }
+
+class Histogram
+{
+public:
+  Histogram() { reset(); }
+
+  void reset()
+  {
+    n = 0;
+    lo = 0xFFFFFFFF;
+    hi = 0;
+    sum = 0;
+    for (int i = 0; i < NB_BUCKETS; i++)
+      buckets[i] = 0;
+  }
+
+  void add(uint32_t c)
+  {
+    buckets[c > 1 ? 31 - __builtin_clz(c) : 0]++;
+    if (c < lo)
+      lo = c;
+    if (c > hi)
+      hi = c;
+    sum += c;
+    n++;
+  }
+
+  uint32_t count() const { return n; }
+  uint32_t min() const { return n ? lo : 0; }
+  uint32_t max() const { return hi; }
+  uint32_t mean() const { return n ? (uint32_t)(sum / n) : 0; }
+  uint32_t totalMs() const { return (uint32_t)(sum / (PER_US * 1000)); }
+  uint32_t bucket(int i) const { return buckets[i]; }
+
+private:
+  uint32_t n;
+  uint32_t lo;
+  uint32_t hi;
+  uint64_t sum;
+  uint32_t buckets[NB_BUCKETS];
+};
+
+#else
+
+inline uint32_t now() { return 0; }
+
+class Histogram                                // compiled out
+{
+public:
+  void reset() {}
+  void add(uint32_t) {}
+  uint32_t count() const { return 0; }
+  uint32_t min() const { return 0; }
+  uint32_t max() const { return 0; }
+  uint32_t mean() const { return 0; }
+  uint32_t totalMs() const { return 0; }
+  uint32_t bucket(int) const { return 0; }
+};
+
+#endif
+
+//
+// Cycles from construction to the end of the scope, into the histogram
+//
+class Scope
+{
+public:
+  explicit Scope(Histogram& h) : hist(h), start(now()) {}
+  ~Scope() { hist.add(now() - start); }
+
+private:
+  Scope(const Scope&);
+  Scope& operator=(const Scope&);
+
+  Histogram& hist;
+  uint32_t   start;
+};
+
+//
+// {"enabled":1,"cycles_per_us":240,"uptime_ms":...,"stages":[{"name":"http",
+// "count":..,"min":..,"mean":..,"max":..,"total_ms":..,"log2":[..]},...]}
+// min, mean and max in cycles, log2 stops at the last non-empty bucket
+//
+template <class Out>
+void writeJson(Out& out, const Histogram* stages, const char* const* names, int nb,
+               unsigned long uptimeMs)
+{
+  char buf[96];
+
+  snprintf(buf, sizeof(buf), "{\"enabled\":%d,\"cycles_per_us\":%lu,\"uptime_ms\":%lu,\"stages\":[",
+           CYCLESTAT ? 1 : 0, (unsigned long)PER_US, uptimeMs);
+  out.print(buf);
+  for (int s = 0; s < nb; s++)
+  {
+    const Histogram& h = stages[s];
+    snprintf(buf, sizeof(buf), "%s{\"name\":\"%s\",\"count\":%lu,\"min\":%lu,\"mean\":%lu,",
+             s ? "," : "", names[s], (unsigned long)h.count(), (unsigned long)h.min(),
+             (unsigned long)h.mean());
+    out.print(buf);
+    snprintf(buf, sizeof(buf), "\"max\":%lu,\"total_ms\":%lu,\"log2\":[",
+             (unsigned long)h.max(), (unsigned long)h.totalMs());
+    out.print(buf);
+    int last = NB_BUCKETS - 1;
+    while (last >= 0 && h.bucket(last) == 0)
+      last--;
+    for (int i = 0; i <= last; i++)
+    {
+      snprintf(buf, sizeof(buf), "%s%lu", i ? "," : "", (unsigned long)h.bucket(i));
+      out.print(buf);
+    }
+    out.print("]}");
+  }
+  out.print("]}\r\n");
+}
+
+//
+// One line per stage, times in us
+//
+template <class Out>
+void writeText(Out& out, const Histogram* stages, const char* const* names, int nb)
+{
+  char buf[96];
+
+  for (int s = 0; s < nb; s++)
+  {
+    const Histogram& h = stages[s];
+    snprintf(buf, sizeof(buf), "%-6s %8lu  min %7lu  mean %7lu  max %7lu us  total %7lu ms\n",
+             names[s], (unsigned long)h.count(), (unsigned long)(h.min() / PER_US),
+             (unsigned long)(h.mean() / PER_US), (unsigned long)(h.max() / PER_US),
+             (unsigned long)h.totalMs());
+    out.print(buf);
+  }
+}
+
+} // namespace cyclestat
+
+#endif // CYCLESTAT_H
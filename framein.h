@@ -0,0 +1,281 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// framein.h
+//
+// 1. Frame stream reader for the host tools: PPM or Y4M, one frame at a time
+// --> PPM: P6 images one after the other (ffmpeg -f image2pipe -c:v ppm),
+//     maxval 255, no frame rate in the stream
+// --> Y4M: YUV4MPEG2 header with the frame rate, 4:2:0, 4:2:2, 4:4:4 or mono
+//     planes, BT.601 limited range unless XCOLORRANGE=FULL
+// --> next() reads one frame into R,G,B triplets line by line, the reader
+//     only holds one frame of YUV planes, whatever the stream length
+// --> every frame must have the size of the first one
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     PPM and Y4M
+//
+
+#ifndef FRAMEIN_H
+#define FRAMEIN_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace framein
+{
+
+class Reader
+{
+public:
+  explicit Reader(FILE* in) : in(in), y4m(false), fullRange(false), width(0), height(0),
+                              fpsNum(0), fpsDen(1), chromaW(0), chromaH(0), frames(0) {}
+
+  //
+  // Reads the stream header (Y4M) or the first frame header (PPM)
+  //
+  bool open()
+  {
+    int c = getc(in);
+    if (c == 'Y')
+      return openY4m();
+    if (c == 'P' && getc(in) == '6')
+      return readPpmSize(width, height);
+    err = "not a PPM (P6) or Y4M stream";
+    return false;
+  }
+
+  //
+  // Next frame into rgb (width * height * 3 bytes), false at the end of the
+  // stream or on error (error() is not empty then)
+  //
+  bool next(uint8_t* rgb)
+  {
+    bool ok = y4m ? nextY4m(rgb) : nextPpm(rgb);
+    frames += ok;
+    return ok;
+  }
+
+  int  frameWidth() const { return width; }
+  int  frameHeight() const { return height; }
+  bool hasRate() const { return fpsNum > 0; }
+  double fps() const { return (double)fpsNum / fpsDen; }
+  long frameCount() const { return frames; }
+  const std::string& error() const { return err; }
+
+private:
+  bool openY4m()
+  {
+    char magic[9];
+    if (fread(magic, 1, 9, in) != 9 || memcmp(magic, "UV4MPEG2 ", 9) != 0)
+      return fail("not a Y4M stream");
+    std::string line;
+    if (!readLine(line))
+      return fail("truncated Y4M header");
+
+    std::string colorspace = "420jpeg";
+    size_t pos = 0;
+    while (pos < line.size())
+    {
+      size_t end = line.find(' ', pos);
+      if (end == std::string::npos)
+        end = line.size();
+      std::string tag = line.substr(pos, end - pos);
+      pos = end + 1;
+      if (tag.empty())
+        continue;
+      switch (tag[0])
+      {
+      case 'W': width = atoi(tag.c_str() + 1); break;
+      case 'H': height = atoi(tag.c_str() + 1); break;
+      case 'F': if (sscanf(tag.c_str() + 1, "%d:%d", &fpsNum, &fpsDen) != 2 || fpsDen <= 0)
+                  fpsNum = 0, fpsDen = 1;
+                break;
+      case 'C': colorspace = tag.substr(1); break;
+      case 'X': fullRange = fullRange || tag == "XCOLORRANGE=FULL"; break;
+      }
+    }
+    if (width <= 0 || height <= 0)
+      return fail("Y4M header without W or H");
+    if (colorspace.compare(0, 3, "420") == 0)
+      chromaW = (width + 1) / 2, chromaH = (height + 1) / 2;
+    else if (colorspace == "422")
+      chromaW = (width + 1) / 2, chromaH = height;
+    else if (colorspace == "444")
+      chromaW = width, chromaH = height;
+    else if (colorspace == "mono")
+      chromaW = 0, chromaH = 0;
+    else
+      return fail("Y4M colorspace C" + colorspace + " is not supported");
+    planes.resize((size_t)width * height + 2 * (size_t)chromaW * chromaH);
+    y4m = true;
+    return true;
+  }
+
+  bool nextY4m(uint8_t* rgb)
+  {
+    std::string line;
+    if (!readLine(line))
+      return false;                      // end of stream
+    if (line.compare(0, 5, "FRAME") != 0)
+      return fail("Y4M FRAME marker expected");
+    if (fread(planes.data(), 1, planes.size(), in) != planes.size())
+      return fail("truncated Y4M frame");
+
+    const uint8_t* Y = planes.data();
+    const uint8_t* U = Y + (size_t)width * height;
+    const uint8_t* V = U + (size_t)chromaW * chromaH;
+    for (int y = 0; y < height; y++)
+    {
+      for (int x = 0; x < width; x++, rgb += 3)
+      {
+        int cb = 128, cr = 128;
+        if (chromaW > 0)
+        {
+          size_t c = (size_t)(y * chromaH / height) * chromaW + x * chromaW / width;
+          cb = U[c];
+          cr = V[c];
+        }
+        toRgb(Y[(size_t)y * width + x], cb, cr, rgb);
+      }
+    }
+    return true;
+  }
+
+  //
+  // BT.601, integer coefficients scaled by 1024
+  //
+  void toRgb(int luma, int cb, int cr, uint8_t* rgb) const
+  {
+    int l = fullRange ? luma * 1024 : (luma - 16) * 1192;
+    int u = cb - 128;
+    int v = cr - 128;
+    if (fullRange)
+    {
+      rgb[0] = clamp((l + 1436 * v + 512) >> 10);
+      rgb[1] = clamp((l - 352 * u - 731 * v + 512) >> 10);
+      rgb[2] = clamp((l + 1815 * u + 512) >> 10);
+    }
+    else
+    {
+      rgb[0] = clamp((l + 1634 * v + 512) >> 10);
+      rgb[1] = clamp((l - 401 * u - 833 * v + 512) >> 10);
+      rgb[2] = clamp((l + 2066 * u + 512) >> 10);
+    }
+  }
+
+  static uint8_t clamp(int v) { return (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v)); }
+
+  bool nextPpm(uint8_t* rgb)
+  {
+    if (frames > 0)                      // the first header was read by open()
+    {
+      int c;
+      do
+        c = getc(in);
+      while (c == ' ' || c == '\t' || c == '\r' || c == '\n');
+      if (c == EOF)
+        return false;                    // end of stream
+      int w, h;
+      if (c != 'P' || getc(in) != '6' || !readPpmSize(w, h))
+        return fail("P6 header expected");
+      if (w != width || h != height)
+        return fail("PPM frame size changed");
+    }
+    size_t size = (size_t)width * height * 3;
+    if (fread(rgb, 1, size, in) != size)
+      return fail("truncated PPM frame");
+    return true;
+  }
+
+  bool readPpmSize(int& w, int& h)
+  {
+    long maxval;
+    w = (int)readNumber();
+    h = (int)readNumber();
+    maxval = readNumber();
+    if (w <= 0 || h <= 0 || maxval != 255)
+      return fail("P6 of maxval 255 expected");
+    width = width ? width : w;
+    height = height ? height : h;
+    return true;                         // readNumber() ate the single space
+  }
+
+  //
+  // PPM header number, skips blanks and comments, eats the following blank
+  //
+  long readNumber()
+  {
+    int c = getc(in);
+    for (;;)
+    {
+      if (c == '#')
+        while (c != '\n' && c != EOF)
+          c = getc(in);
+      else if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+        c = getc(in);
+      else
+        break;
+    }
+    long n = -1;
+    for (; c >= '0' && c <= '9'; c = getc(in))
+      n = (n < 0 ? 0 : n * 10) + (c - '0');
+    return n;
+  }
+
+  bool readLine(std::string& line)
+  {
+    int c;
+    line.clear();
+    while ((c = getc(in)) != EOF && c != '\n')
+      line += (char)c;
+    return c != EOF || !line.empty();
+  }
+
+  bool fail(const std::string& what)
+  {
+    err = what;
+    return false;
+  }
+
+  FILE*       in;
+  bool        y4m;
+  bool        fullRange;
+  int         width;
+  int         height;
+  int         fpsNum;
+  int         fpsDen;
+  int         chromaW;
+  int         chromaH;
+  long        frames;
+  std::vector<uint8_t> planes;           // one Y4M frame
+  std::string err;
+};
+
+} // namespace framein
+
+#endif // FRAMEIN_H
@@ -0,0 +1,136 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// Arduino.h
+//
+// 1. Host shim of the Arduino core used by MegaPix.ino and BigPix.ino
+// --> millis(), micros(), delay() on the virtual clock of hostemu.h
+// --> random() from a seeded generator, the same show on every run
+// --> Print for Serial and WiFiClient, Serial writes to the console
+// --> FreeRTOS tasks of the ESP32 core: a thread each, run by the virtual
+//     clock one at a time (hostemu.h), vTaskDelay() gives the CPU back
+// --> only what the firmwares use, add here when they use more
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Host emulator
+// v1.1   15 Oct. 2026     FreeRTOS tasks
+//
+
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+#include "hostemu.h"
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+
+inline unsigned long millis() { return (unsigned long)(hostemu::nowUs() / 1000); }
+inline unsigned long micros() { return (unsigned long)hostemu::nowUs(); }
+inline void delay(unsigned long ms) { hostemu::sleepUs((uint64_t)ms * 1000); }
+inline void delayMicroseconds(unsigned int us) { hostemu::sleepUs(us); }
+inline void yield() {}
+
+typedef void (*TaskFunction_t)(void*);
+typedef void* TaskHandle_t;
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+#define pdPASS             1
+#define portTICK_PERIOD_MS 1
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char*, uint32_t, void* param,
+                                          UBaseType_t, TaskHandle_t* handle, BaseType_t)
+{
+  hostemu::taskCreate(fn, param);
+  if (handle != NULL)
+    *handle = NULL;
+  return pdPASS;
+}
+
+inline void vTaskDelay(TickType_t ticks) { hostemu::taskDelay((uint64_t)ticks * portTICK_PERIOD_MS * 1000); }
+
+inline void randomSeed(unsigned long seed) { hostemu::randomSeed((uint32_t)seed); }
+inline long random(long howbig) { return howbig <= 0 ? 0 : (long)(hostemu::randomNext() % (uint32_t)howbig); }
+inline long random(long howsmall, long howbig) { return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall); }
+
+class IPAddress
+{
+public:
+  IPAddress() { bytes[0] = bytes[1] = bytes[2] = bytes[3] = 0; }
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) { bytes[0] = a; bytes[1] = b; bytes[2] = c; bytes[3] = d; }
+  uint8_t operator[](int i) const { return bytes[i]; }
+
+private:
+  uint8_t bytes[4];
+};
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) { return write(&c, 1); }
+  virtual size_t write(const uint8_t* buffer, size_t size) = 0;
+
+  size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int n) { return printf("%d", n); }
+  size_t print(unsigned int n) { return printf("%u", n); }
+  size_t print(long n) { return printf("%ld", n); }
+  size_t print(unsigned long n) { return printf("%lu", n); }
+  size_t print(double n, int digits = 2) { return printf("%.*f", digits, n); }
+  size_t print(const IPAddress& ip) { return printf("%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]); }
+
+  size_t println() { return print("\r\n"); }
+  template <class T> size_t println(T value) { size_t n = print(value); return n + println(); }
+
+  size_t printf(const char* format, ...)
+  {
+    char text[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (len < 0)
+      return 0;
+    return write((const uint8_t*)text, (size_t)len < sizeof(text) ? (size_t)len : sizeof(text) - 1);
+  }
+};
+
+class HardwareSerial : public Print
+{
+public:
+  void begin(unsigned long) {}
+  using Print::write;
+  size_t write(const uint8_t* buffer, size_t size) { hostemu::serialWrite((const char*)buffer, size); return size; }
+};
+
+extern HardwareSerial Serial;
+
+#endif // ARDUINO_H
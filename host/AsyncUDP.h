@@ -0,0 +1,81 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// AsyncUDP.h
+//
+// 1. Host shim of the ESP32 AsyncUDP library
+// --> listen() opens the localhost UDP port of the emulator (-udp)
+// --> the handler is called between two loop() calls, for each datagram of
+//     the socket or of the script, in arrival order: a run is repeatable
+// --> packet.write() answers the sender, script packets have none
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Host emulator
+//
+
+#ifndef ASYNCUDP_H
+#define ASYNCUDP_H
+
+#include <functional>
+#include "Arduino.h"
+
+class AsyncUDPPacket
+{
+public:
+  AsyncUDPPacket(uint8_t* data, size_t len, const hostemu::UdpPeer& peer)
+    : buf(data), len(len), peer(peer) {}
+
+  uint8_t* data() { return buf; }
+  size_t length() { return len; }
+  size_t write(const uint8_t* data, size_t size) { return hostemu::udpReply(peer, data, size); }
+
+private:
+  uint8_t* buf;
+  size_t   len;
+  hostemu::UdpPeer peer;
+};
+
+typedef std::function<void(AsyncUDPPacket& packet)> AuPacketHandlerFunction;
+
+class AsyncUDP
+{
+public:
+  bool listen(uint16_t port)
+  {
+    hostemu::udpListen(this, port);
+    return true;
+  }
+
+  void onPacket(AuPacketHandlerFunction cb) { handler = cb; }
+
+  void receive(AsyncUDPPacket& packet)
+  {
+    if (handler)
+      handler(packet);
+  }
+
+private:
+  AuPacketHandlerFunction handler;
+};
+
+#endif // ASYNCUDP_H
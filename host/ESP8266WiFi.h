@@ -0,0 +1,14 @@
+// ESP8266WiFi.h
+//
+// 1. Host shim of the ESP8266 WiFi library used by BigPix.ino, same as WiFi.h
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Host emulator
+//
+
+#ifndef ESP8266WIFI_H
+#define ESP8266WIFI_H
+
+#include "WiFi.h"
+
+#endif // ESP8266WIFI_H
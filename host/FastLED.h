@@ -0,0 +1,78 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// FastLED.h
+//
+// 1. Host shim of FastLED: CRGB and the controller of the firmwares
+// --> addLeds() hands the LED array to the emulator, show() copies it to the
+//     rendered frames (hostemu.h)
+// --> CRGB is 3 bytes R, G, B as in FastLED
+// --> addLeds(data, offset, n) adds a strip of the array, each controller is
+//     one strip written in parallel with the others
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Host emulator
+// v1.1   15 Oct. 2026     Strips of one LED array
+//
+
+#ifndef FASTLED_H
+#define FASTLED_H
+
+#include "Arduino.h"
+
+struct CRGB
+{
+  uint8_t r;
+  uint8_t g;
+  uint8_t b;
+
+  CRGB() : r(0), g(0), b(0) {}
+  CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+  bool operator==(const CRGB& o) const { return r == o.r && g == o.g && b == o.b; }
+  bool operator!=(const CRGB& o) const { return !(*this == o); }
+};
+
+enum EOrder { RGB, RBG, GRB, GBR, BRG, BGR };
+
+template <uint8_t DATA_PIN, EOrder RGB_ORDER> class WS2812 {};
+
+class CFastLED
+{
+public:
+  template <template <uint8_t, EOrder> class CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+  CFastLED& addLeds(CRGB* data, int nLedsOrOffset, int nLedsIfOffset = 0)
+  {
+    static_assert(sizeof(CRGB) == 3, "CRGB must be 3 bytes");
+    if (nLedsIfOffset > 0)
+      hostemu::registerLeds(&data->r, nLedsOrOffset, nLedsIfOffset);
+    else
+      hostemu::registerLeds(&data->r, 0, nLedsOrOffset);
+    return *this;
+  }
+
+  void show() { hostemu::show(); }
+};
+
+extern CFastLED FastLED;
+
+#endif // FASTLED_H
@@ -0,0 +1,114 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// WiFi.h
+//
+// 1. Host shim of the ESP32 (and ESP8266) WiFi library
+// --> the soft AP calls succeed and do nothing
+// --> WiFiServer takes its connections from the emulator: localhost TCP
+//     port (-http) or HTTP requests of the script
+// --> WiFiClient buffers the response, it is sent when the firmware calls
+//     stop()
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Host emulator
+//
+
+#ifndef WIFI_H
+#define WIFI_H
+
+#include "Arduino.h"
+
+class WiFiClient : public Print
+{
+public:
+  WiFiClient() {}
+  explicit WiFiClient(const hostemu::ConnectionPtr& c) : conn(c) {}
+
+  int available() { return conn ? hostemu::httpAvailable(*conn) : 0; }
+  uint8_t connected() { return conn && conn->open && !conn->peerClosed; }
+  explicit operator bool() const { return conn && conn->open; }
+
+  int read()
+  {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+  }
+
+  int read(uint8_t* buf, size_t size)
+  {
+    if (!conn || available() <= 0)
+      return -1;
+    size_t n = conn->in.size() - conn->pos;
+    if (n > size)
+      n = size;
+    memcpy(buf, conn->in.data() + conn->pos, n);
+    conn->pos += n;
+    return (int)n;
+  }
+
+  using Print::write;
+  size_t write(const uint8_t* buf, size_t size)
+  {
+    if (!conn || !conn->open)
+      return 0;
+    conn->out.append((const char*)buf, size);
+    return size;
+  }
+
+  void flush() {}
+  void stop()
+  {
+    if (conn)
+      hostemu::httpClose(*conn);
+  }
+
+private:
+  hostemu::ConnectionPtr conn;
+};
+
+class WiFiServer
+{
+public:
+  explicit WiFiServer(uint16_t port) : port(port) {}
+  void begin() { hostemu::httpListen(port); }
+  WiFiClient available() { return WiFiClient(hostemu::httpAccept()); }
+
+private:
+  uint16_t port;
+};
+
+class WiFiClass
+{
+public:
+  bool softAPConfig(IPAddress ip, IPAddress, IPAddress) { apIP = ip; return true; }
+  bool softAP(const char*, const char* = NULL) { return true; }
+  IPAddress softAPIP() { return apIP; }
+
+private:
+  IPAddress apIP;
+};
+
+extern WiFiClass WiFi;
+
+#endif // WIFI_H
@@ -0,0 +1,16 @@
+// esp_idf_version.h
+//
+// 1. Host shim: the ESP-IDF version of the emulated ESP32 (Arduino-ESP32 3.x)
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Flash store of the emulator
+//
+
+#ifndef ESP_IDF_VERSION_H
+#define ESP_IDF_VERSION_H
+
+#define ESP_IDF_VERSION_MAJOR 5
+#define ESP_IDF_VERSION_MINOR 1
+#define ESP_IDF_VERSION_PATCH 0
+
+#endif // ESP_IDF_VERSION_H
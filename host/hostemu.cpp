@@ -0,0 +1,870 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// hostemu.cpp
+//
+// 1. Linux emulator of the MegaPix and BigPix firmwares
+// --> the sketch is compiled unchanged against the shims of host/, see
+//     inoproto.cpp, and linked with this file: setup() once, then loop()
+// --> virtual time: each loop() call costs -tick us, delay() moves the clock
+//     without waiting; ten minutes of show run in a few seconds, the same
+//     frames every time for the same -seed and script, so perf record /
+//     perf stat see the firmware code and nothing else
+// --> -show us: virtual cost of one FastLED.show(), the wire time of the
+//     LEDs (15400 for the 512 WS2812 of MegaPix), 0 by default; the strips
+//     of a firmware with several addLeds() are written in parallel, show()
+//     costs the share of the longest one
+// --> -realtime waits for real, to watch the show with -term
+// --> HTTP on a localhost TCP port, UDP (AsyncUDP) on a localhost UDP port:
+//     a browser, SendMotifUDP or livesend talk to the emulator as to the device
+// --> -script replays timed events, one per line, times in virtual ms:
+//       1000 http /B          request of the web page
+//       2500 upload anim.mpx  MPX file in mpxudp chunks
+//       4000 udp raw.bin      one datagram with the file content
+//       9000 end              stops the run
+// --> the LEDs shown by FastLED.show() are sampled at -fps in virtual time:
+//     PPM files frame000000.ppm... in a directory, or a PPM stream on stdout
+//     (-ppm -) that mpxconv -stream turns back into MPX; -term draws them in
+//     the terminal with ANSI colors
+// --> exit report: loop() calls and ns per call, show() calls and a hash of
+//     every shown frame, to compare two builds of the firmware
+// --> the flash partition "mpx" (esp_partition.h) is the file of -flash, kept
+//     from one run to the next, or a temporary file
+// --> FreeRTOS tasks are threads that take turns with loop(): each time the
+//     clock moves, the tasks that are due run until their next vTaskDelay(),
+//     one at a time, so the run stays repeatable; a firmware with tasks also
+//     gets the script events and UDP datagrams while loop() waits or shows
+//
+// usage: megapix-host [-ms n] [-loops n] [-tick us] [-show us] [-seed n] [-realtime]
+//                     [-http port] [-udp port] [-script file] [-flash file]
+//                     [-ppm dir | -ppm -] [-fps n] [-term] [-q]
+//        perf record -g ./megapix-host -ms 600000 -q
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Virtual time, LEDs, HTTP and UDP, script, PPM
+// v1.1   15 Oct. 2026     Flash partition in a file
+// v1.2   15 Oct. 2026     Virtual cost of show()
+// v1.3   15 Oct. 2026     FreeRTOS tasks
+// v1.4   15 Oct. 2026     Parallel LED strips
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Arduino.h"
+#include "FastLED.h"
+#include "WiFi.h"
+#include "AsyncUDP.h"
+#include "ledmap.h"
+#include "mpxudp.h"
+#include "mpxstore.h"
+#include "esp_partition.h"
+
+#define VERSION "v1.4  2026-10-15"
+
+// Geometry of the target, given by host/CMakeLists.txt
+#ifndef HOST_NAME
+#define HOST_NAME "MegaPix"
+#endif
+#ifndef HOST_WIDTH
+#define HOST_WIDTH  32           // pixels, serpentine lines
+#endif
+#ifndef HOST_HEIGHT
+#define HOST_HEIGHT 16
+#endif
+#ifndef HOST_LEDS_PER_PIXEL
+#define HOST_LEDS_PER_PIXEL 1    // BigPix: 3 LEDs side by side per pixel
+#endif
+#ifndef HOST_FLASH_KB
+#define HOST_FLASH_KB 1024       // "mpx" data partition
+#endif
+
+const int IMAGE_WIDTH  = HOST_WIDTH * HOST_LEDS_PER_PIXEL;
+const int IMAGE_HEIGHT = HOST_HEIGHT;
+
+// The sketch
+void setup();
+void loop();
+
+HardwareSerial Serial;
+CFastLED       FastLED;
+WiFiClass      WiFi;
+
+namespace hostemu
+{
+
+namespace
+{
+
+typedef std::chrono::steady_clock Clock;
+
+struct Options
+{
+  uint64_t    durationUs = 10000 * 1000ULL;
+  uint64_t    maxLoops = 0;              // 0 = no limit
+  uint64_t    tickUs = 100;              // virtual cost of one loop() call
+  uint64_t    showUs = 0;                // virtual cost of one show() call
+  uint32_t    seed = 1;
+  bool        realtime = false;
+  int         httpPort = 8080;           // 0 = no socket
+  int         udpPort = 2023;
+  const char* script = NULL;
+  const char* flash = NULL;              // NULL = temporary file
+  const char* ppm = NULL;                // directory or "-"
+  double      fps = 25;
+  bool        term = false;
+  bool        quiet = false;
+};
+
+enum EventKind { EV_HTTP, EV_UDP, EV_END };
+
+struct Event
+{
+  uint64_t             us;
+  EventKind            kind;
+  std::string          text;             // path or file name
+  std::vector<uint8_t> data;             // datagram
+};
+
+Options            opt;
+FILE*              console = stdout;     // stderr when PPM goes to stdout
+uint64_t           now = 0;              // virtual us
+uint64_t           delayedUs = 0;        // virtual us spent in delay()
+uint32_t           rnd = 1;
+Clock::time_point  wallStart;
+bool               stopped = false;
+volatile sig_atomic_t interrupted = 0;   // Ctrl-C, kill: report and exit
+
+uint8_t*             leds = NULL;
+int                  nbLeds = 0;
+int                  nbStrips = 0;
+int                  longestStrip = 0;    // LEDs
+std::vector<uint8_t> shown;              // LEDs at the last show()
+uint64_t             shows = 0;
+uint64_t             showHash = 1469598103934665603ULL;   // FNV-1a 64
+
+uint64_t             frameStepUs = 0;    // 0 = no sampling
+uint64_t             nextFrameUs = 0;
+int                  frames = 0;
+std::vector<uint8_t> image;
+
+int                       httpFd = -1;
+std::deque<ConnectionPtr> scripted;      // script requests not accepted yet
+int                       httpRequests = 0;
+size_t                    httpBytes = 0;
+
+AsyncUDP*            udpListener = NULL;
+int                  udpFd = -1;
+int                  udpPackets = 0;
+int                  udpReplies = 0;
+
+mpxstore::FileFlash  flash;              // "mpx" partition, opened on demand
+esp_partition_t      partition;
+
+struct Task
+{
+  void     (*fn)(void*);
+  void*    param;
+  uint64_t wakeUs;                       // due at
+  bool     ended;
+};
+
+std::vector<Task>        tasks;
+int                      running = -1;   // task that has the CPU, -1 = loop()
+std::mutex*              taskLock = new std::mutex;               // never freed,
+std::condition_variable* taskTurn = new std::condition_variable;  // tasks outlive main()
+
+std::vector<Event>   events;
+size_t               nextEvent = 0;
+uint16_t             session = 0x4000;   // mpxudp sessions of the script
+
+//
+// LEDs of the last show() as an RGB image, serpentine undone
+//
+void renderImage()
+{
+  image.assign((size_t)IMAGE_WIDTH * IMAGE_HEIGHT * 3, 0);
+  if (shown.empty())
+    return;
+  for (int y = 0; y < HOST_HEIGHT; y++)
+    for (int x = 0; x < HOST_WIDTH; x++)
+    {
+      int led = ledmap::position(y * HOST_WIDTH + x, HOST_WIDTH, HOST_HEIGHT, ledmap::SERPENTINE,
+                                 HOST_HEIGHT % nbStrips == 0 ? nbStrips : 1) * HOST_LEDS_PER_PIXEL;
+      for (int k = 0; k < HOST_LEDS_PER_PIXEL; k++)
+        if (led + k < nbLeds)
+          memcpy(&image[((size_t)y * IMAGE_WIDTH + x * HOST_LEDS_PER_PIXEL + k) * 3], &shown[(size_t)(led + k) * 3], 3);
+    }
+}
+
+void writePpm(FILE* fp)
+{
+  fprintf(fp, "P6\n%d %d\n255\n", IMAGE_WIDTH, IMAGE_HEIGHT);
+  fwrite(image.data(), 1, image.size(), fp);
+}
+
+//
+// Two pixel lines per text line: upper half block, foreground and background
+//
+void drawTerm()
+{
+  std::string text = "\x1b[H";
+  char esc[48];
+  for (int y = 0; y < IMAGE_HEIGHT; y += 2)
+  {
+    for (int x = 0; x < IMAGE_WIDTH; x++)
+    {
+      const uint8_t* up = &image[((size_t)y * IMAGE_WIDTH + x) * 3];
+      const uint8_t* dn = y + 1 < IMAGE_HEIGHT ? up + IMAGE_WIDTH * 3 : NULL;
+      snprintf(esc, sizeof(esc), "\x1b[38;2;%d;%d;%dm\x1b[48;2;%d;%d;%dm\xe2\x96\x80",
+               up[0], up[1], up[2], dn ? dn[0] : 0, dn ? dn[1] : 0, dn ? dn[2] : 0);
+      text += esc;
+    }
+    text += "\x1b[0m\n";
+  }
+  snprintf(esc, sizeof(esc), "%10.3f s\n", now / 1e6);
+  text += esc;
+  fputs(text.c_str(), console);
+  fflush(console);
+}
+
+void emitFrame()
+{
+  renderImage();
+  if (opt.ppm != NULL && strcmp(opt.ppm, "-") == 0)
+    writePpm(stdout);
+  else if (opt.ppm != NULL)
+  {
+    char name[1024];
+    snprintf(name, sizeof(name), "%s/frame%06d.ppm", opt.ppm, frames);
+    FILE* fp = fopen(name, "wb");
+    if (fp == NULL)
+    {
+      fprintf(console, "!!! cannot write %s !!!\n", name);
+      stopped = true;
+      return;
+    }
+    writePpm(fp);
+    fclose(fp);
+  }
+  if (opt.term)
+    drawTerm();
+  frames++;
+}
+
+//
+// Gives the CPU to task (-1 = loop()), returns when it comes back
+//
+void switchTo(int task)
+{
+  std::unique_lock<std::mutex> lock(*taskLock);
+  int self = running;
+  running = task;
+  taskTurn->notify_all();
+  taskTurn->wait(lock, [self] { return running == self; });
+}
+
+void taskMain(int index)
+{
+  {
+    std::unique_lock<std::mutex> lock(*taskLock);
+    taskTurn->wait(lock, [index] { return running == index; });
+  }
+  tasks[index].fn(tasks[index].param);
+  std::lock_guard<std::mutex> lock(*taskLock);
+  tasks[index].ended = true;
+  running = -1;
+  taskTurn->notify_all();
+}
+
+void runEvents();
+void pollUdp();
+
+//
+// Tasks due by now run in turn, only from loop(): a task that moves the
+// clock does not start the others
+//
+void runTasks()
+{
+  if (running != -1 || tasks.empty())
+    return;
+  runEvents();                           // network beside loop()
+  pollUdp();
+  for (size_t i = 0; i < tasks.size() && !stopped && !interrupted; i++)
+    if (!tasks[i].ended && tasks[i].wakeUs <= now)
+      switchTo((int)i);
+}
+
+//
+// Moves the virtual clock, emits the frames sampled on the way
+//
+void advance(uint64_t us)
+{
+  uint64_t target = now + us;
+  while (frameStepUs != 0 && nextFrameUs <= target && !stopped && !interrupted)
+  {
+    now = nextFrameUs;
+    emitFrame();
+    nextFrameUs += frameStepUs;
+  }
+  now = target;
+  if (opt.realtime)
+    std::this_thread::sleep_until(wallStart + std::chrono::microseconds(now));
+  runTasks();
+}
+
+void onSignal(int)
+{
+  interrupted = 1;
+}
+
+void setNonBlocking(int fd, bool on)
+{
+  int flags = fcntl(fd, F_GETFL, 0);
+  fcntl(fd, F_SETFL, on ? flags | O_NONBLOCK : flags & ~O_NONBLOCK);
+}
+
+int openSocket(int type, int port)
+{
+  int fd = socket(AF_INET, type, 0);
+  if (fd < 0)
+    return -1;
+  int yes = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons((uint16_t)port);
+  if (bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0 || (type == SOCK_STREAM && listen(fd, 8) < 0))
+  {
+    close(fd);
+    return -1;
+  }
+  setNonBlocking(fd, true);
+  return fd;
+}
+
+ConnectionPtr newConnection(int fd)
+{
+  Connection* c = new Connection;
+  c->fd = fd;
+  c->pos = 0;
+  c->peerClosed = false;
+  c->open = true;
+  return ConnectionPtr(c, [](Connection* p) { if (p->fd >= 0) close(p->fd); delete p; });
+}
+
+bool readFile(const std::string& name, std::vector<uint8_t>& data)
+{
+  FILE* fp = fopen(name.c_str(), "rb");
+  if (fp == NULL)
+    return false;
+  uint8_t buf[4096];
+  size_t  n;
+  data.clear();
+  while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+    data.insert(data.end(), buf, buf + n);
+  fclose(fp);
+  return true;
+}
+
+//
+// Script: "ms command argument" lines, files relative to the script
+//
+bool loadScript(const char* name)
+{
+  FILE* fp = fopen(name, "r");
+  if (fp == NULL)
+  {
+    fprintf(console, "!!! cannot read %s !!!\n", name);
+    return false;
+  }
+  std::string dir = name;
+  size_t slash = dir.rfind('/');
+  dir = slash == std::string::npos ? "" : dir.substr(0, slash + 1);
+
+  char line[1024];
+  int  nb = 0;
+  while (fgets(line, sizeof(line), fp))
+  {
+    nb++;
+    char command[32], arg[960];
+    unsigned long ms;
+    arg[0] = 0;
+    if (line[0] == '#' || sscanf(line, "%lu %31s %959s", &ms, command, arg) < 2)
+      continue;
+
+    Event ev;
+    ev.us = (uint64_t)ms * 1000;
+    ev.text = arg;
+    std::string file = arg[0] == '/' ? std::string(arg) : dir + arg;
+    if (strcmp(command, "http") == 0 && arg[0] != 0)
+    {
+      ev.kind = EV_HTTP;
+      events.push_back(ev);
+    }
+    else if (strcmp(command, "end") == 0)
+    {
+      ev.kind = EV_END;
+      events.push_back(ev);
+    }
+    else if ((strcmp(command, "udp") == 0 || strcmp(command, "upload") == 0) && readFile(file, ev.data))
+    {
+      ev.kind = EV_UDP;
+      if (command[1] == 'd')
+        events.push_back(ev);
+      else
+      {
+        std::vector<uint8_t> content = ev.data;
+        int      count = mpxudp::chunkCount(content.size());
+        uint32_t crc = mpxudp::crc32(content.data(), content.size());
+        session++;
+        for (int i = 0; i < count; i++)
+        {
+          ev.data.resize(mpxudp::PACKET_SIZE);
+          ev.data.resize(mpxudp::makePacket(ev.data.data(), mpxudp::DATA, session, i,
+                                            content.data(), content.size(), crc));
+          events.push_back(ev);
+        }
+      }
+    }
+    else
+    {
+      fprintf(console, "!!! %s line %d: %s !!!\n", name, nb, line);
+      fclose(fp);
+      return false;
+    }
+  }
+  fclose(fp);
+  std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& b) { return a.us < b.us; });
+  return true;
+}
+
+void deliver(uint8_t* data, size_t len, const UdpPeer& peer)
+{
+  if (udpListener == NULL)
+    return;
+  AsyncUDPPacket packet(data, len, peer);
+  udpListener->receive(packet);
+  udpPackets++;
+}
+
+void runEvents()
+{
+  while (nextEvent < events.size() && events[nextEvent].us <= now)
+  {
+    Event& ev = events[nextEvent++];
+    if (ev.kind == EV_END)
+      stopped = true;
+    else if (ev.kind == EV_HTTP)
+    {
+      ConnectionPtr c = newConnection(-1);
+      c->in = "GET " + ev.text + " HTTP/1.1\r\nHost: " HOST_NAME "\r\n\r\n";
+      c->peerClosed = true;
+      c->path = ev.text;
+      scripted.push_back(c);
+    }
+    else
+    {
+      UdpPeer none = { false, 0, 0 };
+      deliver(ev.data.data(), ev.data.size(), none);
+    }
+  }
+}
+
+void pollUdp()
+{
+  if (udpFd < 0)
+    return;
+  uint8_t buf[2048];
+  for (;;)
+  {
+    sockaddr_in from;
+    socklen_t   fromLen = sizeof(from);
+    ssize_t n = recvfrom(udpFd, buf, sizeof(buf), 0, (sockaddr*)&from, &fromLen);
+    if (n < 0)
+      return;
+    UdpPeer peer = { true, from.sin_addr.s_addr, ntohs(from.sin_port) };
+    deliver(buf, (size_t)n, peer);
+  }
+}
+
+} // namespace
+
+uint64_t nowUs() { return now; }
+
+void sleepUs(uint64_t us)
+{
+  delayedUs += us;
+  advance(us);
+}
+
+uint32_t randomNext()
+{
+  rnd ^= rnd << 13;                      // xorshift32
+  rnd ^= rnd >> 17;
+  rnd ^= rnd << 5;
+  return rnd;
+}
+
+void randomSeed(uint32_t seed) { rnd = seed != 0 ? seed : 1; }
+
+void taskCreate(void (*fn)(void*), void* param)
+{
+  Task task = { fn, param, now, false };
+  tasks.push_back(task);
+  std::thread(taskMain, (int)tasks.size() - 1).detach();
+}
+
+void taskDelay(uint64_t us)
+{
+  if (running < 0)
+  {
+    sleepUs(us);
+    return;
+  }
+  tasks[running].wakeUs = now + us;
+  switchTo(-1);
+}
+
+void serialWrite(const char* text, size_t len)
+{
+  if (!opt.quiet && !opt.term)
+    fwrite(text, 1, len, console);
+}
+
+void registerLeds(uint8_t* rgb, int offset, int count)
+{
+  if (leds != NULL && rgb != leds)
+  {
+    fprintf(console, "!!! the LED strips must be slices of one array !!!\n");
+    exit(1);
+  }
+  leds = rgb;
+  nbLeds = std::max(nbLeds, offset + count);
+  nbStrips++;
+  longestStrip = std::max(longestStrip, count);
+  shown.assign((size_t)nbLeds * 3, 0);
+}
+
+void show()
+{
+  if (leds == NULL)
+    return;
+  memcpy(shown.data(), leds, shown.size());
+  for (size_t i = 0; i < shown.size(); i++)
+    showHash = (showHash ^ shown[i]) * 1099511628211ULL;
+  shows++;
+  advance(opt.showUs * longestStrip / nbLeds);   // the LEDs are written meanwhile
+}
+
+void httpListen(uint16_t port)
+{
+  if (opt.httpPort == 0 || httpFd >= 0)
+    return;
+  httpFd = openSocket(SOCK_STREAM, opt.httpPort);
+  if (httpFd < 0)
+    fprintf(console, "!!! HTTP port %d: %s !!!\n", opt.httpPort, strerror(errno));
+  else if (!opt.quiet)
+    fprintf(console, "HTTP of port %d on http://127.0.0.1:%d/\n", port, opt.httpPort);
+}
+
+ConnectionPtr httpAccept()
+{
+  if (!scripted.empty())
+  {
+    ConnectionPtr c = scripted.front();
+    scripted.pop_front();
+    return c;
+  }
+  if (httpFd < 0)
+    return ConnectionPtr();
+  int fd = accept(httpFd, NULL, NULL);
+  if (fd < 0)
+    return ConnectionPtr();
+  setNonBlocking(fd, true);
+  return newConnection(fd);
+}
+
+//
+// A socket with nothing to read waits 1 ms of wall time for the client and
+// moves the clock by 1 ms, the timeouts of the firmware still expire
+//
+int httpAvailable(Connection& conn)
+{
+  if (conn.fd >= 0 && conn.pos == conn.in.size() && !conn.peerClosed)
+  {
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+      char    buf[1024];
+      ssize_t n = recv(conn.fd, buf, sizeof(buf), 0);
+      if (n > 0)
+      {
+        conn.in.append(buf, (size_t)n);
+        break;
+      }
+      if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+      {
+        conn.peerClosed = true;
+        break;
+      }
+      if (attempt == 0)
+      {
+        pollfd p = { conn.fd, POLLIN, 0 };
+        poll(&p, 1, 1);
+        advance(1000);
+      }
+    }
+  }
+  return (int)(conn.in.size() - conn.pos);
+}
+
+void httpClose(Connection& conn)
+{
+  if (!conn.open)
+    return;
+  conn.open = false;
+  httpRequests++;
+  httpBytes += conn.out.size();
+  if (conn.fd >= 0)
+  {
+    setNonBlocking(conn.fd, false);
+    size_t sent = 0;
+    while (sent < conn.out.size())
+    {
+      ssize_t n = send(conn.fd, conn.out.data() + sent, conn.out.size() - sent, MSG_NOSIGNAL);
+      if (n <= 0)
+        break;
+      sent += (size_t)n;
+    }
+    close(conn.fd);
+    conn.fd = -1;
+  }
+  else if (!opt.quiet && !opt.term)
+    fprintf(console, "[%llu ms] http %s -> %u bytes\n", (unsigned long long)(now / 1000),
+            conn.path.c_str(), (unsigned)conn.out.size());
+}
+
+void udpListen(AsyncUDP* listener, uint16_t port)
+{
+  udpListener = listener;
+  if (opt.udpPort == 0 || udpFd >= 0)
+    return;
+  udpFd = openSocket(SOCK_DGRAM, opt.udpPort);
+  if (udpFd < 0)
+    fprintf(console, "!!! UDP port %d: %s !!!\n", opt.udpPort, strerror(errno));
+  else if (!opt.quiet)
+    fprintf(console, "UDP of port %d on 127.0.0.1:%d\n", port, opt.udpPort);
+}
+
+size_t udpReply(const UdpPeer& peer, const uint8_t* data, size_t len)
+{
+  udpReplies++;
+  if (!peer.valid || udpFd < 0)
+    return len;
+  sockaddr_in to;
+  memset(&to, 0, sizeof(to));
+  to.sin_family = AF_INET;
+  to.sin_addr.s_addr = peer.addr;
+  to.sin_port = htons(peer.port);
+  ssize_t n = sendto(udpFd, data, len, 0, (sockaddr*)&to, sizeof(to));
+  return n < 0 ? 0 : (size_t)n;
+}
+
+} // namespace hostemu
+
+using namespace hostemu;
+
+//
+// ESP-IDF partition API: the "mpx" data partition only
+//
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype,
+                                                const char* label)
+{
+  if (type != ESP_PARTITION_TYPE_DATA || (label ? strcmp(label, "mpx") != 0 : subtype != ESP_PARTITION_SUBTYPE_ANY))
+    return NULL;
+  if (flash.size() == 0)
+  {
+    if (!flash.begin(opt.flash, HOST_FLASH_KB * 1024))
+    {
+      fprintf(console, "!!! flash %s: %s !!!\n", opt.flash ? opt.flash : "(temporary)", strerror(errno));
+      return NULL;
+    }
+    partition.type = ESP_PARTITION_TYPE_DATA;
+    partition.subtype = (esp_partition_subtype_t)0x40;
+    partition.address = 0x210000;
+    partition.size = flash.size();
+    strcpy(partition.label, "mpx");
+    partition.encrypted = false;
+  }
+  return &partition;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* part, size_t offset, void* dst, size_t size)
+{
+  if (part != &partition || offset > part->size || size > part->size - offset)
+    return ESP_ERR_INVALID_SIZE;
+  memcpy(dst, flash.map() + offset, size);
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t* part, size_t offset, const void* src, size_t size)
+{
+  if (part != &partition)
+    return ESP_ERR_INVALID_ARG;
+  return flash.write((uint32_t)offset, src, (uint32_t)size) ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* part, size_t offset, size_t size)
+{
+  if (part != &partition)
+    return ESP_ERR_INVALID_ARG;
+  return flash.erase((uint32_t)offset, (uint32_t)size) ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t* part, size_t offset, size_t size,
+                             esp_partition_mmap_memory_t memory, const void** out,
+                             esp_partition_mmap_handle_t* handle)
+{
+  if (part != &partition || memory != ESP_PARTITION_MMAP_DATA || offset > part->size ||
+      size > part->size - offset)
+    return ESP_ERR_INVALID_ARG;
+  *out = flash.map() + offset;
+  *handle = 1;
+  return ESP_OK;
+}
+
+void esp_partition_munmap(esp_partition_mmap_handle_t) {}
+
+int main(int argc, char** argv)
+{
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-ms") == 0 && i + 1 < argc)
+      opt.durationUs = strtoull(argv[++i], NULL, 10) * 1000;
+    else if (strcmp(argv[i], "-loops") == 0 && i + 1 < argc)
+      opt.maxLoops = strtoull(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "-tick") == 0 && i + 1 < argc)
+      opt.tickUs = strtoull(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "-show") == 0 && i + 1 < argc)
+      opt.showUs = strtoull(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "-seed") == 0 && i + 1 < argc)
+      opt.seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "-realtime") == 0)
+      opt.realtime = true;
+    else if (strcmp(argv[i], "-http") == 0 && i + 1 < argc)
+      opt.httpPort = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-udp") == 0 && i + 1 < argc)
+      opt.udpPort = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-script") == 0 && i + 1 < argc)
+      opt.script = argv[++i];
+    else if (strcmp(argv[i], "-flash") == 0 && i + 1 < argc)
+      opt.flash = argv[++i];
+    else if (strcmp(argv[i], "-ppm") == 0 && i + 1 < argc)
+      opt.ppm = argv[++i];
+    else if (strcmp(argv[i], "-fps") == 0 && i + 1 < argc)
+      opt.fps = atof(argv[++i]);
+    else if (strcmp(argv[i], "-term") == 0)
+      opt.term = true;
+    else if (strcmp(argv[i], "-q") == 0)
+      opt.quiet = true;
+    else
+    {
+      printf("%s %s, " HOST_NAME " firmware on Linux\n", argv[0], VERSION);
+      printf("syntaxe: %s [-ms n] [-loops n] [-tick us] [-show us] [-seed n] [-realtime]\n", argv[0]);
+      printf("         [-http port] [-udp port] [-script file] [-flash file]\n");
+      printf("         [-ppm dir | -ppm -] [-fps n] [-term] [-q]\n");
+      return 1;
+    }
+  }
+  if (opt.ppm != NULL && strcmp(opt.ppm, "-") == 0)
+    console = stderr;
+  if (opt.ppm != NULL && strcmp(opt.ppm, "-") != 0)
+    mkdir(opt.ppm, 0777);
+  if ((opt.ppm != NULL || opt.term) && opt.fps > 0)
+    frameStepUs = (uint64_t)(1e6 / opt.fps + 0.5);
+  setvbuf(console, NULL, _IOLBF, 0);
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  if (opt.term)
+    fputs("\x1b[2J", console);
+  if (!opt.quiet)
+    fprintf(console, "%s %s, " HOST_NAME " firmware on Linux\n\n", argv[0], VERSION);
+  if (opt.script != NULL && !loadScript(opt.script))
+    return 1;
+  hostemu::randomSeed(opt.seed);
+
+  wallStart = Clock::now();
+  setup();
+  uint64_t setupUs = now;
+
+  uint64_t loops = 0;
+  uint64_t loopNs = 0;
+  uint64_t maxNs = 0;
+  while (!stopped && !interrupted && now < setupUs + opt.durationUs && (opt.maxLoops == 0 || loops < opt.maxLoops))
+  {
+    runEvents();
+    pollUdp();
+    Clock::time_point t0 = Clock::now();
+    loop();
+    uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count();
+    loopNs += ns;
+    maxNs = std::max(maxNs, ns);
+    loops++;
+    advance(opt.tickUs);
+  }
+  double wallMs = std::chrono::duration<double, std::milli>(Clock::now() - wallStart).count();
+
+  if (opt.term)
+    fputs("\n", console);
+  fprintf(console, "\nvirtual time  : %llu ms, %llu ms in delay()\n",
+          (unsigned long long)(now / 1000), (unsigned long long)(delayedUs / 1000));
+  fprintf(console, "loop() calls  : %llu, %.0f ns average, %llu ns max\n",
+          (unsigned long long)loops, loops ? (double)loopNs / loops : 0.0, (unsigned long long)maxNs);
+  fprintf(console, "show() calls  : %llu, hash %016llx\n",
+          (unsigned long long)shows, (unsigned long long)showHash);
+  fprintf(console, "frames        : %d\n", frames);
+  fprintf(console, "http / udp    : %d requests %u bytes, %d packets %d replies\n",
+          httpRequests, (unsigned)httpBytes, udpPackets, udpReplies);
+  fprintf(console, "wall time     : %.0f ms, x%.0f real time\n", wallMs, wallMs > 0 ? now / 1e3 / wallMs : 0.0);
+  return 0;
+}
@@ -0,0 +1,119 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// hostemu.h
+//
+// 1. Runtime of the firmware emulator, behind the Arduino shims of host/
+// --> virtual clock: millis() and micros() read it, delay() and each loop()
+//     call move it forward, nothing waits unless -realtime is given
+// --> the LED array registered by FastLED.addLeds(), in one or more strips,
+//     a copy at each show()
+// --> HTTP connections: a localhost TCP socket or a request of the script
+// --> UDP datagrams: a localhost UDP socket or a packet of the script, given
+//     to the AsyncUDP handler between two loop() calls
+// --> tasks of the firmware: one thread each, but only one thread runs at a
+//     time, so a run is still repeatable: when the clock moves, loop() lets
+//     each task that is due run until its next taskDelay()
+// --> hostemu.cpp holds the runtime and main(), plain C++11
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Virtual time, LEDs, HTTP and UDP
+// v1.1   15 Oct. 2026     Tasks
+// v1.2   15 Oct. 2026     LED strips
+//
+
+#ifndef HOSTEMU_H
+#define HOSTEMU_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <memory>
+#include <string>
+
+class AsyncUDP;
+
+namespace hostemu
+{
+
+//
+// Clock
+//
+uint64_t nowUs();
+void     sleepUs(uint64_t us);           // delay(), virtual unless -realtime
+uint32_t randomNext();                   // deterministic, -seed
+void     randomSeed(uint32_t seed);
+
+//
+// Tasks (xTaskCreatePinnedToCore), taskDelay() out of a task is sleepUs()
+//
+void taskCreate(void (*fn)(void*), void* param);
+void taskDelay(uint64_t us);
+
+//
+// Console, Serial goes there unless -q
+//
+void serialWrite(const char* text, size_t len);
+
+//
+// LEDs
+//
+void registerLeds(uint8_t* rgb, int offset, int count);   // one strip of the array
+void show();
+
+//
+// HTTP connection, socket or script
+//
+struct Connection
+{
+  int         fd;                        // -1 for a script request
+  std::string in;                        // received bytes
+  size_t      pos;                       // next byte to read
+  std::string out;                       // response, sent by close()
+  bool        peerClosed;
+  bool        open;
+  std::string path;                      // script request, for the report
+};
+
+typedef std::shared_ptr<Connection> ConnectionPtr;
+
+void          httpListen(uint16_t port);
+ConnectionPtr httpAccept();              // NULL when nobody waits
+int           httpAvailable(Connection& conn);
+void          httpClose(Connection& conn);
+
+//
+// UDP
+//
+struct UdpPeer
+{
+  bool     valid;                        // false for a script packet
+  uint32_t addr;                         // network order
+  uint16_t port;
+};
+
+void   udpListen(AsyncUDP* listener, uint16_t port);
+size_t udpReply(const UdpPeer& peer, const uint8_t* data, size_t len);
+
+} // namespace hostemu
+
+#endif // HOSTEMU_H
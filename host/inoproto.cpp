@@ -0,0 +1,203 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// inoproto.cpp
+//
+// 1. Sketch to C++ translation unit, as the Arduino builder does it
+// --> prepends #include <Arduino.h>
+// --> finds the function definitions at the top level of the sketch and
+//     declares them after the last #include that precedes the first one
+// --> #line directives keep the compiler messages, gdb and perf on the
+//     lines of the .ino
+// --> comments, strings and character constants are skipped, so braces in
+//     them do not count
+//
+// usage: inoproto sketch.ino out.cpp
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Prototypes of the sketch functions
+//
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+//
+// Declaration text of a top level '{': a function header, or empty when the
+// brace opens a struct, an array initializer, a namespace...
+//
+static std::string functionHeader(std::string text)
+{
+  size_t first = text.find_first_not_of(" \t\n");
+  size_t last = text.find_last_not_of(" \t\n");
+  if (first == std::string::npos)
+    return "";
+  text = text.substr(first, last - first + 1);
+  if (text.empty() || text.back() != ')' || text.find('(') == std::string::npos)
+    return "";
+  size_t paren = text.find('(');
+  if (text.find('=') < paren)
+    return "";
+  static const char* keywords[] = { "struct", "class", "namespace", "enum", "union",
+                                    "typedef", "template", "if", "while", "for", "switch" };
+  for (const char* k : keywords)
+    if (text.compare(0, strlen(k), k) == 0 && !isalnum((unsigned char)text[strlen(k)]))
+      return "";
+  std::string out;
+  for (char c : text)                    // one line
+    if (c == '\n' || c == '\t')
+      out += ' ';
+    else
+      out += c;
+  return out;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc != 3)
+  {
+    printf("syntaxe: %s sketch.ino out.cpp\n", argv[0]);
+    return 1;
+  }
+  FILE* fp = fopen(argv[1], "rb");
+  if (fp == NULL)
+  {
+    printf("!!! cannot read %s !!!\n", argv[1]);
+    return 1;
+  }
+  std::string src;
+  for (int c; (c = getc(fp)) != EOF; )
+    if (c != '\r')
+      src += (char)c;
+  fclose(fp);
+
+  std::vector<std::string> protos;
+  std::string decl;                      // code since the last ; { } or directive
+  int  depth = 0;
+  int  line = 1;
+  int  lastInclude = 0;                  // line following the last #include
+  int  firstFunction = 0;
+  bool lineStart = true;
+
+  for (size_t i = 0; i < src.size(); i++)
+  {
+    char c = src[i];
+    if (c == '/' && i + 1 < src.size() && src[i + 1] == '/')
+    {
+      while (i < src.size() && src[i] != '\n')
+        i++;
+      i--;
+      continue;
+    }
+    if (c == '/' && i + 1 < src.size() && src[i + 1] == '*')
+    {
+      size_t end = src.find("*/", i + 2);
+      end = end == std::string::npos ? src.size() : end + 2;
+      for (; i < end; i++)
+        line += src[i] == '\n';
+      i--;
+      decl += ' ';
+      continue;
+    }
+    if (c == '"' || c == '\'')
+    {
+      for (i++; i < src.size() && src[i] != c; i++)
+        if (src[i] == '\\')
+          i++;
+      if (depth == 0)
+        decl += "\"\"";
+      continue;
+    }
+    if (c == '#' && lineStart)           // directive, with its continuations
+    {
+      size_t end = i;
+      while (end < src.size() && src[end] != '\n')
+        end += src[end] == '\\' ? 2 : 1;
+      if (depth == 0 && src.compare(i, 8, "#include") == 0 && firstFunction == 0)
+        lastInclude = line + 1;
+      for (; i < end; i++)
+        line += src[i] == '\n';
+      i--;
+      continue;
+    }
+    if (c == '\n')
+    {
+      line++;
+      lineStart = true;
+    }
+    else if (c != ' ' && c != '\t')
+      lineStart = false;
+
+    if (c == '{')
+    {
+      if (depth == 0)
+      {
+        std::string header = functionHeader(decl);
+        if (!header.empty())
+        {
+          protos.push_back(header + ";");
+          if (firstFunction == 0)
+            firstFunction = line;
+        }
+      }
+      depth++;
+      decl.clear();
+    }
+    else if (c == '}')
+    {
+      depth--;
+      decl.clear();
+    }
+    else if (c == ';')
+      decl.clear();
+    else if (depth == 0)
+      decl += c;
+  }
+
+  // output: the sketch with the prototypes after its includes
+  FILE* out = fopen(argv[2], "w");
+  if (out == NULL)
+  {
+    printf("!!! cannot write %s !!!\n", argv[2]);
+    return 1;
+  }
+  fprintf(out, "#include <Arduino.h>\n#line 1 \"%s\"\n", argv[1]);
+  size_t pos = 0;
+  for (int l = 1; pos < src.size(); l++)
+  {
+    size_t end = src.find('\n', pos);
+    end = end == std::string::npos ? src.size() : end + 1;
+    if (l == lastInclude)
+    {
+      for (const std::string& p : protos)
+        fprintf(out, "%s\n", p.c_str());
+      fprintf(out, "#line %d \"%s\"\n", l, argv[1]);
+    }
+    fwrite(src.data() + pos, 1, end - pos, out);
+    pos = end;
+  }
+  fclose(out);
+  return 0;
+}
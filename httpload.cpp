@@ -0,0 +1,452 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// httpload.cpp
+//
+// 1. Host load test of the firmware HTTP request reader (httpreq.h), Linux
+// --> a localhost TCP server stands in for the WiFiServer, its SocketClient
+//     has the WiFiClient calls used by http::readRequest()
+// --> the route table is the BigPix one, handlers count their requests
+// --> client threads send browser-like requests cut in random chunks and
+//     check the counts, reports requests/s and latency
+// --> parse cost per request against the former String + endsWith() chain,
+//     with the number of heap allocations of each
+//
+// usage: httpload [requests] [threads]
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Request parser load test
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <random>
+#include <thread>
+#include <vector>
+#include "httpreq.h"
+
+#define VERSION "v1.0  2026-10-15"
+
+#define HTTP_TIMEOUT_MS 2000
+#define MIN_BENCH_SEC   0.25
+
+typedef std::chrono::steady_clock Clock;
+
+static std::atomic<long> allocations(0);   // heap allocations of the process
+
+void* operator new(size_t size)
+{
+  allocations++;
+  void* p = malloc(size ? size : 1);
+  if (p == NULL)
+    throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept
+{
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  free(p);
+}
+
+static unsigned long nowMs()
+{
+  return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+           Clock::now().time_since_epoch()).count();
+}
+
+static void waitMs()
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+//
+// WiFiClient stand-in over a connected socket
+//
+class SocketClient
+{
+public:
+  explicit SocketClient(int fd) : fd(fd) {}
+
+  int available()
+  {
+    int nb = 0;
+    if (fd < 0 || ioctl(fd, FIONREAD, &nb) < 0)
+      return 0;
+    return nb;
+  }
+
+  bool connected()
+  {
+    char c;
+    if (fd < 0)
+      return false;
+    ssize_t nb = recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    return nb > 0 || (nb < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+  }
+
+  int read(uint8_t* buf, size_t size)
+  {
+    return (int)recv(fd, buf, size, 0);
+  }
+
+  void print(const char* text)
+  {
+    send(fd, text, strlen(text), MSG_NOSIGNAL);
+  }
+
+  void stop()
+  {
+    if (fd >= 0)
+      close(fd);
+    fd = -1;
+  }
+
+private:
+  int fd;
+};
+
+//
+// BigPix routes, each handler counts its requests
+//
+static const char* const paths[] = {
+  "/favicon.ico", "/Z", "/I", "/B", "/Bp", "/G", "/M", "/E", "/Mx", "/Wa",
+  "/S", "/A", "/T", "/t", "/X", "/R", "/F"
+};
+const int NB_ROUTES = sizeof(paths) / sizeof(paths[0]);
+
+static std::atomic<long> hits[NB_ROUTES];
+static char lastText[http::LINE_SIZE];
+
+template <int N>
+static void countRoute(const char* arg)
+{
+  hits[N]++;
+  if (paths[N][1] == 'T' || paths[N][1] == 't')
+    strncpy(lastText, arg, sizeof(lastText) - 1);
+}
+
+static const http::Route routes[NB_ROUTES] = {
+  { paths[0],  true,  countRoute<0> },  { paths[1],  false, countRoute<1> },
+  { paths[2],  false, countRoute<2> },  { paths[3],  false, countRoute<3> },
+  { paths[4],  false, countRoute<4> },  { paths[5],  false, countRoute<5> },
+  { paths[6],  false, countRoute<6> },  { paths[7],  false, countRoute<7> },
+  { paths[8],  false, countRoute<8> },  { paths[9],  false, countRoute<9> },
+  { paths[10], false, countRoute<10> }, { paths[11], false, countRoute<11> },
+  { paths[12], true,  countRoute<12> }, { paths[13], true,  countRoute<13> },
+  { paths[14], false, countRoute<14> }, { paths[15], false, countRoute<15> },
+  { paths[16], false, countRoute<16> },
+};
+
+//
+// Browser-like request for one route
+//
+static int makeRequest(char* out, size_t cap, int route)
+{
+  const char* arg = (paths[route][1] == 'T' || paths[route][1] == 't') ? "HELLO.WORLD" : "";
+  return snprintf(out, cap,
+    "GET %s%s HTTP/1.1\r\n"
+    "Host: 10.1.1.1\r\n"
+    "Connection: keep-alive\r\n"
+    "Upgrade-Insecure-Requests: 1\r\n"
+    "User-Agent: Mozilla/5.0 (Linux; Android 13; Pixel 7) AppleWebKit/537.36 "
+    "(KHTML, like Gecko) Chrome/118.0.0.0 Mobile Safari/537.36\r\n"
+    "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,"
+    "image/webp,*/*;q=0.8\r\n"
+    "Referer: http://10.1.1.1/Mx\r\n"
+    "Accept-Encoding: gzip, deflate\r\n"
+    "Accept-Language: fr-FR,fr;q=0.9,en-US;q=0.8,en;q=0.7\r\n"
+    "\r\n", paths[route], arg);
+}
+
+//
+// Server side, the loop() of the firmware without the display
+//
+static void serve(int listenFd, std::atomic<bool>& stop, long& served, long& dropped)
+{
+  static http::RequestParser request;
+
+  while (!stop)
+  {
+    int fd = accept(listenFd, NULL, NULL);
+    if (fd < 0)
+      continue;
+    SocketClient client(fd);
+    if (http::readRequest(client, request, nowMs, HTTP_TIMEOUT_MS, waitMs))
+    {
+      http::dispatch(routes, NB_ROUTES, request.path());
+      client.print("HTTP/1.1 200 OK\r\nContent-type:text/html\r\n\r\nok\r\n\r\n");
+      served++;
+    }
+    else
+      dropped++;
+    client.stop();
+  }
+}
+
+//
+// Client side, nbRequests requests cut in chunks of 1 to 64 bytes
+//
+static void load(int port, int nbRequests, unsigned seed, long* expected,
+                 std::vector<double>& latencies)
+{
+  std::mt19937 rng(seed);
+  char req[1024];
+  char resp[256];
+
+  for (int n = 0; n < nbRequests; n++)
+  {
+    int route = (int)(rng() % NB_ROUTES);
+    int len = makeRequest(req, sizeof(req), route);
+    Clock::time_point start = Clock::now();
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0)
+    {
+      close(fd);
+      continue;
+    }
+    for (int sent = 0; sent < len; )
+    {
+      int chunk = std::min(len - sent, 1 + (int)(rng() % 64));
+      ssize_t nb = send(fd, req + sent, chunk, MSG_NOSIGNAL);
+      if (nb <= 0)
+        break;
+      sent += (int)nb;
+    }
+    while (recv(fd, resp, sizeof(resp), 0) > 0)
+      ;                                  // until the server closes
+    close(fd);
+    latencies.push_back(std::chrono::duration<double>(Clock::now() - start).count());
+    expected[route]++;
+  }
+}
+
+//
+// Arduino String as used by the former loop(): one realloc per +=
+//
+struct ArduinoString
+{
+  char*  buf = NULL;
+  size_t len = 0;
+
+  ~ArduinoString() { free(buf); }
+  void clear() { len = 0; if (buf) buf[0] = '\0'; }
+  void append(char c)
+  {
+    buf = (char*)realloc(buf, len + 2);
+    allocations++;
+    buf[len++] = c;
+    buf[len] = '\0';
+  }
+  bool endsWith(const char* s) const
+  {
+    size_t n = strlen(s);
+    return len >= n && memcmp(buf + len - n, s, n) == 0;
+  }
+};
+
+static const char* const legacy[] = {
+  "GET /favicon.ico", "GET /Z ", "GET /I ", "GET /B ", "GET /Bp ", "GET /G ",
+  "GET /M ", "GET /E ", "GET /Mx ", "GET /Wa ", "GET /S ", "GET /A ", "GET /T",
+  "GET /t", "GET /X ", "GET /R ", "GET /F "
+};
+
+//
+// Former byte by byte parsing, returns the route found
+//
+static int legacyParse(const char* req, size_t len)
+{
+  ArduinoString currentLine;
+  int route = -1;
+
+  for (size_t i = 0; i < len; i++)
+  {
+    char c = req[i];
+    if (c == '\n')
+    {
+      if (currentLine.len == 0)
+        break;
+      currentLine.clear();
+    }
+    else if (c != '\r')
+      currentLine.append(c);
+    for (int r = 0; r < NB_ROUTES && route < 0; r++)
+      if (currentLine.endsWith(legacy[r]))
+        route = r;
+  }
+  return route;
+}
+
+template <class F>
+static double timeIt(F f)
+{
+  long calls = 0;
+  double elapsed = 0;
+  Clock::time_point start = Clock::now();
+
+  do
+  {
+    for (int i = 0; i < 64; i++)
+      f();
+    calls += 64;
+    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  } while (elapsed < MIN_BENCH_SEC);
+  return elapsed / calls;
+}
+
+static volatile int benchSink;
+
+int main(int argc, char** argv)
+{
+  int nbRequests = argc > 1 ? atoi(argv[1]) : 2000;
+  int nbThreads  = argc > 2 ? atoi(argv[2]) : 4;
+  int failures = 0;
+
+  printf("%s %s\n\n", argv[0], VERSION);
+
+  // parse cost, in memory
+  printf("%-8s %6s | %11s %11s | %11s %11s | %s\n", "parse", "bytes",
+         "table ns", "allocs", "String ns", "allocs", "route");
+  static const int sample[] = { 1, 9, 4, 12, 16 };
+  for (int route : sample)
+  {
+    char req[1024];
+    int len = makeRequest(req, sizeof(req), route);
+    static http::RequestParser parser;
+    int found = -1;
+
+    long a0 = allocations;
+    parser.reset();
+    parser.feed(req, len);
+    found = http::dispatch(routes, NB_ROUTES, parser.path());
+    long tableAllocs = allocations - a0;
+    a0 = allocations;
+    int oldFound = legacyParse(req, len);
+    long oldAllocs = allocations - a0;
+
+    double ttable = timeIt([&]()
+    {
+      parser.reset();
+      parser.feed(req, len);
+      benchSink = http::dispatch(routes, NB_ROUTES, parser.path());
+    });
+    double tlegacy = timeIt([&]()
+    {
+      benchSink = legacyParse(req, len);
+    });
+    bool same = found == route && oldFound == route;
+    if (!same)
+      failures++;
+    printf("%-8s %6d | %11.0f %11ld | %11.0f %11ld | %s\n", paths[route], len,
+           ttable * 1e9, tableAllocs, tlegacy * 1e9, oldAllocs, same ? "same" : "FAILED");
+  }
+  for (int r = 0; r < NB_ROUTES; r++)
+    hits[r] = 0;
+
+  // load test over localhost
+  int listenFd = socket(AF_INET, SOCK_STREAM, 0);
+  int one = 1;
+  setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t addrLen = sizeof(addr);
+  if (bind(listenFd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(listenFd, 64) < 0 ||
+      getsockname(listenFd, (sockaddr*)&addr, &addrLen) < 0)
+  {
+    perror("localhost server");
+    return 1;
+  }
+  int port = ntohs(addr.sin_port);
+
+  std::atomic<bool> stop(false);
+  long served = 0;
+  long dropped = 0;
+  std::thread server(serve, listenFd, std::ref(stop), std::ref(served), std::ref(dropped));
+
+  std::vector<std::vector<double> > latencies(nbThreads);
+  std::vector<std::vector<long> > expected(nbThreads, std::vector<long>(NB_ROUTES, 0));
+  std::vector<std::thread> clients;
+  Clock::time_point start = Clock::now();
+  for (int t = 0; t < nbThreads; t++)
+    clients.push_back(std::thread(load, port, nbRequests / nbThreads, 1234u + t,
+                                  expected[t].data(), std::ref(latencies[t])));
+  for (std::thread& c : clients)
+    c.join();
+  double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+  stop = true;
+  shutdown(listenFd, SHUT_RDWR);
+  close(listenFd);
+  server.join();
+
+  std::vector<double> all;
+  for (std::vector<double>& l : latencies)
+    all.insert(all.end(), l.begin(), l.end());
+  std::sort(all.begin(), all.end());
+  bool counts = true;
+  for (int r = 0; r < NB_ROUTES; r++)
+  {
+    long sum = 0;
+    for (int t = 0; t < nbThreads; t++)
+      sum += expected[t][r];
+    if (sum != hits[r])
+      counts = false;
+  }
+  if (!counts || dropped != 0 || all.empty() || strcmp(lastText, "HELLO.WORLD") != 0)
+    failures++;
+
+  printf("\n%-8s %7s %7s | %9s | %9s %9s %9s | %s\n", "load", "threads", "served",
+         "req/s", "p50 us", "p99 us", "max us", "routes");
+  if (!all.empty())
+    printf("%-8s %7d %7ld | %9.0f | %9.0f %9.0f %9.0f | %s\n", "local", nbThreads, served,
+           all.size() / elapsed, all[all.size() / 2] * 1e6, all[all.size() * 99 / 100] * 1e6,
+           all.back() * 1e6, counts && dropped == 0 ? "all counted" : "FAILED");
+
+  return failures ? 1 : 0;
+}
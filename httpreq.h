@@ -0,0 +1,191 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// httpreq.h
+//
+// 1. HTTP request reader of the MegaPix and BigPix web servers
+// --> bytes are read by chunks into a fixed buffer, no String, no heap
+// --> only the request line is kept, the headers are skipped up to the
+//     blank line that ends the request
+// --> the path of "GET /path HTTP/1.1" selects one entry of a static route
+//     table, the handler is called once per request
+// --> the client is a template parameter: WiFiClient in the firmwares,
+//     a socket on the host (httpload.cpp)
+// --> while no byte is available the reader calls wait(): delay(1) in the
+//     firmwares, so the WiFi stack (ESP8266) or IDLE0 (ESP32 core 0) runs
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Request line parser and route table
+// v1.1   15 Oct. 2026     Wait between polls of an idle client
+//
+
+#ifndef HTTPREQ_H
+#define HTTPREQ_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+namespace http
+{
+
+const int LINE_SIZE  = 128;    // request line kept, longer lines are cut
+const int CHUNK_SIZE = 64;     // bytes read at once from the client
+
+//
+// Request line and end of request detection, fed by chunks
+//
+class RequestParser
+{
+public:
+  RequestParser() { reset(); }
+
+  void reset()
+  {
+    lineLen = 0;
+    lineDone = false;
+    lineStart = true;
+    complete = false;
+    line[0] = '\0';
+  }
+
+  //
+  // Feed received bytes, true once the blank line has been seen
+  //
+  bool feed(const char* data, size_t len)
+  {
+    for (size_t i = 0; i < len && !complete; i++)
+    {
+      char c = data[i];
+      if (c == '\n')
+      {
+        if (lineStart)                   // empty line, end of request
+          complete = true;
+        lineStart = true;
+        if (!lineDone)
+        {
+          lineDone = true;
+          line[lineLen] = '\0';
+        }
+      }
+      else if (c != '\r')
+      {
+        lineStart = false;
+        if (!lineDone && lineLen < LINE_SIZE - 1)
+          line[lineLen++] = c;
+      }
+    }
+    return complete;
+  }
+
+  bool done() const { return complete; }
+
+  //
+  // Path of a GET request ("/Wa"), "" for other methods
+  //
+  const char* path()
+  {
+    if (!lineDone)
+    {
+      lineDone = true;
+      line[lineLen] = '\0';
+    }
+    if (strncmp(line, "GET /", 5) != 0)
+      return "";
+    char* end = strchr(line + 4, ' ');
+    if (end != NULL)
+      *end = '\0';                       // cut " HTTP/1.1"
+    return line + 4;
+  }
+
+private:
+  char   line[LINE_SIZE];      // request line
+  int    lineLen;
+  bool   lineDone;             // request line read
+  bool   lineStart;            // nothing yet on the current line
+  bool   complete;             // blank line read
+};
+
+//
+// Route table entry, prefix routes pass the rest of the path to the handler
+//
+typedef void (*Handler)(const char* arg);
+
+struct Route
+{
+  const char* path;
+  bool        prefix;
+  Handler     handler;
+};
+
+//
+// Call the handler of the first route matching path, -1 if none does
+//
+inline int dispatch(const Route* routes, int nbRoutes, const char* path)
+{
+  for (int i = 0; i < nbRoutes; i++)
+  {
+    size_t len = strlen(routes[i].path);
+    if (strncmp(path, routes[i].path, len) == 0 &&
+        (routes[i].prefix || path[len] == '\0'))
+    {
+      routes[i].handler(path + len);
+      return i;
+    }
+  }
+  return -1;
+}
+
+//
+// Read a request from client until its blank line, false if the client
+// closed or timeoutMs elapsed before; now() gives the time in ms, wait()
+// gives the CPU away for a tick when no byte is there
+//
+template <class Client, class Clock, class Wait>
+inline bool readRequest(Client& client, RequestParser& req, Clock now, unsigned long timeoutMs, Wait wait)
+{
+  uint8_t chunk[CHUNK_SIZE];
+  unsigned long start = now();
+
+  req.reset();
+  while (!req.done() && (client.connected() || client.available() > 0) &&
+         now() - start < timeoutMs)
+  {
+    int nb = client.available();
+    if (nb <= 0)
+    {
+      wait();
+      continue;
+    }
+    if (nb > CHUNK_SIZE)
+      nb = CHUNK_SIZE;
+    nb = client.read(chunk, nb);
+    if (nb > 0)
+      req.feed((const char*)chunk, nb);
+  }
+  return req.done();
+}
+
+} // namespace http
+
+#endif // HTTPREQ_H
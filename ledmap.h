@@ -0,0 +1,127 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// ledmap.h
+//
+// 1. Geometry of the LED matrices, tables computed by the compiler
+// --> Layout<W, H, wiring, LEDs per pixel, strips>: W x H pixels, each
+//     driven by 1 or more consecutive LEDs (3 on BigPix)
+// --> wiring of the lines: ROWS all left to right, SERPENTINE left to right
+//     on even lines and right to left on odd lines, SERPENTINE_RTL the
+//     other way round
+// --> strips: the lines are cut in blocks of H / strips lines, one data pin
+//     each, every block starts as the first line; the strips are the
+//     consecutive slices of STRIP_LEDS LEDs of one array, FastLED writes
+//     them in parallel
+// --> Layout<...>::led[line*W + column] is the first LED behind the pixel,
+//     position() its place along the strips in pixels; a line is always a
+//     run of consecutive LEDs and the pixel <-> position map is its own
+//     inverse
+// --> Serpentine<W, H> is the one strip serpentine of one LED per pixel
+// --> plain C++11, used by MegaPix.ino, BigPix.ino and the host tools
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Serpentine tables
+// v1.1   15 Oct. 2026     Layout: wiring, LEDs per pixel, parallel strips
+//
+
+#ifndef LEDMAP_H
+#define LEDMAP_H
+
+#include <stdint.h>
+
+namespace ledmap
+{
+
+enum Wiring { ROWS, SERPENTINE, SERPENTINE_RTL };
+
+//
+// Line of a strip (0 = its first line) runs right to left
+//
+constexpr bool reversed(int line, Wiring wiring)
+{
+  return wiring == SERPENTINE ? line % 2 == 1 : wiring == SERPENTINE_RTL && line % 2 == 0;
+}
+
+//
+// Place of pixel pix along the strips of a w x h matrix, in pixels
+//
+constexpr uint16_t position(int pix, int w, int h, Wiring wiring, int strips)
+{
+  return (uint16_t)(reversed(pix / w % (h / strips), wiring) ? (pix / w) * w + (w - 1 - pix % w) : pix);
+}
+
+//
+// Compile-time list 0, 1, ... N-1, built in log(N) steps
+//
+template <int... I> struct IndexList {};
+
+template <class A, class B> struct Concat;
+template <int... I, int... J> struct Concat<IndexList<I...>, IndexList<J...> >
+{
+  typedef IndexList<I..., (int)sizeof...(I) + J...> type;
+};
+
+template <int N> struct MakeIndexList
+{
+  typedef typename Concat<typename MakeIndexList<N / 2>::type,
+                          typename MakeIndexList<N - N / 2>::type>::type type;
+};
+template <> struct MakeIndexList<0> { typedef IndexList<> type; };
+template <> struct MakeIndexList<1> { typedef IndexList<0> type; };
+
+//
+// Pixel to LED table of a W x H matrix
+//
+template <int W, int H, Wiring WIRING = SERPENTINE, int LPP = 1, int S = 1,
+          class L = typename MakeIndexList<W * H>::type> struct Layout;
+
+template <int W, int H, Wiring WIRING, int LPP, int S, int... I>
+struct Layout<W, H, WIRING, LPP, S, IndexList<I...> >
+{
+  static_assert(W > 0 && H > 0 && LPP > 0, "empty matrix");
+  static_assert(S > 0 && H % S == 0, "the strips must have the same number of lines");
+  static_assert(W * H * LPP <= 65536, "LED index on 16 bits");
+
+  static constexpr int WIDTH          = W;
+  static constexpr int HEIGHT         = H;
+  static constexpr int PIXELS         = W * H;
+  static constexpr int LEDS_PER_PIXEL = LPP;
+  static constexpr int LEDS           = W * H * LPP;
+  static constexpr int STRIPS         = S;
+  static constexpr int STRIP_LINES    = H / S;
+  static constexpr int STRIP_LEDS     = W * H * LPP / S;
+
+  static constexpr uint16_t led[W * H] = { (uint16_t)(ledmap::position(I, W, H, WIRING, S) * LPP)... };
+
+  static constexpr uint16_t position(int pix) { return ledmap::position(pix, W, H, WIRING, S); }
+};
+
+template <int W, int H, Wiring WIRING, int LPP, int S, int... I>
+constexpr uint16_t Layout<W, H, WIRING, LPP, S, IndexList<I...> >::led[W * H];
+
+template <int W, int H> using Serpentine = Layout<W, H>;
+
+} // namespace ledmap
+
+#endif // LEDMAP_H
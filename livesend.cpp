@@ -0,0 +1,282 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// livesend.cpp
+//
+// 1. Live stream of 32x16 frames to MegaPix (mpxlive.h), Linux
+// --> reads raw RGB frames from stdin (32x16x3 bytes, line by line), or
+//     draws a test pattern with -demo
+// --> -rgb sends the colors as they are, two packets per frame
+// --> -index sends palette indices, the palette grows with the new colors
+//     and is sent again with every key frame; a frame with too many colors
+//     goes out in RGB
+// --> -delta sends the changed runs against the last key frame, a full
+//     index frame every -key frames or when the delta gets bigger
+// --> frames leave at -fps, the sender time is in every packet
+//
+// usage: livesend [-rgb | -index | -delta] [-fps n] [-key n] [-demo frames]
+//                 [IP [port]]
+//        ffmpeg -i clip.mp4 -vf scale=32:16 -f rawvideo -pix_fmt rgb24 - |
+//          livesend -delta 10.1.1.1
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     RGB, index and delta frames
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <chrono>
+#include <thread>
+#include "mpx.h"
+#include "mpxlive.h"
+
+#define SERVER_IP   "10.1.1.1"
+#define SERVER_PORT 2023
+#define FPS         30
+#define KEY_FRAMES  30           // full frame every 30 frames
+
+#define VERSION "v1.0  2026-10-15"
+
+typedef std::chrono::steady_clock Clock;
+
+enum Mode { MODE_RGB, MODE_INDEX, MODE_DELTA };
+
+struct Sender
+{
+  int         sock;
+  sockaddr_in addr;
+  Clock::time_point start;
+  int         packets;
+  long        bytes;
+  int         sent[4];           // PALETTE, INDEX, DELTA, RGB
+
+  void send(const uint8_t* pkt, size_t len)
+  {
+    static const uint8_t types[4] = { mpxlive::PALETTE, mpxlive::INDEX, mpxlive::DELTA, mpxlive::RGB };
+    if (sendto(sock, pkt, len, 0, (sockaddr*)&addr, sizeof(addr)) < 0)
+      perror("sendto");
+    packets++;
+    bytes += (long)len;
+    for (int i = 0; i < 4; i++)
+      if (pkt[2] == types[i])
+        sent[i]++;
+  }
+
+  uint32_t now() const
+  {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+  }
+};
+
+//
+// Test pattern: diagonal color bars moving every 4 frames, a bouncing white dot
+//
+static void demoFrame(int n, uint8_t* rgb)
+{
+  static const uint8_t bars[8][3] = {
+    { 200, 0, 0 }, { 200, 120, 0 }, { 200, 200, 0 }, { 0, 200, 0 },
+    { 0, 200, 200 }, { 0, 0, 200 }, { 120, 0, 200 }, { 0, 0, 0 }
+  };
+  int dotX = n % (2 * (mpx::WIDTH - 1));
+  int dotY = n % (2 * (mpx::HEIGHT - 1));
+
+  if (dotX >= mpx::WIDTH)
+    dotX = 2 * (mpx::WIDTH - 1) - dotX;
+  if (dotY >= mpx::HEIGHT)
+    dotY = 2 * (mpx::HEIGHT - 1) - dotY;
+  for (int y = 0; y < mpx::HEIGHT; y++)
+  {
+    for (int x = 0; x < mpx::WIDTH; x++)
+    {
+      uint8_t* c = rgb + 3 * (y * mpx::WIDTH + x);
+      const uint8_t* bar = bars[((x + y + n / 4) / 4) % 8];
+      bool dot = x == dotX && y == dotY;
+      c[0] = dot ? 255 : bar[0];
+      c[1] = dot ? 255 : bar[1];
+      c[2] = dot ? 255 : bar[2];
+    }
+  }
+}
+
+static bool readFrame(FILE* in, uint8_t* rgb)
+{
+  return fread(rgb, 1, mpx::PIXELS * 3, in) == (size_t)mpx::PIXELS * 3;
+}
+
+//
+// Palette indices of the frame, false if the palette is full
+//
+static bool toIndex(mpx::PaletteBuilder& pal, const uint8_t* rgb, uint8_t* map)
+{
+  for (int p = 0; p < mpx::PIXELS; p++)
+  {
+    int idx = pal.index(rgb[3*p], rgb[3*p + 1], rgb[3*p + 2]);
+    if (idx < 0)
+      return false;
+    map[p] = (uint8_t)idx;
+  }
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  const char* ip = SERVER_IP;
+  int port = SERVER_PORT;
+  Mode mode = MODE_INDEX;
+  int fps = FPS;
+  int keyFrames = KEY_FRAMES;
+  int demo = 0;
+  int nbArgs = 0;
+
+  printf("%s %s\n\n", argv[0], VERSION);
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-rgb") == 0)
+      mode = MODE_RGB;
+    else if (strcmp(argv[i], "-index") == 0)
+      mode = MODE_INDEX;
+    else if (strcmp(argv[i], "-delta") == 0)
+      mode = MODE_DELTA;
+    else if (strcmp(argv[i], "-fps") == 0 && i + 1 < argc)
+      fps = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-key") == 0 && i + 1 < argc)
+      keyFrames = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-demo") == 0 && i + 1 < argc)
+      demo = atoi(argv[++i]);
+    else if (argv[i][0] != '-' && nbArgs == 0)
+      ip = argv[i], nbArgs++;
+    else if (argv[i][0] != '-' && nbArgs == 1)
+      port = atoi(argv[i]), nbArgs++;
+    else
+      fps = 0;
+  }
+  if (fps <= 0 || keyFrames <= 0)
+  {
+    printf("syntaxe: %s [-rgb | -index | -delta] [-fps n] [-key n] [-demo frames] [IP [port]]\n", argv[0]);
+    printf("         raw RGB frames of %dx%d on stdin without -demo\n", mpx::WIDTH, mpx::HEIGHT);
+    return 1;
+  }
+
+  Sender out = Sender();
+  out.sock = socket(AF_INET, SOCK_DGRAM, 0);
+  out.addr.sin_family = AF_INET;
+  out.addr.sin_port = htons((uint16_t)port);
+  if (out.sock < 0 || inet_pton(AF_INET, ip, &out.addr.sin_addr) != 1)
+  {
+    printf("cannot send to %s\n", ip);
+    return 1;
+  }
+  out.start = Clock::now();
+  printf("streaming to %s:%d, %s, %d fps\n", ip, port,
+         mode == MODE_RGB ? "RGB" : mode == MODE_INDEX ? "index" : "delta", fps);
+
+  static mpx::PaletteBuilder pal;
+  uint8_t  rgb[mpx::PIXELS * 3];
+  uint8_t  map[mpx::PIXELS];
+  uint8_t  keyMap[mpx::PIXELS];          // last INDEX frame
+  uint16_t keySeq = 0;
+  uint8_t  pkt[mpxlive::MAX_PACKET];
+  bool     keyValid = false;
+  int      palSent = 0;                 // colors the device knows
+  uint16_t seq = 0;
+  Clock::time_point due = Clock::now();
+  std::chrono::microseconds period(1000000 / fps);
+
+  int n;
+  for (n = 0; demo == 0 || n < demo; n++, seq++)
+  {
+    if (demo > 0)
+      demoFrame(n, rgb);
+    else if (!readFrame(stdin, rgb))
+      break;
+    std::this_thread::sleep_until(due);
+    due += period;
+    uint32_t time = out.now();
+    bool key = n % keyFrames == 0;
+
+    bool indexed = mode != MODE_RGB && toIndex(pal, rgb, map);
+    if (mode != MODE_RGB && !indexed)
+    {                                   // palette full, start a new one
+      pal.clear();
+      palSent = 0;
+      keyValid = false;                 // indices change
+      indexed = toIndex(pal, rgb, map);
+      if (!indexed)
+        pal.clear();
+    }
+    if (!indexed)
+    {
+      for (int part = 0; part < 2; part++)
+      {
+        size_t len = mpxlive::makeHeader(pkt, mpxlive::RGB, seq, (uint16_t)part, time);
+        memcpy(pkt + len, rgb + part * mpxlive::PART_PIXELS * 3, mpxlive::PART_PIXELS * 3);
+        out.send(pkt, len + mpxlive::PART_PIXELS * 3);
+      }
+      keyValid = false;                 // no index reference on the device
+      continue;
+    }
+
+    if (pal.size() != palSent || key)
+    {
+      size_t len = mpxlive::makeHeader(pkt, mpxlive::PALETTE, seq, 0, time);
+      pkt[len++] = (uint8_t)pal.size();
+      for (int i = 0; i < pal.size(); i++)
+      {
+        pkt[len++] = pal.color(i).R;
+        pkt[len++] = pal.color(i).G;
+        pkt[len++] = pal.color(i).B;
+      }
+      out.send(pkt, len);
+      palSent = pal.size();
+    }
+
+    size_t len = mpxlive::makeHeader(pkt, mpxlive::INDEX, seq, 0, time);
+    size_t delta;
+    if (mode == MODE_DELTA && keyValid && !key &&
+        mpxlive::encodeDelta(keyMap, map, pkt + len, mpx::PIXELS, delta))
+    {
+      mpxlive::makeHeader(pkt, mpxlive::DELTA, seq, keySeq, time);
+      out.send(pkt, len + delta);
+      continue;
+    }
+    memcpy(pkt + len, map, mpx::PIXELS);
+    out.send(pkt, len + mpx::PIXELS);
+    memcpy(keyMap, map, mpx::PIXELS);
+    keySeq = seq;
+    keyValid = true;
+  }
+
+  double s = out.now() / 1000.0;
+  printf("%d frames in %.1f s, %.1f fps\n", n, s, s > 0 ? n / s : 0);
+  printf("%d packets, %ld bytes, %.0f bytes per frame\n", out.packets, out.bytes,
+         n ? (double)out.bytes / n : 0);
+  printf("palette %d, index %d, delta %d, RGB %d packets\n",
+         out.sent[0], out.sent[1], out.sent[2], out.sent[3]);
+  close(out.sock);
+  return 0;
+}
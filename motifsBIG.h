@@ -0,0 +1,572 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// motifsBIG.h
+//
+// 1. Readable motifs of BigPix, as drawn in the char arrays of BigPix.ino
+//    up to v2.6 (formats in the header of BigPix.ino)
+// --> not compiled in the firmware: bigpack packs them into motifsBIG_P.h,
+//     edit them here then run "bigpack -o motifsBIG_P.h"
+// --> motifs[] lists them with their type, in the order of motifsBIG_P.h
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Motifs moved out of BigPix.ino
+//
+
+#ifndef MOTIFSBIG_H
+#define MOTIFSBIG_H
+
+namespace bigsrc
+{
+
+const int MAXTYPO = 40;
+
+const char inv01[88] = { 0,0,1,0,0,0,0,0,1,0,0,  // robot
+                         0,0,0,1,0,0,0,1,0,0,0,
+                         0,0,1,1,1,1,1,1,1,0,0,
+                         0,1,1,0,1,1,1,0,1,1,0,
+                         1,1,1,1,1,1,1,1,1,1,1,
+                         1,0,1,1,1,1,1,1,1,0,1,
+                         1,0,1,0,0,0,0,0,1,0,1,
+                         0,0,0,1,1,0,1,1,0,0,0 };
+
+const char inv02[88] = { 0,0,1,0,0,0,0,0,1,0,0,
+                         1,0,0,1,0,0,0,1,0,0,1,
+                         1,0,1,1,1,1,1,1,1,0,1,
+                         1,1,1,0,1,1,1,0,1,1,1,
+                         1,1,1,1,1,1,1,1,1,1,1,
+                         0,1,1,1,1,1,1,1,1,1,0,
+                         0,0,0,1,0,0,0,1,0,0,0,
+                         0,0,1,0,0,0,0,0,1,0,0 };
+
+const char sqi01[88] = { 0,0,0,0,1,1,1,0,0,0,0,   // Squid
+                         0,0,0,1,1,1,1,1,0,0,0,
+                         0,0,1,1,1,1,1,1,1,0,0,
+                         0,1,1,0,1,1,1,0,1,1,0,
+                         0,1,1,1,1,1,1,1,1,1,0,
+                         0,0,1,0,0,0,0,0,1,0,0,
+                         0,1,0,0,0,0,0,0,0,1,0,
+                         0,0,1,0,0,0,0,0,1,0,0 };
+
+const char sqi02[88] = { 0,0,0,0,1,1,1,0,0,0,0,
+                         0,0,0,1,1,1,1,1,0,0,0,
+                         0,0,1,1,1,1,1,1,1,0,0,
+                         0,1,1,0,1,1,1,0,1,1,0,
+                         0,1,1,1,1,1,1,1,1,1,0,
+                         0,0,0,1,0,0,0,1,0,0,0,
+                         0,0,1,0,1,0,1,0,1,0,0,
+                         0,1,0,1,0,1,0,1,0,1,0 };
+
+const char hea01[88] = { 0,0,0,1,1,0,1,1,0,0,0,   // Heart beat
+                         0,0,1,1,1,1,1,1,1,0,0,
+                         0,1,1,1,1,1,1,1,1,1,0,
+                         0,1,1,1,1,1,1,1,1,1,0,
+                         0,0,1,1,1,1,1,1,1,0,0,
+                         0,0,0,1,1,1,1,1,0,0,0,
+                         0,0,0,0,1,1,1,0,0,0,0,
+                         0,0,0,0,0,1,0,0,0,0,0 };
+
+const char hea02[88] = { 0,0,0,0,0,0,0,0,0,0,0,
+                         0,0,0,1,1,0,1,1,0,0,0,
+                         0,0,1,2,2,1,2,2,1,0,0,
+                         0,0,1,2,3,3,3,2,1,0,0,
+                         0,0,0,1,2,3,2,1,0,0,0,
+                         0,0,0,0,1,2,1,0,0,0,0,
+                         0,0,0,0,0,1,0,0,0,0,0,
+                         0,0,0,0,0,0,0,0,0,0,0 };
+
+const char typWdt[MAXTYPO] = {
+  1,3,2,3,2,3,3,3,3,3,3,3,3,3,3,3,3,3,3,4,3,1,3,4,3,5,4,3,3,3,3,3,3,3,3,5,3,3,3,2 };
+//! + - 0 1 2 3 4 5 6 7 8 9 A B C D E F G H I J K L M N O P Q R S T U V W X Y Z SP
+
+const char typo[600] = {
+  1,      // !
+  1,
+  1,
+  0,
+  1,
+
+  0,0,0,  // +
+  0,1,0,
+  1,1,1,
+  0,1,0,
+  0,0,0,
+
+  0,0,    // -
+  0,0,
+  1,1,
+  0,0,
+  0,0,
+
+  0,1,0,  // 0
+  1,0,1,
+  1,0,1,
+  1,0,1,
+  0,1,0,
+
+  0,1,    // 1
+  1,1,
+  0,1,
+  0,1,
+  0,1,
+
+  1,1,0,  // 2
+  0,0,1,
+  0,1,0,
+  1,0,0,
+  1,1,1,
+
+  1,1,0,  // 3
+  0,0,1,
+  0,1,0,
+  0,0,1,
+  1,1,1,
+
+  0,0,1,  // 4
+  0,1,0,
+  1,0,1,
+  1,1,1,
+  0,0,1,
+
+  1,1,1,  // 5
+  1,0,0,
+  1,1,0,
+  0,0,1,
+  1,1,1,
+
+  0,1,1,  // 6
+  1,0,0,
+  1,1,1,
+  1,0,1,
+  1,1,1,
+
+  1,1,1,  // 7
+  0,0,1,
+  0,1,0,
+  1,0,0,
+  1,0,0,
+
+  1,1,1,  // 8
+  1,0,1,
+  0,1,0,
+  1,0,1,
+  1,1,1,
+
+  1,1,1,  // 9
+  1,0,1,
+  0,1,1,
+  0,0,1,
+  1,1,1,
+
+  0,1,0,  // A
+  1,0,1,
+  1,1,1,
+  1,0,1,
+  1,0,1,
+
+  1,1,1,  // B
+  1,0,1,
+  1,1,1,
+  1,0,1,
+  1,1,1,
+
+  1,1,1,  // C
+  1,0,0,
+  1,0,0,
+  1,0,0,
+  1,1,1,
+
+  1,1,0,  // D
+  1,0,1,
+  1,0,1,
+  1,0,1,
+  1,1,1,
+
+  1,1,1,  // E
+  1,0,0,
+  1,1,0,
+  1,0,0,
+  1,1,1,
+
+  1,1,1,  // F
+  1,0,0,
+  1,1,0,
+  1,0,0,
+  1,0,0,
+
+  1,1,1,1,  // G
+  1,0,0,0,
+  1,0,1,1,
+  1,0,0,1,
+  1,1,1,1,
+
+  1,0,1,  // H
+  1,0,1,
+  1,1,1,
+  1,0,1,
+  1,0,1,
+
+  1,      // I
+  1,
+  1,
+  1,
+  1,
+
+  0,0,1,  // J
+  0,0,1,
+  0,0,1,
+  1,0,1,
+  0,1,1,
+
+  1,0,0,1, //K
+  1,0,1,0,
+  1,1,0,0,
+  1,0,1,0,
+  1,0,0,1,
+
+  1,0,0,  // L
+  1,0,0,
+  1,0,0,
+  1,0,0,
+  1,1,1,
+
+  1,0,0,0,1, // M
+  1,1,0,1,1,
+  1,0,1,0,1,
+  1,0,0,0,1,
+  1,0,0,0,1,
+
+  1,0,0,1,  // N
+  1,1,0,1,
+  1,0,1,1,
+  1,0,0,1,
+  1,0,0,1,
+
+  1,1,1,  // O
+  1,0,1,
+  1,0,1,
+  1,0,1,
+  1,1,1,
+
+  1,1,1,  // P
+  1,0,1,
+  1,1,1,
+  1,0,0,
+  1,0,0,
+
+  1,1,1,  // Q
+  1,0,1,
+  1,0,1,
+  1,1,1,
+  1,1,1,
+
+  1,1,1,  // R
+  1,0,1,
+  1,1,1,
+  1,1,0,
+  1,0,1,
+
+  1,1,1,  // S
+  1,0,0,
+  1,1,1,
+  0,0,1,
+  1,1,1,
+
+  1,1,1,  // T
+  0,1,0,
+  0,1,0,
+  0,1,0,
+  0,1,0,
+
+  1,0,1,  // U
+  1,0,1,
+  1,0,1,
+  1,0,1,
+  1,1,1,
+
+  1,0,1,  // V
+  1,0,1,
+  1,0,1,
+  1,0,1,
+  0,1,0,
+
+  1,0,0,0,1,  // W
+  1,0,0,0,1,
+  1,0,1,0,1,
+  1,1,0,1,1,
+  1,0,0,0,1,
+
+  1,0,1,  // X
+  1,0,1,
+  0,1,0,
+  1,0,1,
+  1,0,1,
+
+  1,0,1,  // Y
+  1,0,1,
+  0,1,0,
+  0,1,0,
+  0,1,0,
+
+  1,1,1,  // Z
+  0,0,1,
+  0,1,0,
+  1,0,0,
+  1,1,1,
+
+  0,0,    // space  MAXTYPO-1
+  0,0,
+  0,0,
+  0,0,
+  0,0 };
+
+/*
+                         1 2 3 4 5 6 7 8 910 1 2 3 4 5 6 7 8 920 1 2 3 4 5 6 7 8 930 1 2 3
+                         ---------------------+++++++++++++++++++++++xxxxxxxxxxxxxxxxxxxxx
+*/
+const char apero[264]= { 0,0,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,
+                         0,1,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,1,0,
+                         0,1,1,1,1,1,1,1,0,0,0,1,0,0,1,1,1,0,1,1,0,1,1,1,0,1,1,1,0,1,0,1,0,
+                         0,0,1,1,1,1,1,0,0,0,1,0,1,0,1,0,1,0,1,0,0,1,0,1,0,1,0,1,0,1,0,1,0,
+                         0,0,0,1,1,1,0,0,0,0,1,1,1,0,1,1,1,0,1,1,0,1,1,1,0,1,0,1,0,1,0,1,0,
+                         0,0,0,0,1,0,0,0,0,0,1,0,1,0,1,0,0,0,1,0,0,1,1,0,0,1,0,1,0,1,0,1,0,
+                         0,0,0,0,1,0,0,0,0,0,1,0,1,0,1,0,0,0,1,0,0,1,0,1,0,1,0,1,0,0,0,0,0,
+                         0,0,1,1,1,1,1,0,0,0,1,0,1,0,1,0,0,0,1,1,0,1,0,1,0,1,1,1,0,1,0,1,0
+                         };
+
+const char ie22[264]= {  0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0, // BigPix
+                         0,0,0,0,0,0,0,1,0,0,1,0,1,0,1,0,0,0,0,0,0,1,0,1,0,1,0,0,0,0,0,0,0,
+                         0,0,0,0,0,0,1,1,1,0,1,1,0,0,0,0,0,0,0,0,0,1,0,1,0,0,0,0,0,0,0,0,0,
+                         0,0,0,0,0,0,0,1,0,0,1,0,1,0,1,0,1,1,1,0,0,1,1,0,0,1,0,1,0,1,0,0,0,
+                         0,0,0,0,0,0,0,0,0,0,1,0,1,0,1,0,1,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,0,
+                         0,0,0,1,0,0,0,0,0,0,1,1,1,0,1,0,1,1,1,0,0,1,0,0,0,1,0,1,0,1,0,0,0,
+                         0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+                         0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0
+                         };
+
+const char eye01[112] = {   0,  0,  0,   // col0   black
+                          130,130,130,   // col1   light grey
+                           10, 10,130,   // col2   light blue
+                           60, 60,130,   // col3   blue
+                           70, 70, 70,   // col4   grey
+                            0,  0,  0,   // col5
+                            0,  0,  0,   // col6
+                            0,  0,  0,   // col7
+                          0,0,1,1,0,0,0,0,1,1,0,
+                          0,1,1,1,1,0,0,1,1,1,1,
+                          1,1,1,1,1,0,1,1,1,1,1,
+                          3,2,3,1,1,0,3,2,3,1,1,
+                          2,4,2,1,1,0,2,4,2,1,1,
+                          2,2,2,1,1,0,2,2,2,1,1,
+                          0,2,3,1,1,0,0,2,3,1,1,
+                          0,0,1,1,0,0,0,0,1,1,0 };
+
+const char eye02[112] = {   0,  0,  0,   // col0   black
+                          130,130,130,   // col1   light grey
+                           10, 10,130,   // col2   light blue
+                           60, 60,130,   // col3   blue
+                           70, 70, 70,   // col4   grey
+                            0,  0,  0,   // col5
+                            0,  0,  0,   // col6
+                            0,  0,  0,   // col7
+                          0,0,1,1,0,0,0,0,1,1,0,
+                          0,1,1,1,1,0,0,1,1,1,1,
+                          1,1,1,1,1,0,1,1,1,1,1,
+                          1,1,3,2,3,0,1,1,3,2,3,
+                          1,1,2,4,2,0,1,1,2,4,2,
+                          1,1,2,2,2,0,1,1,2,2,2,
+                          0,1,3,2,3,0,0,1,3,2,3,
+                          0,0,1,1,0,0,0,0,1,1,0 };
+
+const char gho01[112] = {   0,  0,  0,   // col0   black
+                          130,130,130,   // col1   light grey
+                          130, 10,130,   // col2   magenta
+                            0,  0,200,   // col3   blue
+                           80, 10, 80,   // col4   light magenta
+                            0,  0,  0,   // col5
+                            0,  0,  0,   // col6
+                            0,  0,  0,   // col7
+                          0,0,0,0,2,2,0,0,0,0,0,
+                          0,0,2,2,2,2,2,2,0,0,0,
+                          0,2,1,3,2,2,1,3,2,0,0,
+                          2,2,1,1,2,2,1,1,2,2,0,
+                          2,2,2,2,2,2,2,2,2,2,0,
+                          2,2,2,2,2,2,2,2,2,2,0,
+                          2,2,2,2,2,2,2,2,2,2,0,
+                          0,2,2,0,0,2,2,0,0,2,0 };
+
+const char gho02[112] = {   0,  0,  0,   // col0   black
+                          130,130,130,   // col1   light grey
+                          130, 10,130,   // col2   magenta
+                            0,  0,200,   // col3   blue
+                           80, 10, 80,   // col4   light magenta
+                            0,  0,  0,   // col5
+                            0,  0,  0,   // col6
+                            0,  0,  0,   // col7
+                          0,0,0,0,0,2,2,0,0,0,0,
+                          0,0,0,2,2,2,2,2,2,0,0,
+                          0,0,2,3,1,2,2,3,1,2,0,
+                          0,2,2,1,1,2,2,1,1,2,2,
+                          0,2,2,2,2,2,2,2,2,2,2,
+                          0,2,2,2,2,2,2,2,2,2,2,
+                          0,2,2,2,2,2,2,2,2,2,2,
+                          0,2,0,0,2,2,0,0,2,2,0 };
+
+const char sq01[112] = {   0,  0,  0,   // col0   black
+                          215, 10, 90,   // col1   red
+                          132, 10,215,   // col2   maj
+                           10, 90,215,   // col3   blue
+                           10,215,132,   // col4   cyan
+                           90,215, 10,   // col5   green
+                          215,132, 10,   // col6   Yell
+                          90,  90, 90,   // col7   White
+                          11,12,13,14,15,16,11,12,13,14,15,
+                          11,12,13,14,15,16,11,12,13,14,15,
+                          11,12,13,14,15,16,11,12,13,14,15,
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          0,0,0,0,0,0,0,0,0,0,0 };
+
+const char sq02[112] = {   0,  0,  0,   // col0   black
+                          215, 10, 90,   // col1   red
+                          132, 10,215,   // col2   maj
+                           10, 90,215,   // col3   blue
+                           10,215,132,   // col4   cyan
+                           90,215, 10,   // col5   green
+                          215,132, 10,   // col6   Yell
+                          90,  90, 90,   // col7   White
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          16,11,12,13,14,15,16,11,12,13,14,
+                          16,11,12,13,14,15,16,11,12,13,14,
+                          16,11,12,13,14,15,16,11,12,13,14,
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          0,0,0,0,0,0,0,0,0,0,0 };
+
+const char sq03[112] = {   0,  0,  0,   // col0   black
+                          215, 10, 90,   // col1   red
+                          132, 10,215,   // col2   maj
+                           10, 90,215,   // col3   blue
+                           10,215,132,   // col4   cyan
+                           90,215, 10,   // col5   green
+                          215,132, 10,   // col6   Yell
+                          90,  90, 90,   // col7   White
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          15,16,11,12,13,14,15,16,11,12,13,
+                          15,16,11,12,13,14,15,16,11,12,13,
+                          15,16,11,12,13,14,15,16,11,12,13,
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          0,0,0,0,0,0,0,0,0,0,0 };
+
+const char sq04[112] = {   0,  0,  0,   // col0   black
+                          215, 10, 90,   // col1   red
+                          132, 10,215,   // col2   maj
+                           10, 90,215,   // col3   blue
+                           10,215,132,   // col4   cyan
+                           90,215, 10,   // col5   green
+                          215,132, 10,   // col6   Yell
+                          90,  90, 90,   // col7   White
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          14,15,16,11,12,13,14,15,16,11,12,
+                          14,15,16,11,12,13,14,15,16,11,12,
+                          14,15,16,11,12,13,14,15,16,11,12,
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          0,0,0,0,0,0,0,0,0,0,0 };
+
+const char sq05[112] = {   0,  0,  0,   // col0   black
+                          215, 10, 90,   // col1   red
+                          132, 10,215,   // col2   maj
+                           10, 90,215,   // col3   blue
+                           10,215,132,   // col4   cyan
+                           90,215, 10,   // col5   green
+                          215,132, 10,   // col6   Yell
+                          90,  90, 90,   // col7   White
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          13,14,15,16,11,12,13,14,15,16,11,
+                          13,14,15,16,11,12,13,14,15,16,11,
+                          13,14,15,16,11,12,13,14,15,16,11,
+                          0,0,0,0,0,0,0,0,0,0,0 };
+
+const char sq06[112] = {   0,  0,  0,   // col0   black
+                          215, 10, 90,   // col1   red
+                          132, 10,215,   // col2   maj
+                           10, 90,215,   // col3   blue
+                           10,215,132,   // col4   cyan
+                           90,215, 10,   // col5   green
+                          215,132, 10,   // col6   Yell
+                          90,  90, 90,   // col7   White
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          0,0,0,0,0,0,0,0,0,0,0,
+                          12,13,14,15,16,11,12,13,14,15,16,
+                          12,13,14,15,16,11,12,13,14,15,16,
+                          12,13,14,15,16,11,12,13,14,15,16 };
+
+enum Type { MONO, MULTI, SCROLL };
+
+struct Motif
+{
+  const char* name;
+  Type        type;
+  const char* data;
+  int         width;       // columns of a scrolling motif
+};
+
+const Motif motifs[] = {
+  { "inv01", MONO,   inv01, 11 },
+  { "inv02", MONO,   inv02, 11 },
+  { "sqi01", MONO,   sqi01, 11 },
+  { "sqi02", MONO,   sqi02, 11 },
+  { "hea01", MONO,   hea01, 11 },
+  { "hea02", MONO,   hea02, 11 },
+  { "apero", SCROLL, apero, 33 },
+  { "ie22",  SCROLL, ie22,  33 },
+  { "eye01", MULTI,  eye01, 11 },
+  { "eye02", MULTI,  eye02, 11 },
+  { "gho01", MULTI,  gho01, 11 },
+  { "gho02", MULTI,  gho02, 11 },
+  { "sq01",  MULTI,  sq01,  11 },
+  { "sq02",  MULTI,  sq02,  11 },
+  { "sq03",  MULTI,  sq03,  11 },
+  { "sq04",  MULTI,  sq04,  11 },
+  { "sq05",  MULTI,  sq05,  11 },
+  { "sq06",  MULTI,  sq06,  11 } };
+
+const int NB_MOTIFS = sizeof(motifs) / sizeof(motifs[0]);
+
+} // namespace bigsrc
+
+#endif // MOTIFSBIG_H
+
@@ -0,0 +1,204 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// motifsBIG_P.h
+//
+// 1. Packed motifs of BigPix (bigmotif.h), in the flash
+// --> generated by bigpack v1.1  2026-10-15 from motifsBIG.h, do not edit
+//
+
+#ifndef MOTIFSBIG_P_H
+#define MOTIFSBIG_P_H
+
+#include "bigmotif.h"
+
+const uint8_t inv01[22] PROGMEM = {   // mono
+  0x10, 0x00, 0x01, 0x10, 0x10, 0x00, 0x55, 0x15, 0x50, 0x54, 0x14, 0x55,
+  0x55, 0x55, 0x54, 0x55, 0x14, 0x01, 0x10, 0x01, 0x45, 0x01 };
+
+const uint8_t inv02[22] PROGMEM = {   // mono
+  0x10, 0x00, 0x41, 0x10, 0x10, 0x14, 0x55, 0x15, 0x55, 0x54, 0x54, 0x55,
+  0x55, 0x15, 0x55, 0x55, 0x01, 0x04, 0x04, 0x40, 0x00, 0x04 };
+
+const uint8_t sqi01[22] PROGMEM = {   // mono
+  0x00, 0x15, 0x00, 0x50, 0x15, 0x00, 0x55, 0x15, 0x50, 0x54, 0x14, 0x54,
+  0x55, 0x05, 0x04, 0x40, 0x40, 0x00, 0x40, 0x40, 0x00, 0x04 };
+
+const uint8_t sqi02[22] PROGMEM = {   // mono
+  0x00, 0x15, 0x00, 0x50, 0x15, 0x00, 0x55, 0x15, 0x50, 0x54, 0x14, 0x54,
+  0x55, 0x05, 0x10, 0x10, 0x00, 0x11, 0x11, 0x10, 0x11, 0x11 };
+
+const uint8_t hea01[22] PROGMEM = {   // mono
+  0x40, 0x51, 0x00, 0x54, 0x55, 0x40, 0x55, 0x55, 0x50, 0x55, 0x15, 0x50,
+  0x55, 0x01, 0x50, 0x15, 0x00, 0x50, 0x01, 0x00, 0x10, 0x00 };
+
+const uint8_t hea02[22] PROGMEM = {   // mono
+  0x00, 0x00, 0x00, 0x50, 0x14, 0x00, 0x69, 0x1A, 0x40, 0xFE, 0x06, 0x40,
+  0x6E, 0x00, 0x40, 0x06, 0x00, 0x40, 0x00, 0x00, 0x00, 0x00 };
+
+const uint8_t apero[66] PROGMEM = {   // scroll
+  0x00, 0x00, 0x14, 0x00, 0x51, 0x40, 0x51, 0x41, 0x51, 0x55, 0x51, 0x41,
+  0x51, 0x40, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x55, 0x10, 0x01,
+  0x40, 0x55, 0x00, 0x00, 0x50, 0x55, 0x10, 0x01, 0x50, 0x01, 0x00, 0x00,
+  0x50, 0x55, 0x11, 0x41, 0x00, 0x00, 0x50, 0x55, 0x10, 0x05, 0x50, 0x51,
+  0x00, 0x00, 0x50, 0x55, 0x10, 0x40, 0x50, 0x55, 0x00, 0x00, 0x54, 0x45,
+  0x00, 0x00, 0x54, 0x45, 0x00, 0x00 };
+
+const uint8_t ie22[66] PROGMEM = {   // scroll
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x54, 0x00, 0x10, 0x00, 0x00,
+  0x10, 0x00, 0x54, 0x00, 0x10, 0x00, 0x00, 0x00, 0x55, 0x05, 0x11, 0x04,
+  0x45, 0x05, 0x00, 0x00, 0x44, 0x05, 0x00, 0x00, 0x40, 0x45, 0x40, 0x44,
+  0x40, 0x55, 0x00, 0x00, 0x00, 0x00, 0x55, 0x05, 0x41, 0x00, 0x15, 0x00,
+  0x00, 0x00, 0x44, 0x05, 0x00, 0x00, 0x40, 0x04, 0x00, 0x01, 0x40, 0x04,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+const uint8_t eye01[70] PROGMEM = {   // multi
+  0x00, 0x00, 0x00, 0x82, 0x82, 0x82, 0x0A, 0x0A, 0x82, 0x3C, 0x3C, 0x82,
+  0x46, 0x46, 0x46, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x01, 0x09, 0x03, 0x09, 0x00, 0x0B, 0x01, 0x0B, 0x00, 0x0C, 0x00, 0x0E,
+  0x18, 0x10, 0x18, 0x00, 0x09, 0x18, 0x10, 0x18, 0x10, 0x20, 0x10, 0x09,
+  0x00, 0x10, 0x20, 0x10, 0x0B, 0x12, 0x00, 0x09, 0x12, 0x00, 0x10, 0x18,
+  0x09, 0x01, 0x10, 0x18, 0x09, 0x00, 0x09, 0x03, 0x09, 0x01 };
+
+const uint8_t eye02[72] PROGMEM = {   // multi
+  0x00, 0x00, 0x00, 0x82, 0x82, 0x82, 0x0A, 0x0A, 0x82, 0x3C, 0x3C, 0x82,
+  0x46, 0x46, 0x46, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x01, 0x09, 0x03, 0x09, 0x00, 0x0B, 0x01, 0x0B, 0x00, 0x0C, 0x00, 0x0C,
+  0x18, 0x10, 0x18, 0x09, 0x00, 0x18, 0x10, 0x18, 0x0B, 0x10, 0x20, 0x10,
+  0x00, 0x09, 0x10, 0x20, 0x13, 0x09, 0x00, 0x12, 0x09, 0x00, 0x08, 0x18,
+  0x10, 0x18, 0x01, 0x08, 0x18, 0x10, 0x18, 0x00, 0x09, 0x03, 0x09, 0x01 };
+
+const uint8_t gho01[54] PROGMEM = {   // multi
+  0x00, 0x00, 0x00, 0x82, 0x82, 0x82, 0x82, 0x0A, 0x82, 0x00, 0x00, 0xC8,
+  0x50, 0x0A, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x03, 0x11, 0x07, 0x15, 0x02, 0x10, 0x08, 0x18, 0x11, 0x08, 0x18, 0x10,
+  0x02, 0x11, 0x09, 0x11, 0x09, 0x17, 0x13, 0x01, 0x17, 0x17, 0x13, 0x01,
+  0x10, 0x01, 0x11, 0x01, 0x11, 0x00 };
+
+const uint8_t gho02[56] PROGMEM = {   // multi
+  0x00, 0x00, 0x00, 0x82, 0x82, 0x82, 0x82, 0x0A, 0x82, 0x00, 0x00, 0xC8,
+  0x50, 0x0A, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x04, 0x11, 0x05, 0x15, 0x04, 0x10, 0x18, 0x08, 0x11, 0x18, 0x08, 0x10,
+  0x00, 0x11, 0x09, 0x11, 0x09, 0x11, 0x01, 0x17, 0x17, 0x13, 0x01, 0x17,
+  0x11, 0x00, 0x11, 0x01, 0x11, 0x01, 0x10, 0x00 };
+
+const uint8_t sq01[62] PROGMEM = {   // multi
+  0x00, 0x00, 0x00, 0xD7, 0x0A, 0x5A, 0x84, 0x0A, 0xD7, 0x0A, 0x5A, 0xD7,
+  0x0A, 0xD7, 0x84, 0x5A, 0xD7, 0x0A, 0xD7, 0x84, 0x0A, 0x5A, 0x5A, 0x5A,
+  0x48, 0x50, 0x58, 0x60, 0x68, 0x70, 0x48, 0x50, 0x58, 0x60, 0x69, 0x60,
+  0x58, 0x50, 0x48, 0x70, 0x68, 0x60, 0x58, 0x50, 0x49, 0x50, 0x58, 0x60,
+  0x68, 0x70, 0x48, 0x50, 0x58, 0x60, 0x68, 0x07, 0x07, 0x07, 0x07, 0x07,
+  0x07, 0x06 };
+
+const uint8_t sq02[63] PROGMEM = {   // multi
+  0x00, 0x00, 0x00, 0xD7, 0x0A, 0x5A, 0x84, 0x0A, 0xD7, 0x0A, 0x5A, 0xD7,
+  0x0A, 0xD7, 0x84, 0x5A, 0xD7, 0x0A, 0xD7, 0x84, 0x0A, 0x5A, 0x5A, 0x5A,
+  0x07, 0x02, 0x60, 0x58, 0x50, 0x48, 0x70, 0x68, 0x60, 0x58, 0x50, 0x48,
+  0x71, 0x48, 0x50, 0x58, 0x60, 0x68, 0x70, 0x48, 0x50, 0x58, 0x61, 0x58,
+  0x50, 0x48, 0x70, 0x68, 0x60, 0x58, 0x50, 0x48, 0x70, 0x07, 0x07, 0x07,
+  0x07, 0x07, 0x03 };
+
+const uint8_t sq03[63] PROGMEM = {   // multi
+  0x00, 0x00, 0x00, 0xD7, 0x0A, 0x5A, 0x84, 0x0A, 0xD7, 0x0A, 0x5A, 0xD7,
+  0x0A, 0xD7, 0x84, 0x5A, 0xD7, 0x0A, 0xD7, 0x84, 0x0A, 0x5A, 0x5A, 0x5A,
+  0x07, 0x07, 0x05, 0x68, 0x70, 0x48, 0x50, 0x58, 0x60, 0x68, 0x70, 0x48,
+  0x50, 0x59, 0x50, 0x48, 0x70, 0x68, 0x60, 0x58, 0x50, 0x48, 0x70, 0x69,
+  0x70, 0x48, 0x50, 0x58, 0x60, 0x68, 0x70, 0x48, 0x50, 0x58, 0x07, 0x07,
+  0x07, 0x07, 0x00 };
+
+const uint8_t sq04[63] PROGMEM = {   // multi
+  0x00, 0x00, 0x00, 0xD7, 0x0A, 0x5A, 0x84, 0x0A, 0xD7, 0x0A, 0x5A, 0xD7,
+  0x0A, 0xD7, 0x84, 0x5A, 0xD7, 0x0A, 0xD7, 0x84, 0x0A, 0x5A, 0x5A, 0x5A,
+  0x07, 0x07, 0x07, 0x07, 0x00, 0x50, 0x48, 0x70, 0x68, 0x60, 0x58, 0x50,
+  0x48, 0x70, 0x68, 0x61, 0x68, 0x70, 0x48, 0x50, 0x58, 0x60, 0x68, 0x70,
+  0x48, 0x51, 0x48, 0x70, 0x68, 0x60, 0x58, 0x50, 0x48, 0x70, 0x68, 0x60,
+  0x07, 0x07, 0x05 };
+
+const uint8_t sq05[63] PROGMEM = {   // multi
+  0x00, 0x00, 0x00, 0xD7, 0x0A, 0x5A, 0x84, 0x0A, 0xD7, 0x0A, 0x5A, 0xD7,
+  0x0A, 0xD7, 0x84, 0x5A, 0xD7, 0x0A, 0xD7, 0x84, 0x0A, 0x5A, 0x5A, 0x5A,
+  0x07, 0x07, 0x07, 0x07, 0x07, 0x03, 0x58, 0x60, 0x68, 0x70, 0x48, 0x50,
+  0x58, 0x60, 0x68, 0x70, 0x49, 0x70, 0x68, 0x60, 0x58, 0x50, 0x48, 0x70,
+  0x68, 0x60, 0x59, 0x60, 0x68, 0x70, 0x48, 0x50, 0x58, 0x60, 0x68, 0x70,
+  0x48, 0x07, 0x02 };
+
+const uint8_t sq06[62] PROGMEM = {   // multi
+  0x00, 0x00, 0x00, 0xD7, 0x0A, 0x5A, 0x84, 0x0A, 0xD7, 0x0A, 0x5A, 0xD7,
+  0x0A, 0xD7, 0x84, 0x5A, 0xD7, 0x0A, 0xD7, 0x84, 0x0A, 0x5A, 0x5A, 0x5A,
+  0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x06, 0x70, 0x68, 0x60, 0x58, 0x50,
+  0x48, 0x70, 0x68, 0x60, 0x58, 0x51, 0x58, 0x60, 0x68, 0x70, 0x48, 0x50,
+  0x58, 0x60, 0x68, 0x71, 0x68, 0x60, 0x58, 0x50, 0x48, 0x70, 0x68, 0x60,
+  0x58, 0x50 };
+
+const uint8_t typWdt[40] PROGMEM = {   // glyph widths
+  0x01, 0x03, 0x02, 0x03, 0x02, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+  0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x04, 0x03, 0x01, 0x03, 0x04,
+  0x03, 0x05, 0x04, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x05,
+  0x03, 0x03, 0x03, 0x02 };
+
+const uint8_t typIdx[40] PROGMEM = {   // first column of the glyphs
+  0x00, 0x01, 0x04, 0x06, 0x09, 0x0B, 0x0E, 0x11, 0x14, 0x17, 0x1A, 0x1D,
+  0x20, 0x23, 0x26, 0x29, 0x2C, 0x2F, 0x32, 0x35, 0x39, 0x3C, 0x3D, 0x40,
+  0x44, 0x47, 0x4C, 0x50, 0x53, 0x56, 0x59, 0x5C, 0x5F, 0x62, 0x65, 0x68,
+  0x6D, 0x70, 0x73, 0x76 };
+
+const uint8_t typo[120] PROGMEM = {   // font, one byte per column
+  0x17, 0x04, 0x0E, 0x04, 0x04, 0x04, 0x0E, 0x11, 0x0E, 0x02, 0x1F, 0x19,
+  0x15, 0x12, 0x11, 0x15, 0x1A, 0x0C, 0x0A, 0x1D, 0x17, 0x15, 0x19, 0x1E,
+  0x15, 0x1D, 0x19, 0x05, 0x03, 0x1B, 0x15, 0x1B, 0x13, 0x15, 0x1F, 0x1E,
+  0x05, 0x1E, 0x1F, 0x15, 0x1F, 0x1F, 0x11, 0x11, 0x1F, 0x11, 0x1E, 0x1F,
+  0x15, 0x11, 0x1F, 0x05, 0x01, 0x1F, 0x11, 0x15, 0x1D, 0x1F, 0x04, 0x1F,
+  0x1F, 0x08, 0x10, 0x1F, 0x1F, 0x04, 0x0A, 0x11, 0x1F, 0x10, 0x10, 0x1F,
+  0x02, 0x04, 0x02, 0x1F, 0x1F, 0x02, 0x04, 0x1F, 0x1F, 0x11, 0x1F, 0x1F,
+  0x05, 0x07, 0x1F, 0x19, 0x1F, 0x1F, 0x0D, 0x17, 0x17, 0x15, 0x1D, 0x01,
+  0x1F, 0x01, 0x1F, 0x10, 0x1F, 0x0F, 0x10, 0x0F, 0x1F, 0x08, 0x04, 0x08,
+  0x1F, 0x1B, 0x04, 0x1B, 0x03, 0x1C, 0x03, 0x19, 0x15, 0x13, 0x00, 0x00 };
+
+#ifdef BIGMOTIF_INDEX   // bigpack -check
+struct PackedMotif { const char* name; const uint8_t* data; int size; };
+
+const PackedMotif packedMotifs[] = {
+  { "inv01", inv01, (int)sizeof(inv01) },
+  { "inv02", inv02, (int)sizeof(inv02) },
+  { "sqi01", sqi01, (int)sizeof(sqi01) },
+  { "sqi02", sqi02, (int)sizeof(sqi02) },
+  { "hea01", hea01, (int)sizeof(hea01) },
+  { "hea02", hea02, (int)sizeof(hea02) },
+  { "apero", apero, (int)sizeof(apero) },
+  { "ie22", ie22, (int)sizeof(ie22) },
+  { "eye01", eye01, (int)sizeof(eye01) },
+  { "eye02", eye02, (int)sizeof(eye02) },
+  { "gho01", gho01, (int)sizeof(gho01) },
+  { "gho02", gho02, (int)sizeof(gho02) },
+  { "sq01", sq01, (int)sizeof(sq01) },
+  { "sq02", sq02, (int)sizeof(sq02) },
+  { "sq03", sq03, (int)sizeof(sq03) },
+  { "sq04", sq04, (int)sizeof(sq04) },
+  { "sq05", sq05, (int)sizeof(sq05) },
+  { "sq06", sq06, (int)sizeof(sq06) },
+  { "typWdt", typWdt, (int)sizeof(typWdt) },
+  { "typIdx", typIdx, (int)sizeof(typIdx) },
+  { "typo", typo, (int)sizeof(typo) } };
+#endif
+
+#endif // MOTIFSBIG_P_H
@@ -21,7 +21,7 @@
   -------------------------------------------------------------------------------
 */
 
-char palette[342] = {
+const char palette[342] = {
   16, 2,
     0,   0, 255,     //bleu
    65,   0, 255,
@@ -77,7 +77,7 @@ char palette[342] = {
 0x00
 };
 
-char donald[945] = {   
+const char donald[945] = {   
 194,  1,
 153, 153, 153,  160, 164, 163,  173, 181, 179,  171, 183, 181,  125, 132, 133,   38,  42,  41,   65,  67,  67,  178, 184, 184,  
 177, 185, 184,  227, 227, 227,  128, 132, 132,   37,  39,  39,   37,  37,  37,   37,  39,  49,   25,  76, 129,   30,  96, 158,  
@@ -123,7 +123,7 @@ char donald[945] = {
 0x20, 0x09, 0xDD, 0xDE, 0xDF, 0xE0, 0x84, 0xE1, 0xE2, 0xE3, 0x20, 0x0d, 
 0x00 };
            
-char heart[573] = {  
+const char heart[573] = {  
  58,   2,
 120, 100, 100,   80,  30,  30,   90,  30,  30,  100,  70,  70,   80,  50,  50,  100,  40,  40,  110,  60,  50,  110,  60,  60,  
 100,  50,  50,   80,  40,  40,  120,  30,  40,  120,  40,  50,  120,  80,  80,  120, 120, 120,  120,  60,  60,  120,  50,  50,  
@@ -170,7 +170,7 @@ char heart[573] = {
 0x20, 0x1f, 
 0x00 };
   
-char mickey[450] = {     
+const char mickey[450] = {     
  40, 1,
  30,  30,  30,   90,  90,  90,  100,  90,  90,  100,  90,  80,   90,  80,  70,   60,  50,  50,   20,  20,  10,   10,  10,  10,  
  40,  40,  40,   80,  70,  70,   90,  80,  80,  110,  90,  80,  120, 100,  90,  120,  90,  90,   80,  70,  60,  100,  80,  80,  
@@ -196,7 +196,7 @@ char mickey[450] = {
 0x20, 0x0C, 0x22, 0x2B, 0x33, 0x01, 0x30, 0x2C, 0x22, 0x20, 0x0b, 
 0x00 };
 
-char perle[1136] = { 
+const char perle[1136] = { 
 138,   2,
  20,  20,  30,  70,  90, 100,  70,  80, 100,  80,  90, 100,  90,  90, 100,  80, 100, 110,  80,  90, 110,  70,  90, 110, 
  70,  80, 110,  60,  80, 110,  60,  70, 100,  40,  40,  60,  20,  20,  40,  10,  20,  40,  20,  20,  50,  20,  30,  60, 
@@ -255,7 +255,7 @@ char perle[1136] = {
 
 
 
-char tjo[2221] = { 
+const char tjo[2221] = { 
 157,   4,
  30,  30,  30,  40,  20,  10,  50,  10,   0,  70,  20,  10, 100,  50,  30, 110,  60,  40, 120,  80,  60, 120,  90,  70, 
 120, 100,  80, 120, 110, 100, 120, 120, 110, 120, 120, 120, 120, 120, 100, 120, 110,  80,  70,  60,  50,  10,   0,   0, 
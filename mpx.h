@@ -0,0 +1,967 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// mpx.h
+//
+// 1. MPX codec shared by the MegaPix firmware and the host tools
+// --> palette builder and RLE image encoder (MegaPix18.cpp)
+// --> header reader, image iterator and RLE decoder (MegaPix.ino)
+// --> validate() checks an animation once when it arrives, decodeVerified()
+//     then draws its images without any bound check
+// --> header only, no heap: every buffer is given by the caller
+// --> plain C++11, builds with g++/clang on Linux and for the ESP32
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Codec extracted from MegaPix18 and MegaPix
+// v1.1   15 Oct. 2026     Hash indexed palette builder
+// v1.2   15 Oct. 2026     Image offset index
+// v1.3   15 Oct. 2026     Extended MPX, delta images
+// v1.4   15 Oct. 2026     Long runs and packed indices
+// v1.5   15 Oct. 2026     Palette builder stops at the last color code
+// v1.6   15 Oct. 2026     Validation once per animation, unchecked decoder
+// v1.7   15 Oct. 2026     Tempo unit of the extended MPX
+//
+// The MPX format is described in MegaPix.ino and MegaPix18.cpp.
+//
+// Extended MPX: data[0] is EXT_MARK | flags (an MPX has 223 colors at most),
+// with FLAG_UNIT the tempo unit in UNIT_STEP_US (1 to 255, 10 ms without the
+// flag), then the color count, the image count and the palette. Each image is
+// tempo, coding, payload size (16 bits, little endian), payload; no 0x00.
+// CODING_RLE payloads are the RLE of the classic MPX. CODING_DELTA payloads
+// only draw the pixels that changed since the previous image:
+//   0x00 n    skip n+1 pixels, they keep the previous image color
+//   0x01-0x1F repeat the current color, runs go across lines
+//   0x20-0xFF color code
+// CODING_LONG payloads are RLE with runs across lines and long repeats:
+//   0x00 n    repeat the current color n+32 times
+//   0x01-0x1F repeat the current color
+//   0x20-0xFF color code
+// CODING_PACKED payloads hold the bits per pixel (1, 2 or 4), the number of
+// local colors, the palette index of each local color, then the local color
+// of every pixel, PIXELS*bits/8 bytes, first pixel in the low bits.
+// The encoder keeps the smallest coding of each image. The first image of an
+// extended MPX is never a delta.
+//
+
+#ifndef MPX_H
+#define MPX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace mpx
+{
+
+//--------------------------------------------------------
+// Format constants
+//--------------------------------------------------------
+const int WIDTH      = 32;               // pixels per line
+const int HEIGHT     = 16;               // lines per image
+const int PIXELS     = WIDTH * HEIGHT;
+const int MAX_COLORS = 223;              // MPX palette, B&W excluded
+const int PAL_SIZE   = MAX_COLORS + 2;   // final palette, B&W included
+const int ENC_COLORS = MAX_COLORS - 1;   // colors the encoder takes: code 0xFF is
+                                         // pal[223], pal[224] would wrap to 0x00
+const int MAX_IMAGES = 255;              // image count is one byte
+
+const uint8_t END_IMAGE  = 0x00;         // image terminator
+const uint8_t CODE_BASE  = 0x20;         // color code of pal[0] = Black
+const uint8_t MAX_REPEAT = 0x1F;         // biggest RLE byte
+
+const uint8_t EXT_MARK   = 0xE0;         // data[0] of an extended MPX
+const uint8_t EXT_MASK   = 0xF0;         // low bits are the flags
+const uint8_t FLAG_DELTA = 0x01;         // images may be deltas
+const uint8_t FLAG_UNIT  = 0x02;         // the tempo unit byte follows data[0]
+
+const int TEMPO_US     = 10000;          // tempo unit of a classic MPX
+const int UNIT_STEP_US = 100;            // of the tempo unit byte
+
+const uint8_t CODING_RLE   = 0x01;       // coding byte of an extended image
+const uint8_t CODING_DELTA = 0x02;
+const uint8_t CODING_LONG  = 0x03;
+const uint8_t CODING_PACKED = 0x04;
+const uint8_t DELTA_SKIP   = 0x00;       // delta: skip the next n+1 pixels
+const uint8_t LONG_REPEAT  = 0x00;       // long: repeat n+32 times
+const int     MAX_LONG     = 255 + MAX_REPEAT + 1;
+const int     MAX_LOCAL    = 16;         // packed: 4 bits per pixel
+const size_t  EXT_IMAGE_HEADER = 4;      // tempo, coding, size (16)
+
+//--------------------------------------------------------
+// Palette builder: B&W first, then colors in order of appearance
+// Colors are found through an open addressed hash table keyed on the packed
+// RGB value, so indexing a pixel costs O(1) whatever the palette size.
+//--------------------------------------------------------
+struct Rgb
+{
+  uint8_t R;
+  uint8_t G;
+  uint8_t B;
+};
+
+class PaletteBuilder
+{
+public:
+  PaletteBuilder() { clear(); }
+
+  void clear()
+  {
+    nbColors = 0;
+    memset(table, 0xFF, sizeof(table));  // all slots empty (-1)
+    index(0, 0, 0);                      // Black
+    index(255, 255, 255);                // White
+  }
+
+  // palette index of the color, added if unknown, -1 if the palette is full
+  int index(uint8_t R, uint8_t G, uint8_t B)
+  {
+    uint32_t key = ((uint32_t)R << 16) | ((uint32_t)G << 8) | B;
+    unsigned slot = (unsigned)((key * 2654435761u) >> (32 - HASH_BITS));
+
+    while (table[slot] >= 0)             // linear probing
+    {
+      const Rgb& c = colors[table[slot]];
+      if (c.B == B && c.G == G && c.R == R)
+        return table[slot];
+      slot = (slot + 1) & (HASH_SIZE - 1);
+    }
+    int idx = add(R, G, B);
+    if (idx >= 0)
+      table[slot] = (int16_t)idx;
+    return idx;
+  }
+
+  int size() const { return nbColors; }              // B&W included
+  const Rgb& color(int idx) const { return colors[idx]; }
+
+private:
+  int add(uint8_t R, uint8_t G, uint8_t B)
+  {
+    if (nbColors >= ENC_COLORS + 2)
+      return -1;
+    colors[nbColors].R = R;
+    colors[nbColors].G = G;
+    colors[nbColors].B = B;
+    return nbColors++;
+  }
+
+  static const int HASH_BITS = 9;        // 512 slots, load factor below 0.5
+  static const int HASH_SIZE = 1 << HASH_BITS;
+
+  Rgb colors[PAL_SIZE];
+  int nbColors;
+  int16_t table[HASH_SIZE];              // palette index or -1
+};
+
+//--------------------------------------------------------
+// Encoder
+//--------------------------------------------------------
+
+//
+// Header and palette (B&W excluded), returns bytes written or 0 if cap is too small
+//
+inline size_t encodeHeader(uint8_t* out, size_t cap, const PaletteBuilder& pal, int nbImages)
+{
+  size_t idb = 0;
+
+  if (cap < (size_t)(2 + 3*(pal.size() - 2)))
+    return 0;
+  out[idb++] = (uint8_t)(pal.size() - 2);
+  out[idb++] = (uint8_t)nbImages;
+  for (int i = 2; i < pal.size(); i++)
+  {
+    out[idb++] = pal.color(i).R;
+    out[idb++] = pal.color(i).G;
+    out[idb++] = pal.color(i).B;
+  }
+  return idb;
+}
+
+//
+// One image: tempo, RLE of the palette index map, 0x00
+// map holds PIXELS palette indices line by line. Returns bytes written or 0 if
+// cap is too small. lineEnd[HEIGHT], if given, receives the offset following
+// the last byte of each line (used for the C source output).
+//
+inline size_t encodeImage(uint8_t* out, size_t cap, const uint8_t* map, int tempo,
+                          size_t* lineEnd = NULL)
+{
+  size_t idb = 0;
+  uint8_t colCour = 0;                   // 0 = no current color
+  int nbRepet = 0;
+  int idmap = 0;
+
+  if (cap < 2)
+    return 0;
+  out[idb++] = (uint8_t)tempo;
+
+  for (int j = 0; j < HEIGHT; j++)
+  {
+    for (int i = 0; i < WIDTH; i++)
+    {
+      uint8_t code = (uint8_t)(map[idmap++] + CODE_BASE);
+
+      if (colCour != 0 && code == colCour && nbRepet < MAX_REPEAT)
+      {
+        nbRepet++;                       // same color
+        continue;
+      }
+      if (idb + 2 >= cap)                // room for RLE, code and 0x00
+        return 0;
+      if (nbRepet > 0)                   // write RLE byte
+        out[idb++] = (uint8_t)nbRepet;
+      if (code == colCour)               // run longer than MAX_REPEAT
+      {
+        nbRepet = 1;
+        continue;
+      }
+      out[idb++] = code;                 // new color code
+      colCour = code;
+      nbRepet = 0;
+    }
+    if (nbRepet > 0)                     // end of line, write RLE information
+    {
+      if (idb + 1 >= cap)
+        return 0;
+      out[idb++] = (uint8_t)nbRepet;
+      colCour = 0;
+      nbRepet = 0;
+    }
+    if (lineEnd)
+      lineEnd[j] = idb;
+  }
+  out[idb++] = END_IMAGE;
+  return idb;
+}
+
+//
+// Extended MPX header and palette, returns bytes written or 0 if cap is too small.
+// A tempo unit other than TEMPO_US is written with FLAG_UNIT, in UNIT_STEP_US.
+//
+inline size_t encodeExtHeader(uint8_t* out, size_t cap, const PaletteBuilder& pal, int nbImages,
+                              uint8_t flags, int tempoUs = TEMPO_US)
+{
+  size_t base = tempoUs != TEMPO_US ? 2 : 1;
+
+  if (cap < base || tempoUs < UNIT_STEP_US || tempoUs > 255 * UNIT_STEP_US)
+    return 0;
+  size_t idb = encodeHeader(out + base, cap - base, pal, nbImages);
+  if (idb == 0)
+    return 0;
+  out[0] = (uint8_t)(EXT_MARK | flags | (base == 2 ? FLAG_UNIT : 0));
+  if (base == 2)
+    out[1] = (uint8_t)(tempoUs / UNIT_STEP_US);
+  return idb + base;
+}
+
+//
+// Delta payload of map against prev, len receives its size (0 when nothing
+// changed). False if cap is too small. Unchanged pixels that continue the
+// current run are painted, the others are skipped.
+//
+inline bool encodeDelta(uint8_t* out, size_t cap, const uint8_t* prev, const uint8_t* map,
+                        size_t& len)
+{
+  int cur = -1;                          // current color, none yet
+  int nbRepet = 0;                       // repeats not written yet
+  int skip = 0;                          // unchanged pixels not written yet
+
+  len = 0;
+  for (int p = 0; p <= PIXELS; p++)
+  {
+    bool end = p == PIXELS;
+    int  c = end ? -1 : map[p];
+
+    if (!end && c == cur && skip == 0 && nbRepet < MAX_REPEAT)
+    {
+      nbRepet++;                         // changed or not, same color
+      continue;
+    }
+    if (nbRepet > 0)
+    {
+      if (len + 1 > cap)
+        return false;
+      out[len++] = (uint8_t)nbRepet;
+      nbRepet = 0;
+    }
+    if (end)
+      break;                             // trailing skip is not written
+    if (c == prev[p])
+    {
+      skip++;
+      continue;
+    }
+    while (skip > 0)
+    {
+      int n = skip > 256 ? 256 : skip;
+      if (len + 2 > cap)
+        return false;
+      out[len++] = DELTA_SKIP;
+      out[len++] = (uint8_t)(n - 1);
+      skip -= n;
+    }
+    if (c == cur)                        // run longer than MAX_REPEAT
+    {
+      nbRepet = 1;
+      continue;
+    }
+    if (len + 1 > cap)
+      return false;
+    out[len++] = (uint8_t)(c + CODE_BASE);
+    cur = c;
+  }
+  return true;
+}
+
+//
+// Long runs payload of map, len receives its size, false if cap is too small
+//
+inline bool encodeLongRuns(uint8_t* out, size_t cap, const uint8_t* map, size_t& len)
+{
+  len = 0;
+  for (int p = 0; p < PIXELS; )
+  {
+    int n = 1;
+    while (p + n < PIXELS && map[p + n] == map[p])
+      n++;
+    if (len + 1 > cap)
+      return false;
+    out[len++] = (uint8_t)(map[p] + CODE_BASE);
+    for (int rest = n - 1; rest > 0; )
+    {
+      int k = rest < MAX_LONG ? rest : MAX_LONG;
+      if (len + 2 > cap)
+        return false;
+      if (k > MAX_REPEAT)
+      {
+        out[len++] = LONG_REPEAT;
+        out[len++] = (uint8_t)(k - MAX_REPEAT - 1);
+      }
+      else
+        out[len++] = (uint8_t)k;
+      rest -= k;
+    }
+    p += n;
+  }
+  return true;
+}
+
+//
+// Packed payload of map, len receives its size. False if the image has more
+// than MAX_LOCAL colors or cap is too small.
+//
+inline bool encodePacked(uint8_t* out, size_t cap, const uint8_t* map, size_t& len)
+{
+  int16_t local[256];
+  uint8_t colors[MAX_LOCAL];
+  int nbLocal = 0;
+
+  memset(local, 0xFF, sizeof(local));
+  for (int p = 0; p < PIXELS; p++)
+  {
+    if (local[map[p]] >= 0)
+      continue;
+    if (nbLocal == MAX_LOCAL)
+      return false;
+    colors[nbLocal] = map[p];
+    local[map[p]] = (int16_t)nbLocal++;
+  }
+  int bits = nbLocal <= 2 ? 1 : (nbLocal <= 4 ? 2 : 4);
+  len = 2 + nbLocal + PIXELS * bits / 8;
+  if (len > cap)
+    return false;
+  out[0] = (uint8_t)bits;
+  out[1] = (uint8_t)nbLocal;
+  memcpy(out + 2, colors, nbLocal);
+
+  uint8_t* packed = out + 2 + nbLocal;
+  int perByte = 8 / bits;
+  memset(packed, 0, PIXELS * bits / 8);
+  for (int p = 0; p < PIXELS; p++)
+    packed[p / perByte] |= (uint8_t)(local[map[p]] << ((p % perByte) * bits));
+  return true;
+}
+
+//
+// One image of an extended MPX in its smallest coding: RLE, long runs,
+// packed or, when prev is given, delta against prev. Returns bytes written
+// or 0 if cap is too small.
+//
+inline size_t encodeExtImage(uint8_t* out, size_t cap, const uint8_t* map, const uint8_t* prev,
+                             int tempo)
+{
+  uint8_t rle[2 * PIXELS + 2];
+  uint8_t bufs[2][2 * PIXELS + 2];
+  size_t  rleSize = encodeImage(rle, sizeof(rle), map, tempo);
+  const uint8_t* best = rle + 1;
+  size_t  size = rleSize - 2;                       // no tempo, no 0x00
+  uint8_t coding = CODING_RLE;
+  int     spare = 0;
+  size_t  len;
+
+  if (rleSize == 0)
+    return 0;
+  // the other codings must be strictly smaller, RLE decodes fastest
+  for (uint8_t c = CODING_DELTA; c <= CODING_PACKED; c++)
+  {
+    uint8_t* buf = bufs[spare];
+    bool ok = c == CODING_DELTA ? prev != NULL && encodeDelta(buf, sizeof(bufs[0]), prev, map, len)
+            : c == CODING_LONG  ? encodeLongRuns(buf, sizeof(bufs[0]), map, len)
+            :                     encodePacked(buf, sizeof(bufs[0]), map, len);
+    if (ok && len < size)
+    {
+      best = buf;
+      size = len;
+      coding = c;
+      spare ^= 1;
+    }
+  }
+  if (cap < EXT_IMAGE_HEADER + size)
+    return 0;
+  out[0] = (uint8_t)tempo;
+  out[1] = coding;
+  out[2] = (uint8_t)size;
+  out[3] = (uint8_t)(size >> 8);
+  memcpy(out + EXT_IMAGE_HEADER, best, size);
+  return EXT_IMAGE_HEADER + size;
+}
+
+//--------------------------------------------------------
+// Decoder
+//--------------------------------------------------------
+struct Header
+{
+  int    nbColors;                       // MPX palette colors, B&W excluded
+  int    nbImages;
+  size_t palette;                        // offset of the first MPX color
+  size_t firstImage;                     // offset of the first image
+  bool   extended;
+  int    flags;                          // extended MPX flags
+  int    tempoUs;                        // tempo unit
+};
+
+struct Image
+{
+  int            tempo;                  // Header::tempoUs units, 10 ms
+  int            coding;                 // CODING_RLE to CODING_PACKED
+  const uint8_t* rle;                    // first RLE byte
+  size_t         size;                   // RLE bytes, 0x00 excluded
+};
+
+//
+// Read the MPX header, false if the buffer is too short
+//
+inline bool readHeader(const uint8_t* data, size_t len, Header& hdr)
+{
+  hdr.extended = len > 0 && (data[0] & EXT_MASK) == EXT_MARK;
+  hdr.flags    = hdr.extended ? data[0] & ~EXT_MASK : 0;
+
+  size_t base = hdr.extended ? 1 : 0;
+  hdr.tempoUs = TEMPO_US;
+  if (hdr.flags & FLAG_UNIT)
+  {
+    if (len < 2 || data[1] == 0)
+      return false;
+    hdr.tempoUs = data[1] * UNIT_STEP_US;
+    base++;
+  }
+  if (len < base + 2 || data[base + 1] == 0)
+    return false;
+  hdr.nbColors   = data[base];
+  hdr.nbImages   = data[base + 1];
+  hdr.palette    = base + 2;
+  hdr.firstImage = hdr.palette + 3*(size_t)hdr.nbColors;
+  return hdr.nbColors <= MAX_COLORS && hdr.firstImage < len;
+}
+
+//
+// Copy the palette with B&W in front, palCol holds 3*(nbColors+2) bytes
+//
+inline void readPalette(const uint8_t* data, const Header& hdr, uint8_t* palCol)
+{
+  palCol[0] = 0;     palCol[1] = 0;     palCol[2] = 0;       // Black
+  palCol[3] = 255;   palCol[4] = 255;   palCol[5] = 255;     // White
+  for (size_t i = 0; i < 3*(size_t)hdr.nbColors; i++)
+    palCol[i + 6] = data[hdr.palette + i];
+}
+
+//
+// Image at offset pos, false if pos is past the end or the 0x00 is missing
+//
+inline bool readImage(const uint8_t* data, size_t len, size_t pos, Image& img)
+{
+  size_t end = pos + 1;
+
+  if (pos >= len)
+    return false;
+  while (end < len && data[end] != END_IMAGE)
+    end++;
+  if (end >= len)
+    return false;
+  img.tempo  = data[pos];
+  img.coding = CODING_RLE;
+  img.rle    = data + pos + 1;
+  img.size   = end - pos - 1;
+  return true;
+}
+
+//
+// Image of an extended MPX at offset pos, false if truncated or unknown coding
+//
+inline bool readExtImage(const uint8_t* data, size_t len, size_t pos, Image& img)
+{
+  if (pos + EXT_IMAGE_HEADER > len)
+    return false;
+  img.tempo  = data[pos];
+  img.coding = data[pos + 1];
+  img.rle    = data + pos + EXT_IMAGE_HEADER;
+  img.size   = data[pos + 2] | (data[pos + 3] << 8);
+  return img.coding >= CODING_RLE && img.coding <= CODING_PACKED &&
+         pos + EXT_IMAGE_HEADER + img.size <= len;
+}
+
+//
+// Walk the images of an animation one after the other
+//
+class ImageIterator
+{
+public:
+  ImageIterator(const uint8_t* mpxData, size_t mpxLen, const Header& hdr)
+    : data(mpxData), len(mpxLen), pos(hdr.firstImage), count(0), nbImages(hdr.nbImages),
+      extended(hdr.extended) {}
+
+  bool next(Image& img)
+  {
+    if (count >= nbImages)
+      return false;
+    if (extended)
+    {
+      if (!readExtImage(data, len, pos, img) || (count == 0 && img.coding == CODING_DELTA))
+        return false;
+      pos = (size_t)(img.rle - data) + img.size;
+    }
+    else
+    {
+      if (!readImage(data, len, pos, img))
+        return false;
+      pos = (size_t)(img.rle - data) + img.size + 1;
+    }
+    count++;
+    return true;
+  }
+
+private:
+  const uint8_t* data;
+  size_t len;
+  size_t pos;
+  int count;
+  int nbImages;
+  bool extended;
+};
+
+//
+// Image number idx of the animation, false if the animation is truncated
+//
+inline bool seekImage(const uint8_t* data, size_t len, const Header& hdr, int idx, Image& img)
+{
+  ImageIterator it(data, len, hdr);
+
+  for (int i = 0; i <= idx; i++)
+  {
+    if (!it.next(img))
+      return false;
+  }
+  return true;
+}
+
+//
+// Offsets of every image, built once per animation so that reaching image N
+// does not scan the N-1 images before it.
+//
+struct FrameIndex
+{
+  int      nbImages;
+  bool     extended;
+  uint32_t offset[MAX_IMAGES + 1];       // tempo byte of each image, then end
+};
+
+//
+// Index all the images, false if the animation is truncated
+//
+inline bool buildIndex(const uint8_t* data, size_t len, const Header& hdr, FrameIndex& idx)
+{
+  ImageIterator it(data, len, hdr);
+  Image img = Image();
+
+  size_t head = hdr.extended ? EXT_IMAGE_HEADER : 1;     // bytes before the RLE
+  size_t tail = hdr.extended ? 0 : 1;                    // 0x00
+
+  idx.nbImages = 0;
+  idx.extended = hdr.extended;
+  while (it.next(img))
+    idx.offset[idx.nbImages++] = (uint32_t)(img.rle - data - head);
+  if (idx.nbImages != hdr.nbImages)
+    return false;
+  idx.offset[idx.nbImages] = (uint32_t)(img.rle - data + img.size + tail);
+  return true;
+}
+
+//
+// Image number n of an indexed animation, O(1)
+//
+inline void indexedImage(const uint8_t* data, const FrameIndex& idx, int n, Image& img)
+{
+  uint32_t pos = idx.offset[n];
+
+  img.tempo = data[pos];
+  if (idx.extended)
+  {
+    img.coding = data[pos + 1];
+    img.rle    = data + pos + EXT_IMAGE_HEADER;
+    img.size   = idx.offset[n + 1] - pos - EXT_IMAGE_HEADER;
+  }
+  else
+  {
+    img.coding = CODING_RLE;
+    img.rle    = data + pos + 1;
+    img.size   = idx.offset[n + 1] - pos - 2;    // tempo and 0x00 excluded
+  }
+}
+
+//
+// Last image at or before n that is not a delta, decoding starts there
+//
+inline int keyImage(const uint8_t* data, const FrameIndex& idx, int n)
+{
+  if (idx.extended)
+    while (n > 0 && data[idx.offset[n] + 1] == CODING_DELTA)
+      n--;
+  return n;
+}
+
+//
+// Delta decoder, calls sink() for the changed pixels only, the sink target
+// must hold the previous image. Returns the last pixel reached.
+//
+template <class Sink>
+inline int decodeDeltaRuns(const Image& img, Sink& sink)
+{
+  int pix = 0;
+  int idcolor = 0;
+
+  for (size_t i = 0; i < img.size && pix < PIXELS; i++)
+  {
+    uint8_t data = img.rle[i];
+    int n = 1;
+
+    if (data == DELTA_SKIP)
+    {
+      if (++i < img.size)
+        pix += img.rle[i] + 1;
+      continue;
+    }
+    if (data >= CODE_BASE)               // color code
+      idcolor = data - CODE_BASE;
+    else                                 // RLE information
+      n = data;
+    if (n > PIXELS - pix)
+      n = PIXELS - pix;
+    sink(pix, n, idcolor);
+    pix += n;
+  }
+  return pix < PIXELS ? pix : PIXELS;
+}
+
+//
+// Long runs decoder, same calls as decodeRuns()
+//
+template <class Sink>
+inline int decodeLongRuns(const Image& img, Sink& sink)
+{
+  int pix = 0;
+  int idcolor = 0;
+
+  for (size_t i = 0; i < img.size && pix < PIXELS; i++)
+  {
+    uint8_t data = img.rle[i];
+    int n = 1;
+
+    if (data >= CODE_BASE)               // color code
+      idcolor = data - CODE_BASE;
+    else if (data != LONG_REPEAT)        // RLE information
+      n = data;
+    else if (++i < img.size)             // long repeat
+      n = img.rle[i] + MAX_REPEAT + 1;
+    else
+      break;
+    if (n > PIXELS - pix)
+      n = PIXELS - pix;
+    sink(pix, n, idcolor);
+    pix += n;
+  }
+  return pix;
+}
+
+//
+// Fields of a packed image: bits per pixel, palette index of the local
+// colors, packed pixels. False if the payload is not a packed image.
+//
+inline bool readPacked(const Image& img, int& bits, uint8_t* local, const uint8_t*& packed)
+{
+  if (img.size < 2)
+    return false;
+  bits = img.rle[0];
+  int nbLocal = img.rle[1];
+  if ((bits != 1 && bits != 2 && bits != 4) || nbLocal > (1 << bits) ||
+      img.size < 2 + nbLocal + (size_t)(PIXELS * bits / 8))
+    return false;
+  memset(local, 0, MAX_LOCAL);           // unused values draw Black
+  memcpy(local, img.rle + 2, nbLocal);
+  packed = img.rle + 2 + nbLocal;
+  return true;
+}
+
+//
+// Packed indices decoder, equal neighbours are given to sink() as one run
+//
+template <class Sink>
+inline int decodePackedRuns(const Image& img, Sink& sink)
+{
+  uint8_t local[MAX_LOCAL];
+  const uint8_t* packed;
+  int bits;
+  if (!readPacked(img, bits, local, packed))
+    return 0;
+
+  int mask = (1 << bits) - 1;
+  int first = 0;
+  int cur = packed[0] & mask;
+  int pix = 0;
+  for (int byte = 0; byte < PIXELS * bits / 8; byte++)
+  {
+    unsigned v = packed[byte];
+    for (int k = 0; k < 8; k += bits, pix++, v >>= bits)
+    {
+      if ((int)(v & mask) == cur)
+        continue;
+      sink(first, pix - first, local[cur]);
+      first = pix;
+      cur = v & mask;
+    }
+  }
+  sink(first, PIXELS - first, local[cur]);
+  return PIXELS;
+}
+
+//
+// RLE decoder, calls sink(first, count, idcolor) for each run of pixels and
+// returns the number of pixels drawn. Runs never go past PIXELS, a repeat byte
+// before the first color code repeats Black. The images of the other codings
+// go to their own decoder.
+//
+template <class Sink>
+inline int decodeRuns(const Image& img, Sink& sink)
+{
+  int pix = 0;
+  int idcolor = 0;
+
+  switch (img.coding)
+  {
+  case CODING_DELTA:  return decodeDeltaRuns(img, sink);
+  case CODING_LONG:   return decodeLongRuns(img, sink);
+  case CODING_PACKED: return decodePackedRuns(img, sink);
+  }
+
+  for (size_t i = 0; i < img.size && pix < PIXELS; i++)
+  {
+    uint8_t data = img.rle[i];
+    int n = 1;
+
+    if (data >= CODE_BASE)               // color code
+      idcolor = data - CODE_BASE;
+    else                                 // RLE information
+      n = data;
+    if (n > PIXELS - pix)
+      n = PIXELS - pix;
+    sink(pix, n, idcolor);
+    pix += n;
+  }
+  return pix;
+}
+
+//
+// Decode an image to a map of PIXELS palette indices, line by line. A delta
+// image only changes the pixels of the previous image held by map.
+//
+struct MapSink
+{
+  uint8_t* map;
+  void operator()(int first, int count, int idcolor)
+  {
+    for (int i = 0; i < count; i++)
+      map[first + i] = (uint8_t)idcolor;
+  }
+};
+
+inline int decodeImage(const Image& img, uint8_t* map)
+{
+  MapSink sink = { map };
+  return decodeRuns(img, sink);
+}
+
+
+//--------------------------------------------------------
+// Validation: one pass when an animation arrives (UDP upload, embedded
+// motif), then its images are decoded without bound checks
+//--------------------------------------------------------
+
+//
+// Verified animation: header, image offsets, palette entries
+//
+struct Animation
+{
+  Header     hdr;
+  FrameIndex idx;
+  int        nbPal;                      // palette entries, B&W included
+};
+
+//
+// True when decodeVerified() can draw the image unchecked: color codes and
+// packed local colors inside the palette, runs and skips inside the PIXELS,
+// no repeat or skip byte cut off at the end of the payload
+//
+inline bool validImage(const Image& img, int nbPal)
+{
+  if (img.coding == CODING_PACKED)
+  {
+    uint8_t local[MAX_LOCAL];
+    const uint8_t* packed;
+    int bits;
+    if (!readPacked(img, bits, local, packed))
+      return false;
+    for (int i = 0; i < MAX_LOCAL; i++)
+      if (local[i] >= nbPal)
+        return false;
+    return true;
+  }
+
+  int pix = 0;
+  for (size_t i = 0; i < img.size; i++)
+  {
+    uint8_t data = img.rle[i];
+    int n = data;
+
+    if (data >= CODE_BASE)               // color code
+    {
+      if (data - CODE_BASE >= nbPal)
+        return false;
+      n = 1;
+    }
+    else if (data == 0 && img.coding != CODING_RLE)
+    {                                    // skip or long repeat, one more byte
+      if (++i >= img.size)
+        return false;
+      n = img.rle[i] + (img.coding == CODING_DELTA ? 1 : MAX_REPEAT + 1);
+    }
+    pix += n;
+    if (pix > PIXELS)
+      return false;
+  }
+  return true;
+}
+
+//
+// Header, index and every image of the animation, false if one check fails
+//
+inline bool validate(const uint8_t* data, size_t len, Animation& anim)
+{
+  Image img = Image();
+
+  if (!readHeader(data, len, anim.hdr) || !buildIndex(data, len, anim.hdr, anim.idx))
+    return false;
+  anim.nbPal = anim.hdr.nbColors + 2;
+  for (int n = 0; n < anim.idx.nbImages; n++)
+  {
+    indexedImage(data, anim.idx, n, img);
+    if (!validImage(img, anim.nbPal))
+      return false;
+  }
+  return true;
+}
+
+//
+// decodeRuns() for an image of a validated animation: same sink calls, no
+// pixel count, no clamp. Packed images go to decodePackedRuns().
+//
+template <class Sink>
+inline void decodeVerified(const Image& img, Sink& sink)
+{
+  const uint8_t* p = img.rle;
+  const uint8_t* end = p + img.size;
+  int pix = 0;
+  int idcolor = 0;
+
+  if (img.coding == CODING_PACKED)
+  {
+    decodePackedRuns(img, sink);
+    return;
+  }
+  if (img.coding == CODING_RLE)          // most images, no 0x00 escape
+  {
+    while (p < end)
+    {
+      uint8_t data = *p++;
+      int n = 1;
+      if (data >= CODE_BASE)             // color code
+        idcolor = data - CODE_BASE;
+      else                               // RLE information
+        n = data;
+      sink(pix, n, idcolor);
+      pix += n;
+    }
+    return;
+  }
+  while (p < end)
+  {
+    uint8_t data = *p++;
+    int n = 1;
+
+    if (data >= CODE_BASE)               // color code
+      idcolor = data - CODE_BASE;
+    else if (data != 0)                  // RLE information
+      n = data;
+    else if (img.coding == CODING_DELTA) // skip
+    {
+      pix += *p++ + 1;
+      continue;
+    }
+    else                                 // long repeat
+      n = *p++ + MAX_REPEAT + 1;
+    sink(pix, n, idcolor);
+    pix += n;
+  }
+}
+
+} // namespace mpx
+
+#endif // MPX_H
@@ -0,0 +1,1007 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// mpxbench.cpp
+//
+// 1. Host benchmark of the MPX codec (mpx.h)
+// --> every motif of motifsMPX.h is decoded and encoded again
+// --> reports MB/s (MPX bytes) and images/s for both directions
+// --> checks that encode(decode(motif)) gives back the motif images
+// --> palette builder speed against the former linear search
+// --> cost of reaching the last image, scan against offset index
+// --> render cost per image, former DoPixel() path against span render
+// --> size and render cost of the extended MPX with delta images
+// --> size and render cost of the dense codings, long runs and packed indices
+// --> pipeline of every motif and of synthetic worst cases (full palette of
+//     224 colors with B&W, noise, 10 to 100 images): encode, decode, render into the LED
+//     array and UDP reassembly (mpxudp.h) per image, in a table and with
+//     -json in a file for the scripts that track the numbers
+// --> render of validated animations without bound checks (renderVerified)
+// --> golden hashes of the pipeline: encoded images, LEDs rendered at two
+//     brightnesses, extended variant; -golden compares them with a file
+//     (mpxbench.golden), -update writes it. Speed work must keep them.
+//
+// usage: mpxbench [-pipeline] [-fast] [-json file] [-golden file] [-update file]
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Codec bench
+// v1.1   15 Oct. 2026     Palette builder
+// v1.2   15 Oct. 2026     Image seek
+// v1.3   15 Oct. 2026     Render into the LED array
+// v1.4   15 Oct. 2026     Delta images
+// v1.5   15 Oct. 2026     Long runs and packed images
+// v1.6   15 Oct. 2026     Pipeline, JSON and golden hashes
+// v1.7   15 Oct. 2026     Unchecked render of validated animations
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "mpx.h"
+#include "mpxrender.h"
+#include "mpxudp.h"
+#include "motifsMPX.h"
+
+#define VERSION "v1.7  2026-10-15"
+
+static double minBenchSec = 0.25;      // minimal duration of one measure, -fast 0.02
+
+struct Motif
+{
+  const char* name;
+  const char* data;
+  size_t      size;
+};
+
+#define MOTIF(m) { #m, m, sizeof(m) }
+
+static const Motif motifs[] = {
+  MOTIF(palette), MOTIF(donald), MOTIF(heart), MOTIF(mickey), MOTIF(perle), MOTIF(tjo)
+};
+
+static volatile unsigned benchSink;    // keeps results alive
+
+//
+// Run f until minBenchSec is reached, returns seconds per call
+//
+template <class F>
+static double timeIt(F f)
+{
+  typedef std::chrono::steady_clock clk;
+  long calls = 0;
+  double elapsed = 0;
+  clk::time_point start = clk::now();
+
+  do
+  {
+    for (int i = 0; i < 64; i++)
+      f();
+    calls += 64;
+    elapsed = std::chrono::duration<double>(clk::now() - start).count();
+  } while (elapsed < minBenchSec);
+  return elapsed / calls;
+}
+
+static uint8_t rgbPix[mpx::MAX_IMAGES * mpx::PIXELS * 3];   // decoded images, RGB
+
+//
+// MegaPix18 v1.4 palette search, kept as the reference
+//
+static int linearIndex(mpx::Rgb* colors, int& nbColors, uint8_t R, uint8_t G, uint8_t B)
+{
+  for (int k = 0; k < nbColors; k++)
+  {
+    if (colors[k].B == B && colors[k].G == G && colors[k].R == R)
+      return k;
+  }
+  if (nbColors >= mpx::PAL_SIZE)
+    return -1;
+  colors[nbColors].R = R;
+  colors[nbColors].G = G;
+  colors[nbColors].B = B;
+  return nbColors++;
+}
+
+//
+// Palette of nbPix RGB pixels, hashed builder against linear search
+//
+static void benchPalette(const char* name, const uint8_t* rgb, int nbPix)
+{
+  static mpx::PaletteBuilder pal;
+  int nbColors = 0;
+
+  double thash = timeIt([&]()
+  {
+    unsigned sum = 0;
+    pal.clear();
+    for (int i = 0; i < nbPix; i++)
+      sum += pal.index(rgb[3*i], rgb[3*i + 1], rgb[3*i + 2]);
+    benchSink = sum;
+  });
+  double tlin = timeIt([&]()
+  {
+    mpx::Rgb colors[mpx::PAL_SIZE] = { { 0, 0, 0 }, { 255, 255, 255 } };
+    unsigned sum = 0;
+    nbColors = 2;
+    for (int i = 0; i < nbPix; i++)
+      sum += linearIndex(colors, nbColors, rgb[3*i], rgb[3*i + 1], rgb[3*i + 2]);
+    benchSink = sum;
+  });
+  printf("%-8s %6d %6d | %11.1f %11.1f | %s\n", name, nbPix, pal.size(),
+         nbPix / thash / 1e6, nbPix / tlin / 1e6,
+         pal.size() == nbColors ? "same palette" : "FAILED");
+}
+
+//
+// Last image of the animation, scanning all images against the offset index
+//
+static void benchSeek(const char* name, const uint8_t* data, size_t len)
+{
+  static mpx::FrameIndex idx;
+  mpx::Header hdr;
+  mpx::Image scanned = mpx::Image();
+  mpx::Image indexed = mpx::Image();
+
+  if (!mpx::readHeader(data, len, hdr) || !mpx::buildIndex(data, len, hdr, idx))
+    return;
+  int last = hdr.nbImages - 1;
+  double tscan = timeIt([&]()
+  {
+    mpx::seekImage(data, len, hdr, last, scanned);
+    benchSink = (unsigned)scanned.size;
+  });
+  double tidx = timeIt([&]()
+  {
+    mpx::indexedImage(data, idx, last, indexed);
+    benchSink = (unsigned)indexed.size;
+  });
+  double tbuild = timeIt([&]()
+  {
+    mpx::buildIndex(data, len, hdr, idx);
+    benchSink = idx.offset[last];
+  });
+  bool same = scanned.rle == indexed.rle && scanned.size == indexed.size &&
+              scanned.tempo == indexed.tempo;
+  printf("%-8s %6zu %6d | %11.1f %11.3f | %11.1f | %s\n", name, len, hdr.nbImages,
+         tscan * 1e6, tidx * 1e6, tbuild * 1e6, same ? "same image" : "FAILED");
+}
+
+struct Led                             // CRGB layout
+{
+  uint8_t r, g, b;
+};
+
+//
+// MegaPix v2.0 DoPixel(), kept as the reference
+//
+static void doPixel(Led* leds, int li, int co, uint8_t red, uint8_t green, uint8_t blue,
+                    int intensite)
+{
+  int idpix;
+  if (li % 2 == 0)
+    idpix = co + li*32;
+  else
+    idpix = (31 - co) + li*32;
+
+  switch (intensite)
+  {
+  case 0:  leds[idpix] = Led { 0, 0, 0 }; break;
+  case 1:  leds[idpix] = Led { (uint8_t)(red/5), (uint8_t)(green/5), (uint8_t)(blue/5) }; break;
+  case 2:  leds[idpix] = Led { (uint8_t)(red/3), (uint8_t)(green/3), (uint8_t)(blue/3) }; break;
+  case 3:  leds[idpix] = Led { red, green, blue }; break;
+  default: leds[idpix] = Led { (uint8_t)(red/2), (uint8_t)(green/2), (uint8_t)(blue/2) }; break;
+  }
+}
+
+//
+// All images of the animation into the LED array, per pixel against spans
+//
+static bool benchRender(const char* name, const uint8_t* data, size_t len, int intensity)
+{
+  static mpx::FrameIndex idx;
+  static Led ref[mpx::PIXELS];
+  static Led leds[mpx::PIXELS];
+  uint8_t palCol[mpx::PAL_SIZE * 3] = { 0 };
+  Led palScaled[mpx::PAL_SIZE];
+  mpx::Header hdr;
+  mpx::Image img;
+
+  if (!mpx::readHeader(data, len, hdr) || !mpx::buildIndex(data, len, hdr, idx))
+    return true;
+  mpx::readPalette(data, hdr, palCol);
+  mpx::scalePalette(palCol, mpx::PAL_SIZE, intensity, palScaled);
+
+  bool same = true;
+  for (int n = 0; n < hdr.nbImages; n++)
+  {
+    auto drawRun = [&](int first, int count, int idcolor)
+    {
+      const uint8_t* rgb = palCol + idcolor*3;
+      for (int pix = first; pix < first + count; pix++)
+        doPixel(ref, pix/mpx::WIDTH, pix%mpx::WIDTH, rgb[0], rgb[1], rgb[2], intensity);
+    };
+    mpx::indexedImage(data, idx, n, img);
+    mpx::decodeRuns(img, drawRun);
+    mpx::renderImage(img, palScaled, leds);
+    if (memcmp(ref, leds, sizeof(leds)) != 0)
+      same = false;
+  }
+
+  double tpix = timeIt([&]()
+  {
+    for (int n = 0; n < hdr.nbImages; n++)
+    {
+      auto drawRun = [&](int first, int count, int idcolor)
+      {
+        const uint8_t* rgb = palCol + idcolor*3;
+        for (int pix = first; pix < first + count; pix++)
+          doPixel(ref, pix/mpx::WIDTH, pix%mpx::WIDTH, rgb[0], rgb[1], rgb[2], intensity);
+      };
+      mpx::indexedImage(data, idx, n, img);
+      mpx::decodeRuns(img, drawRun);
+    }
+    benchSink = ref[0].r;
+  });
+  double tspan = timeIt([&]()
+  {
+    for (int n = 0; n < hdr.nbImages; n++)
+    {
+      mpx::indexedImage(data, idx, n, img);
+      mpx::renderImage(img, palScaled, leds);
+    }
+    benchSink = leds[0].r;
+  });
+  int level = 0;
+  double tscale = timeIt([&]()       // every brightness in turn
+  {
+    mpx::scalePalette(palCol, mpx::PAL_SIZE, level, palScaled);
+    level = (level + 1) % 5;        // 0 to 3 and the 1/2 default
+    benchSink = palScaled[mpx::PAL_SIZE - 1].g;
+  });
+  printf("%-8s %6zu %6d | %11.2f %11.2f | %11.2f | %s\n", name, len, hdr.nbImages,
+         tpix / hdr.nbImages * 1e6, tspan / hdr.nbImages * 1e6, tscale * 1e6,
+         same ? "same LEDs" : "FAILED");
+  return same;
+}
+
+//
+// Extended MPX of a classic one, every image in its smallest coding, delta
+// images only when deltas is set. Returns its size.
+//
+static size_t makeExtended(const uint8_t* data, size_t len, uint8_t* out, size_t cap,
+                           bool deltas)
+{
+  static uint8_t maps[mpx::MAX_IMAGES][mpx::PIXELS];
+  mpx::Header hdr;
+  mpx::Image img;
+  int n = 0;
+
+  if (!mpx::readHeader(data, len, hdr) || cap < hdr.firstImage + 1)
+    return 0;
+  out[0] = mpx::EXT_MARK | (deltas ? mpx::FLAG_DELTA : 0);   // same palette
+  memcpy(out + 1, data, hdr.firstImage);
+  size_t idb = hdr.firstImage + 1;
+  mpx::ImageIterator it(data, len, hdr);
+  while (it.next(img) && idb > 0)
+  {
+    mpx::decodeImage(img, maps[n]);
+    size_t nb = mpx::encodeExtImage(out + idb, cap - idb, maps[n],
+                                    deltas && n > 0 ? maps[n - 1] : NULL, img.tempo);
+    idb = nb ? idb + nb : 0;
+    n++;
+  }
+  return idb;
+}
+
+//
+// Classic MPX against its delta variant: size, render of every image in
+// order (a delta is drawn over the previous image), same LEDs
+//
+static bool benchDelta(const char* name, const uint8_t* data, size_t len)
+{
+  static uint8_t ext[64 * 1024];
+  static mpx::FrameIndex idx;
+  static mpx::FrameIndex extIdx;
+  static Led ref[mpx::MAX_IMAGES][mpx::PIXELS];
+  static Led leds[mpx::PIXELS];
+  uint8_t palCol[mpx::PAL_SIZE * 3] = { 0 };
+  Led palScaled[mpx::PAL_SIZE];
+  mpx::Header hdr;
+  mpx::Header extHdr;
+  mpx::Image img;
+
+  size_t extLen = makeExtended(data, len, ext, sizeof(ext), true);
+  if (extLen == 0 || !mpx::readHeader(data, len, hdr) || !mpx::buildIndex(data, len, hdr, idx) ||
+      !mpx::readHeader(ext, extLen, extHdr) || !mpx::buildIndex(ext, extLen, extHdr, extIdx))
+  {
+    printf("%-8s no delta variant, FAILED\n", name);
+    return false;
+  }
+  mpx::readPalette(data, hdr, palCol);
+  mpx::scalePalette(palCol, mpx::PAL_SIZE, 3, palScaled);
+
+  int nbDelta = 0;
+  bool same = true;
+  for (int n = 0; n < hdr.nbImages; n++)
+  {
+    mpx::indexedImage(data, idx, n, img);
+    mpx::renderImage(img, palScaled, ref[n]);
+    mpx::indexedImage(ext, extIdx, n, img);
+    nbDelta += img.coding == mpx::CODING_DELTA;
+    mpx::renderImage(img, palScaled, leds);
+    if (memcmp(ref[n], leds, sizeof(leds)) != 0)
+      same = false;
+  }
+
+  double tfull = timeIt([&]()
+  {
+    for (int n = 0; n < hdr.nbImages; n++)
+    {
+      mpx::indexedImage(data, idx, n, img);
+      mpx::renderImage(img, palScaled, leds);
+    }
+    benchSink = leds[0].r;
+  });
+  double tdelta = timeIt([&]()
+  {
+    for (int n = 0; n < extHdr.nbImages; n++)
+    {
+      mpx::indexedImage(ext, extIdx, n, img);
+      mpx::renderImage(img, palScaled, leds);
+    }
+    benchSink = leds[0].r;
+  });
+  printf("%-8s %6zu %6d | %11zu %11d | %11.2f %11.2f | %s\n", name, len, hdr.nbImages,
+         extLen, nbDelta, tfull / hdr.nbImages * 1e6, tdelta / hdr.nbImages * 1e6,
+         same ? "same LEDs" : "FAILED");
+  return same;
+}
+
+//
+// Classic MPX against its intra-only extended variant: bytes of every coding
+// summed over the images (packed only counts the images of 16 colors or
+// less), size of the variant, render cost per pixel, same LEDs
+//
+static bool benchDense(const char* name, const uint8_t* data, size_t len)
+{
+  static uint8_t ext[64 * 1024];
+  static mpx::FrameIndex idx;
+  static mpx::FrameIndex extIdx;
+  static Led ref[mpx::PIXELS];
+  static Led leds[mpx::PIXELS];
+  uint8_t palCol[mpx::PAL_SIZE * 3] = { 0 };
+  uint8_t map[mpx::PIXELS];
+  uint8_t payload[2 * mpx::PIXELS + 2];
+  Led palScaled[mpx::PAL_SIZE];
+  mpx::Header hdr;
+  mpx::Header extHdr;
+  mpx::Image img;
+
+  size_t extLen = makeExtended(data, len, ext, sizeof(ext), false);
+  if (extLen == 0 || !mpx::readHeader(data, len, hdr) || !mpx::buildIndex(data, len, hdr, idx) ||
+      !mpx::readHeader(ext, extLen, extHdr) || !mpx::buildIndex(ext, extLen, extHdr, extIdx))
+  {
+    printf("%-8s no dense variant, FAILED\n", name);
+    return false;
+  }
+  mpx::readPalette(data, hdr, palCol);
+  mpx::scalePalette(palCol, mpx::PAL_SIZE, 3, palScaled);
+
+  size_t rleBytes = 0;
+  size_t longBytes = 0;
+  size_t packedBytes = 0;
+  int nbPacked = 0;
+  bool same = true;
+  for (int n = 0; n < hdr.nbImages; n++)
+  {
+    size_t nb;
+    mpx::indexedImage(data, idx, n, img);
+    mpx::decodeImage(img, map);
+    mpx::renderImage(img, palScaled, ref);
+    rleBytes += img.size;
+    if (mpx::encodeLongRuns(payload, sizeof(payload), map, nb))
+      longBytes += nb;
+    if (mpx::encodePacked(payload, sizeof(payload), map, nb))
+      packedBytes += nb, nbPacked++;
+    mpx::indexedImage(ext, extIdx, n, img);
+    mpx::renderImage(img, palScaled, leds);
+    if (memcmp(ref, leds, sizeof(leds)) != 0)
+      same = false;
+  }
+
+  double trle = timeIt([&]()
+  {
+    for (int n = 0; n < hdr.nbImages; n++)
+    {
+      mpx::indexedImage(data, idx, n, img);
+      mpx::renderImage(img, palScaled, leds);
+    }
+    benchSink = leds[0].r;
+  });
+  double tdense = timeIt([&]()
+  {
+    for (int n = 0; n < extHdr.nbImages; n++)
+    {
+      mpx::indexedImage(ext, extIdx, n, img);
+      mpx::renderImage(img, palScaled, leds);
+    }
+    benchSink = leds[0].r;
+  });
+  double pixels = (double)hdr.nbImages * mpx::PIXELS;
+  printf("%-8s %6zu %6d | %7zu %7zu %7zu %3d | %6zu | %7.2f %7.2f | %s\n", name, len,
+         hdr.nbImages, rleBytes, longBytes, packedBytes, nbPacked, extLen,
+         trle / pixels * 1e9, tdense / pixels * 1e9, same ? "same LEDs" : "FAILED");
+  return same;
+}
+
+//
+// Synthetic animation: a 4x4 sprite crossing a still background
+//
+static size_t makeSprite(uint8_t* out, size_t cap, int nbImages)
+{
+  mpx::PaletteBuilder pal;
+  uint8_t map[mpx::PIXELS];
+
+  for (int c = 0; c < 8; c++)
+    pal.index((uint8_t)(30*c), 60, (uint8_t)(200 - 20*c));
+  size_t idb = mpx::encodeHeader(out, cap, pal, nbImages);
+  for (int n = 0; n < nbImages && idb > 0; n++)
+  {
+    for (int i = 0; i < mpx::PIXELS; i++)
+    {
+      int x = i % mpx::WIDTH;
+      int y = i / mpx::WIDTH;
+      bool sprite = x >= n % mpx::WIDTH && x < n % mpx::WIDTH + 4 && y >= 6 && y < 10;
+      map[i] = (uint8_t)(sprite ? 1 : 2 + (x / 4 + y / 4) % 8);
+    }
+    size_t nb = mpx::encodeImage(out + idb, cap - idb, map, 5);
+    idb = nb ? idb + nb : 0;
+  }
+  return idb;
+}
+
+//
+// Synthetic animation: pixel art dithered with 3 colors, every pixel differs
+// from its neighbour so the runs are all one pixel long
+//
+static size_t makeDither(uint8_t* out, size_t cap, int nbImages)
+{
+  mpx::PaletteBuilder pal;
+  uint8_t map[mpx::PIXELS];
+
+  pal.index(20, 20, 60);
+  pal.index(200, 40, 40);
+  pal.index(240, 200, 60);
+  size_t idb = mpx::encodeHeader(out, cap, pal, nbImages);
+  for (int n = 0; n < nbImages && idb > 0; n++)
+  {
+    for (int i = 0; i < mpx::PIXELS; i++)
+      map[i] = (uint8_t)(1 + (i % mpx::WIDTH + 2 * (i / mpx::WIDTH) + n) % 3);
+    size_t nb = mpx::encodeImage(out + idb, cap - idb, map, 5);
+    idb = nb ? idb + nb : 0;
+  }
+  return idb;
+}
+
+//
+// Synthetic animation: nbImages images of vertical stripes moving one column
+// per image, returns the MPX size
+//
+static size_t makeStripes(uint8_t* out, size_t cap, int nbImages)
+{
+  mpx::PaletteBuilder pal;
+  uint8_t map[mpx::PIXELS];
+
+  for (int c = 0; c < 16; c++)
+    pal.index((uint8_t)(16*c), (uint8_t)(255 - 16*c), 128);
+  size_t idb = mpx::encodeHeader(out, cap, pal, nbImages);
+  for (int n = 0; n < nbImages && idb > 0; n++)
+  {
+    for (int i = 0; i < mpx::PIXELS; i++)
+      map[i] = (uint8_t)(2 + ((i + n) / 2) % 16);
+    size_t nb = mpx::encodeImage(out + idb, cap - idb, map, 10);
+    idb = nb ? idb + nb : 0;
+  }
+  return idb;
+}
+
+//
+// Synthetic animation: the full palette, the 222 colors the encoder takes
+// and B&W, in runs of 1 to 4 pixels; noise gives every pixel a random color
+//
+static size_t makeColors(uint8_t* out, size_t cap, int nbImages, bool noise)
+{
+  mpx::PaletteBuilder pal;
+  uint8_t map[mpx::PIXELS];
+  uint32_t seed = 12345;
+
+  for (int c = 0; pal.index((uint8_t)(c * 37), (uint8_t)(c * 11), (uint8_t)c) >= 0; c++)
+    ;
+  size_t idb = mpx::encodeHeader(out, cap, pal, nbImages);
+  for (int n = 0; n < nbImages && idb > 0; n++)
+  {
+    for (int i = 0; i < mpx::PIXELS; i++)
+    {
+      seed = seed * 1103515245 + 12345;
+      map[i] = (uint8_t)((noise ? (seed >> 16) : (i / (1 + i % 4) + 7 * n)) % pal.size());
+    }
+    size_t nb = mpx::encodeImage(out + idb, cap - idb, map, 7);
+    idb = nb ? idb + nb : 0;
+  }
+  return idb;
+}
+
+//
+// FNV-1a 64, golden hashes
+//
+static uint64_t fnv(const void* data, size_t len, uint64_t h = 1469598103934665603ULL)
+{
+  const uint8_t* p = (const uint8_t*)data;
+  for (size_t i = 0; i < len; i++)
+    h = (h ^ p[i]) * 1099511628211ULL;
+  return h;
+}
+
+struct Pipeline
+{
+  std::string name;
+  size_t   bytes;
+  int      images;
+  double   encodeNs;                   // per image
+  double   decodeNs;
+  double   renderNs;
+  double   verifiedNs;                 // renderVerified() after validate()
+  double   reassemblyNs;               // whole file
+  int      packets;
+  uint64_t encodeHash;                 // encoded images
+  uint64_t ledsHash;                   // LEDs of every image, brightness 1 and 3
+  uint64_t extHash;                    // extended variant with deltas
+  const char* golden;                  // "ok", "new", "CHANGED", "FAILED"
+};
+
+//
+// Encode, decode, render and UDP reassembly of one animation, the hashes of
+// its outputs; the extended variant and the reassembled file are checked
+//
+static bool benchPipeline(const char* name, const uint8_t* data, size_t len, Pipeline& r)
+{
+  static uint8_t maps[mpx::MAX_IMAGES][mpx::PIXELS];
+  static uint8_t encoded[64 * 1024];
+  static uint8_t ext[64 * 1024];
+  static uint8_t rebuilt[64 * 1024];
+  static uint8_t packets[2][64][mpxudp::PACKET_SIZE];
+  static size_t  packetLen[64];
+  static Led leds[mpx::PIXELS];
+  static Led extLeds[mpx::PIXELS];
+  static mpx::FrameIndex idx;
+  static mpx::FrameIndex extIdx;
+  uint8_t palCol[mpx::PAL_SIZE * 3] = { 0 };
+  Led palScaled[mpx::PAL_SIZE];
+  int tempos[mpx::MAX_IMAGES];
+  mpx::Header hdr;
+  mpx::Header extHdr;
+  mpx::Image img;
+
+  r.name = name;
+  r.bytes = len;
+  r.images = 0;
+  r.golden = "FAILED";
+  int count = mpxudp::chunkCount(len);
+  size_t extLen = makeExtended(data, len, ext, sizeof(ext), true);
+  if (!mpx::readHeader(data, len, hdr) || !mpx::buildIndex(data, len, hdr, idx) || count > 64 ||
+      extLen == 0 || !mpx::readHeader(ext, extLen, extHdr) || !mpx::buildIndex(ext, extLen, extHdr, extIdx))
+  {
+    printf("%-8s no pipeline, FAILED\n", name);
+    return false;
+  }
+  mpx::ImageIterator it(data, len, hdr);
+  while (it.next(img))
+  {
+    tempos[r.images] = img.tempo;
+    mpx::decodeImage(img, maps[r.images++]);
+  }
+
+  size_t encSize = 0;
+  r.encodeNs = timeIt([&]()
+  {
+    size_t idb = 0;
+    for (int i = 0; i < r.images; i++)
+      idb += mpx::encodeImage(encoded + idb, sizeof(encoded) - idb, maps[i], tempos[i]);
+    encSize = idb;
+    benchSink = (unsigned)idb;
+  }) / r.images * 1e9;
+  r.encodeHash = fnv(encoded, encSize);
+
+  r.decodeNs = timeIt([&]()
+  {
+    uint8_t map[mpx::PIXELS];
+    unsigned sum = 0;
+    for (int n = 0; n < r.images; n++)
+    {
+      mpx::indexedImage(data, idx, n, img);
+      sum += mpx::decodeImage(img, map) + map[mpx::PIXELS - 1];
+    }
+    benchSink = sum;
+  }) / r.images * 1e9;
+
+  mpx::readPalette(data, hdr, palCol);
+  bool same = true;
+  r.ledsHash = fnv(NULL, 0);
+  for (int level = 1; level <= 3; level += 2)
+  {
+    mpx::scalePalette(palCol, mpx::PAL_SIZE, level, palScaled);
+    for (int n = 0; n < r.images; n++)
+    {
+      mpx::indexedImage(data, idx, n, img);
+      mpx::renderImage(img, palScaled, leds);
+      r.ledsHash = fnv(leds, sizeof(leds), r.ledsHash);
+      mpx::indexedImage(ext, extIdx, n, img);
+      mpx::renderImage(img, palScaled, extLeds);
+      same = same && memcmp(leds, extLeds, sizeof(leds)) == 0;
+    }
+  }
+  r.extHash = fnv(ext, extLen);
+  r.renderNs = timeIt([&]()
+  {
+    for (int n = 0; n < r.images; n++)
+    {
+      mpx::indexedImage(data, idx, n, img);
+      mpx::renderImage(img, palScaled, leds);
+    }
+    benchSink = leds[0].r;
+  }) / r.images * 1e9;
+  mpx::Animation anim = mpx::Animation();
+  if (!mpx::validate(data, len, anim))
+    same = false;
+  r.verifiedNs = timeIt([&]()
+  {
+    for (int n = 0; n < r.images; n++)
+    {
+      mpx::indexedImage(data, anim.idx, n, img);
+      mpx::renderVerified(img, palScaled, extLeds);
+    }
+    benchSink = extLeds[0].r;
+  }) / r.images * 1e9;
+  same = same && memcmp(leds, extLeds, sizeof(leds)) == 0;
+
+  // two sessions in turn, each run is a new upload for the receiver
+  uint32_t crc = mpxudp::crc32(data, len);
+  for (int s = 0; s < 2; s++)
+    for (int i = 0; i < count; i++)
+      packetLen[i] = mpxudp::makePacket(packets[s][i], mpxudp::DATA, (uint16_t)(s + 1), i, data, len, crc);
+  mpxudp::Receiver rx(rebuilt, sizeof(rebuilt));
+  uint8_t reply[mpxudp::REPLY_SIZE];
+  int session = 0;
+  size_t size = 0;
+  bool rebuiltOk = true;
+  r.packets = count;
+  r.reassemblyNs = timeIt([&]()
+  {
+    for (int i = 0; i < count; i++)
+      rx.onPacket(packets[session][i], packetLen[i], reply);
+    rebuiltOk = rx.takeComplete(size) && size == len && rebuiltOk;
+    session ^= 1;
+  }) * 1e9;
+  rebuiltOk = rebuiltOk && memcmp(rebuilt, data, len) == 0;
+
+  r.golden = same && rebuiltOk ? "new" : "FAILED";
+  return same && rebuiltOk;
+}
+
+//
+// Golden file: one "name images encode leds extended" line per animation
+//
+static int checkGolden(const char* file, std::vector<Pipeline>& results)
+{
+  FILE* fp = fopen(file, "r");
+  if (fp == NULL)
+  {
+    printf("!!! cannot read %s !!!\n", file);
+    return 1;
+  }
+  char line[256];
+  int changed = 0;
+  while (fgets(line, sizeof(line), fp))
+  {
+    char name[64];
+    int images;
+    unsigned long long enc, leds, ext;
+    if (line[0] == '#' || sscanf(line, "%63s %d %llx %llx %llx", name, &images, &enc, &leds, &ext) != 5)
+      continue;
+    for (Pipeline& r : results)
+      if (r.name == name && strcmp(r.golden, "FAILED") != 0)
+      {
+        bool ok = r.images == images && r.encodeHash == enc && r.ledsHash == leds && r.extHash == ext;
+        r.golden = ok ? "ok" : "CHANGED";
+        changed += !ok;
+      }
+  }
+  fclose(fp);
+  return changed;
+}
+
+static bool writeGolden(const char* file, const std::vector<Pipeline>& results)
+{
+  FILE* fp = fopen(file, "w");
+  if (fp == NULL)
+  {
+    printf("!!! cannot write %s !!!\n", file);
+    return false;
+  }
+  fprintf(fp, "# mpxbench %s golden hashes, FNV-1a 64\n", VERSION);
+  fprintf(fp, "# name images encoded-images leds-brightness-1-and-3 extended-mpx\n");
+  for (const Pipeline& r : results)
+    fprintf(fp, "%-8s %3d %016llx %016llx %016llx\n", r.name.c_str(), r.images,
+            (unsigned long long)r.encodeHash, (unsigned long long)r.ledsHash,
+            (unsigned long long)r.extHash);
+  fclose(fp);
+  return true;
+}
+
+static bool writeJson(const char* file, const std::vector<Pipeline>& results, int failures)
+{
+  FILE* fp = fopen(file, "w");
+  if (fp == NULL)
+  {
+    printf("!!! cannot write %s !!!\n", file);
+    return false;
+  }
+  fprintf(fp, "{\n  \"bench\": \"mpxbench\",\n  \"version\": \"%s\",\n", VERSION);
+  fprintf(fp, "  \"min_bench_sec\": %g,\n  \"failures\": %d,\n  \"pipeline\": [\n", minBenchSec, failures);
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    const Pipeline& r = results[i];
+    fprintf(fp, "    { \"name\": \"%s\", \"bytes\": %zu, \"images\": %d, \"packets\": %d,\n",
+            r.name.c_str(), r.bytes, r.images, r.packets);
+    fprintf(fp, "      \"encode_ns_per_image\": %.1f, \"decode_ns_per_image\": %.1f, "
+                "\"render_ns_per_image\": %.1f, \"render_verified_ns_per_image\": %.1f, "
+                "\"reassembly_ns\": %.1f,\n",
+            r.encodeNs, r.decodeNs, r.renderNs, r.verifiedNs, r.reassemblyNs);
+    fprintf(fp, "      \"encode_hash\": \"%016llx\", \"leds_hash\": \"%016llx\", "
+                "\"ext_hash\": \"%016llx\", \"golden\": \"%s\" }%s\n",
+            (unsigned long long)r.encodeHash, (unsigned long long)r.ledsHash,
+            (unsigned long long)r.extHash, r.golden, i + 1 < results.size() ? "," : "");
+  }
+  fprintf(fp, "  ]\n}\n");
+  fclose(fp);
+  return true;
+}
+
+//
+// The tables of v1.0 to v1.5, returns the number of failures
+//
+static int benchTables()
+{
+  static uint8_t maps[mpx::MAX_IMAGES][mpx::PIXELS];
+  static uint8_t encoded[64 * 1024];
+  int motifPixels[sizeof(motifs) / sizeof(motifs[0])] = { 0 };
+  int failures = 0;
+
+  printf("%-8s %6s %6s | %11s %11s | %11s %11s | %s\n", "motif", "bytes", "images",
+         "decode MB/s", "img/s", "encode MB/s", "img/s", "round trip");
+
+  for (const Motif& m : motifs)
+  {
+    const uint8_t* data = (const uint8_t*)m.data;
+    mpx::Header hdr;
+    mpx::Image img;
+    int nbImages = 0;
+
+    if (!mpx::readHeader(data, m.size, hdr))
+    {
+      printf("%-8s bad header\n", m.name);
+      failures++;
+      continue;
+    }
+
+    // reference decode, keeps the image maps for the encoder
+    mpx::ImageIterator it(data, m.size, hdr);
+    int tempos[mpx::MAX_IMAGES];
+    while (it.next(img))
+    {
+      tempos[nbImages] = img.tempo;
+      mpx::decodeImage(img, maps[nbImages++]);
+    }
+
+    double tdec = timeIt([&]()
+    {
+      mpx::ImageIterator iter(data, m.size, hdr);
+      mpx::Image im;
+      uint8_t map[mpx::PIXELS];
+      unsigned sum = 0;
+      while (iter.next(im))
+        sum += mpx::decodeImage(im, map) + map[mpx::PIXELS - 1];
+      benchSink = sum;
+    });
+
+    size_t encSize = 0;
+    double tenc = timeIt([&]()
+    {
+      size_t idb = 0;
+      for (int i = 0; i < nbImages; i++)
+        idb += mpx::encodeImage(encoded + idb, sizeof(encoded) - idb, maps[i], tempos[i]);
+      encSize = idb;
+      benchSink = (unsigned)idb;
+    });
+
+    // encoded images must match the motif, at least decode to the same maps
+    bool same = (hdr.firstImage + encSize == m.size) &&
+                memcmp(encoded, data + hdr.firstImage, encSize) == 0;
+    bool samePixels = true;
+    mpx::Header encHdr = hdr;
+    encHdr.firstImage = 0;
+    mpx::ImageIterator encIt(encoded, encSize, encHdr);
+    for (int i = 0; i < nbImages; i++)
+    {
+      uint8_t map[mpx::PIXELS];
+      if (!encIt.next(img) || mpx::decodeImage(img, map) != mpx::PIXELS ||
+          memcmp(map, maps[i], mpx::PIXELS) != 0)
+        samePixels = false;
+    }
+    if (!samePixels)
+      failures++;
+    motifPixels[&m - motifs] = nbImages * mpx::PIXELS;
+
+    size_t imgBytes = m.size - hdr.firstImage;
+    printf("%-8s %6zu %6d | %11.1f %11.0f | %11.1f %11.0f | %s\n", m.name, m.size, nbImages,
+           m.size / tdec / 1e6, nbImages / tdec,
+           imgBytes / tenc / 1e6, nbImages / tenc,
+           same ? "identical" : (samePixels ? "same pixels" : "FAILED"));
+  }
+
+  printf("\n%-8s %6s %6s | %11s %11s |\n", "palette", "pixels", "colors",
+         "hash Mpix/s", "linear");
+  for (const Motif& m : motifs)
+  {
+    const uint8_t* data = (const uint8_t*)m.data;
+    int nbPix = motifPixels[&m - motifs];
+    mpx::Header hdr;
+    mpx::Image img;
+    uint8_t palCol[mpx::PAL_SIZE * 3];
+    uint8_t* rgb = rgbPix;
+
+    if (nbPix == 0 || !mpx::readHeader(data, m.size, hdr))
+      continue;
+    mpx::readPalette(data, hdr, palCol);
+    mpx::ImageIterator it(data, m.size, hdr);
+    while (it.next(img))
+    {
+      uint8_t map[mpx::PIXELS];
+      mpx::decodeImage(img, map);
+      for (int i = 0; i < mpx::PIXELS; i++, rgb += 3)
+        memcpy(rgb, palCol + 3*map[i], 3);
+    }
+    benchPalette(m.name, rgbPix, nbPix);
+  }
+
+  // worst case: every pixel of 10 images among the 222 colors the encoder takes
+  int nbPix = 10 * mpx::PIXELS;
+  for (int i = 0; i < nbPix; i++)
+  {
+    int c = (i * 97) % mpx::ENC_COLORS + 1;
+    rgbPix[3*i]     = (uint8_t)c;
+    rgbPix[3*i + 1] = (uint8_t)(c * 7);
+    rgbPix[3*i + 2] = (uint8_t)(c * 13);
+  }
+  benchPalette("222col", rgbPix, nbPix);
+
+  printf("\n%-8s %6s %6s | %11s %11s | %11s |\n", "seek", "bytes", "images",
+         "scan us", "indexed us", "index us");
+  for (const Motif& m : motifs)
+    benchSeek(m.name, (const uint8_t*)m.data, m.size);
+  size_t stripeSize = makeStripes(encoded, sizeof(encoded), 100);
+  benchSeek("stripes", encoded, stripeSize);
+
+  printf("\n%-8s %6s %6s | %11s %11s | %11s |\n", "render", "bytes", "images",
+         "pixel us", "span us", "scale us");
+  for (const Motif& m : motifs)
+    failures += !benchRender(m.name, (const uint8_t*)m.data, m.size, 1);
+  failures += !benchRender("stripes", encoded, stripeSize, 1);
+
+  printf("\n%-8s %6s %6s | %11s %11s | %11s %11s |\n", "delta", "bytes", "images",
+         "delta bytes", "deltas", "full us", "delta us");
+  for (const Motif& m : motifs)
+    failures += !benchDelta(m.name, (const uint8_t*)m.data, m.size);
+  failures += !benchDelta("stripes", encoded, stripeSize);
+  size_t spriteSize = makeSprite(encoded, sizeof(encoded), 64);
+  failures += !benchDelta("sprite", encoded, spriteSize);
+
+  printf("\n%-8s %6s %6s | %7s %7s %7s %3s | %6s | %7s %7s |\n", "dense", "bytes", "images",
+         "rle", "long", "packed", "nb", "dense", "rle ns", "dns ns");
+  for (const Motif& m : motifs)
+    failures += !benchDense(m.name, (const uint8_t*)m.data, m.size);
+  stripeSize = makeStripes(encoded, sizeof(encoded), 100);
+  failures += !benchDense("stripes", encoded, stripeSize);
+  spriteSize = makeSprite(encoded, sizeof(encoded), 64);
+  failures += !benchDense("sprite", encoded, spriteSize);
+  size_t ditherSize = makeDither(encoded, sizeof(encoded), 16);
+  failures += !benchDense("dither", encoded, ditherSize);
+
+  return failures;
+}
+
+int main(int argc, char** argv)
+{
+  int failures = 0;
+  bool pipelineOnly = false;
+  const char* jsonFile = NULL;
+  const char* goldenFile = NULL;
+  const char* updateFile = NULL;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-pipeline") == 0)
+      pipelineOnly = true;
+    else if (strcmp(argv[i], "-fast") == 0)
+      minBenchSec = 0.02;
+    else if (strcmp(argv[i], "-json") == 0 && i + 1 < argc)
+      jsonFile = argv[++i];
+    else if (strcmp(argv[i], "-golden") == 0 && i + 1 < argc)
+      goldenFile = argv[++i];
+    else if (strcmp(argv[i], "-update") == 0 && i + 1 < argc)
+      updateFile = argv[++i];
+    else
+    {
+      printf("syntaxe: %s [-pipeline] [-fast] [-json file] [-golden file] [-update file]\n", argv[0]);
+      return 1;
+    }
+  }
+  printf("%s %s\n\n", argv[0], VERSION);
+  if (!pipelineOnly)
+    failures += benchTables();
+  std::vector<Pipeline> results;
+  auto run = [&](const char* name, const uint8_t* data, size_t len)
+  {
+    Pipeline r;
+    failures += !benchPipeline(name, data, len, r);
+    results.push_back(r);
+  };
+  static uint8_t synth[64 * 1024];
+  for (const Motif& m : motifs)
+    run(m.name, (const uint8_t*)m.data, m.size);
+  run("stripes", synth, makeStripes(synth, sizeof(synth), 100));
+  run("sprite", synth, makeSprite(synth, sizeof(synth), 64));
+  run("dither", synth, makeDither(synth, sizeof(synth), 16));
+  run("colors", synth, makeColors(synth, sizeof(synth), 10, false));
+  run("noise", synth, makeColors(synth, sizeof(synth), 12, true));
+
+  if (goldenFile != NULL)
+    failures += checkGolden(goldenFile, results);
+  if (!pipelineOnly)
+    printf("\n");
+  printf("%-8s %6s %6s | %9s %9s %9s %9s | %9s %4s | %s\n", "pipeline", "bytes", "images",
+         "enc ns", "dec ns", "render ns", "verif ns", "udp us", "pkts", "golden");
+  for (const Pipeline& r : results)
+    printf("%-8s %6zu %6d | %9.0f %9.0f %9.0f %9.0f | %9.2f %4d | %s\n", r.name.c_str(), r.bytes,
+           r.images, r.encodeNs, r.decodeNs, r.renderNs, r.verifiedNs, r.reassemblyNs / 1e3,
+           r.packets, r.golden);
+  if (updateFile != NULL && writeGolden(updateFile, results))
+    printf("\ngolden hashes written to %s\n", updateFile);
+  if (jsonFile != NULL && writeJson(jsonFile, results, failures))
+    printf("\nJSON written to %s\n", jsonFile);
+
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,918 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// mpxconv.cpp
+//
+// 1. Batch version of MegaPix18: many BMP animations to MPX, C++17, no Windows
+// --> the animations come from a manifest, one MegaPix18 command line per
+//     line without the program name:
+//       aa 8 5 D
+//       sprites/z 2 0 M 10 100
+//     or from a directory: every aa1.bmp, aa2.bmp... series is one animation,
+//     with the -tempo and -M / -C / -D options
+// --> each animation goes through four stages: read the BMP, palette and
+//     color maps, encode (classic MPX, C source or extended MPX as with
+//     MegaPix18), write the file
+// --> -j threads take the stages from one queue, later stages first, so the
+//     animations flow through the pipeline instead of all being read first
+// --> an animation only depends on its own files: the output does not depend
+//     on -j, -check converts the batch with one thread then with -j threads
+//     and compares every output byte
+// --> throughput report in animations/s and images/s, time spent per stage
+// --> -demo n writes n test animations of 8 images in the directory first
+// --> -stream converts PPM or Y4M frames (framein.h) from a file or stdin,
+//     one frame in memory at a time: identical frames are merged into one
+//     image, the tempos come from the frame rate (Y4M header or -fps) and
+//     the stream time, so there is no rounding drift; a new MPX is started
+//     when the palette or the 255 images are full, an image over 255 tempo
+//     units is repeated
+// --> -unit us sets the tempo unit of the extended MPX (-D, multiple of
+//     100 us): with -unit 1000 the images of a 30 fps stream last 33 and
+//     34 ms instead of 30 and 40 ms; a frame over 255 units (30 fps with
+//     -unit 100) is repeated like any long image, the report says so
+// --> an animation over the 222 colors of an MPX, or over -colors n, gets
+//     one palette for all its images from quantize.h, -dither ordered or
+//     -dither fs (Floyd-Steinberg); the report gives the time to build the
+//     palette and, per image, the mapping time and the error in Oklab x100.
+//     Animations that fit keep their exact colors and bytes.
+//
+// usage: mpxconv [-j n] [-o dir] [-M | -C | -D] [-tempo n] [-colors n]
+//                [-dither none | ordered | fs] [-check] [-q] [-demo n] directory | manifest
+//        mpxconv -stream name [-fps n] [-unit us] [-o dir] [-M | -C | -D] [-q] [file]
+//        ffmpeg -i clip.mp4 -vf scale=32:16:flags=neighbor,fps=20 -f yuv4mpegpipe - |
+//          mpxconv -stream clip -D
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Thread pool pipeline, directory and manifest
+// v1.1   15 Oct. 2026     PPM and Y4M streams
+// v1.2   15 Oct. 2026     Tempo unit of the streams
+// v1.3   15 Oct. 2026     Quantization and dithering of the animations over the palette
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "mpx.h"
+#include "bmpfile.h"
+#include "framein.h"
+#include "quantize.h"
+
+#define VERSION "v1.3  2026-10-15"
+
+#define DEFAULT_TEMPO 30
+#define DEMO_IMAGES   8
+#define DEFAULT_FPS   25             // PPM streams have no frame rate
+
+namespace fs = std::filesystem;
+typedef std::chrono::steady_clock Clock;
+
+enum Stage { READ, PALETTE, ENCODE, WRITE, NB_STAGES };
+
+static const char* stageNames[NB_STAGES] = { "read", "palette", "encode", "write" };
+
+struct Job
+{
+  std::string prefix;                  // BMP files are prefix1.bmp, prefix2.bmp...
+  std::string name;                    // C array name
+  std::string output;
+  char        format;                  // 'M', 'C' or 'D' as MegaPix18 arg#4
+  int         nbImages;
+  std::vector<int> tempos;
+  int         maxColors;               // B&W excluded, quantized over it
+  quant::Dither dither;
+
+  std::vector<uint8_t> rgb;            // READ
+  mpx::PaletteBuilder  pal;            // PALETTE
+  std::vector<uint8_t> maps;
+  bool        quantized;
+  double      quantMs;                 // palette of the quantizer
+  std::vector<quant::ImageError> imageErr;
+  std::vector<double>  imageMs;        // mapping of each image
+  std::vector<uint8_t> out;            // ENCODE, file content
+  bool        extended;                // 'D' and smaller than the classic MPX
+  std::string error;                   // first failure, the job stops there
+  double      ms[NB_STAGES];
+};
+
+static double msSince(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+//---------------------------------------------------------------------------------
+// Stages
+//---------------------------------------------------------------------------------
+
+static void readStage(Job& job)
+{
+  int width, height;
+
+  job.rgb.resize((size_t)job.nbImages * mpx::PIXELS * 3);
+  for (int n = 0; n < job.nbImages; n++)
+  {
+    std::string file = job.prefix + std::to_string(n + 1) + ".bmp";
+    if (!bmpfile::read(file.c_str(), &job.rgb[(size_t)n * mpx::PIXELS * 3], mpx::PIXELS,
+                       width, height) || width != mpx::WIDTH || height != mpx::HEIGHT)
+    {
+      job.error = file + " is not a 16x32 24 bit BMP image";
+      return;
+    }
+  }
+}
+
+//
+// One palette of job.maxColors for all the images, B&W kept
+//
+static void quantizeImages(Job& job)
+{
+  Clock::time_point t0 = Clock::now();
+  quant::Quantizer quantizer;
+  uint8_t remap[quant::MAX_COLORS];
+
+  quantizer.build(job.rgb.data(), job.maps.size(), job.maxColors);
+  job.pal.clear();
+  for (int k = 0; k < quantizer.size(); k++)       // two colors may round the same
+    remap[k] = (uint8_t)job.pal.index(quantizer.color(k).R, quantizer.color(k).G,
+                                      quantizer.color(k).B);
+  job.quantMs = msSince(t0);
+
+  job.imageErr.resize(job.nbImages);
+  job.imageMs.resize(job.nbImages);
+  for (int n = 0; n < job.nbImages; n++)
+  {
+    t0 = Clock::now();
+    uint8_t* map = &job.maps[(size_t)n * mpx::PIXELS];
+    job.imageErr[n] = quantizer.map(&job.rgb[(size_t)n * mpx::PIXELS * 3], mpx::WIDTH, mpx::HEIGHT,
+                                    job.dither, map);
+    for (int p = 0; p < mpx::PIXELS; p++)
+      map[p] = remap[map[p]];
+    job.imageMs[n] = msSince(t0);
+  }
+  job.quantized = true;
+}
+
+static void paletteStage(Job& job)
+{
+  const uint8_t* rgb = job.rgb.data();
+  bool exact = true;
+
+  job.pal.clear();
+  job.quantized = false;
+  job.maps.resize((size_t)job.nbImages * mpx::PIXELS);
+  for (size_t p = 0; p < job.maps.size() && exact; p++, rgb += 3)
+  {
+    int idx = job.pal.index(rgb[0], rgb[1], rgb[2]);
+    exact = idx >= 0;
+    job.maps[p] = (uint8_t)idx;
+  }
+  if (!exact || job.pal.size() - 2 > job.maxColors)
+    quantizeImages(job);
+  std::vector<uint8_t>().swap(job.rgb);    // not needed any more
+}
+
+//
+// C source of a classic MPX as MegaPix18 writes it, one line per image line
+//
+static void sourceText(const std::string& name, const std::vector<uint8_t>& mpx,
+                       std::vector<uint8_t>& out)
+{
+  char text[64];
+  std::string src;
+  int nbColors = mpx[0];
+  int nbImages = mpx[1];
+  size_t k = 2;
+
+  snprintf(text, sizeof(text), "char %s[%zu] = {", name.c_str(), mpx.size());
+  src = text;
+  if (src.size() < 27)
+    src.append(27 - src.size(), ' ');       // MegaPix18 writes over 27 spaces
+  snprintf(text, sizeof(text), "\n%3d, %3d,\n", nbColors, nbImages);
+  src += text;
+  for (int i = 0; i < nbColors; i++, k += 3)
+  {
+    snprintf(text, sizeof(text), "%3u, %3u, %3u, ", mpx[k], mpx[k + 1], mpx[k + 2]);
+    src += text;
+    if ((i + 1) % 8 == 0)
+      src += "\n";
+  }
+  src += "\n";
+  for (int n = 0; n < nbImages; n++)
+  {
+    snprintf(text, sizeof(text), " %3d,\n", mpx[k++]);
+    src += text;
+    for (int pix = 0; pix < mpx::PIXELS; )   // encodeImage() runs stop at the line end
+    {
+      uint8_t data = mpx[k++];
+      pix += data >= mpx::CODE_BASE ? 1 : data;
+      bool endOfLine = pix % mpx::WIDTH == 0;
+      snprintf(text, sizeof(text), endOfLine && data < mpx::CODE_BASE ? "0x%02x, " : "0x%02X, ", data);
+      src += text;
+      if (endOfLine)
+        src += "\n";
+    }
+    k++;                                     // 0x00
+    src += n + 1 < nbImages ? "0x00,\n" : "0x00 };\n";
+  }
+  out.assign(src.begin(), src.end());
+}
+
+//
+// File content: the extended MPX for 'D' when it is smaller than the classic
+// one or when it must be kept (tempo unit), the C source for 'C'. True when
+// the extended MPX is kept.
+//
+static bool fileContent(const std::string& name, char format, std::vector<uint8_t>& classic,
+                        std::vector<uint8_t>& ext, std::vector<uint8_t>& out, bool needExt = false)
+{
+  bool extended = format == 'D' && (needExt || ext.size() < classic.size());
+  if (format == 'C')
+    sourceText(name, classic, out);
+  else
+    out.swap(extended ? ext : classic);
+  return extended;
+}
+
+static void encodeStage(Job& job)
+{
+  size_t cap = 2 + 3 * mpx::MAX_COLORS + (size_t)job.nbImages * (2 * mpx::PIXELS + 2 + mpx::EXT_IMAGE_HEADER);
+  std::vector<uint8_t> buffer(cap);
+  size_t idb = mpx::encodeHeader(buffer.data(), cap, job.pal, job.nbImages);
+
+  for (int n = 0; n < job.nbImages; n++)
+    idb += mpx::encodeImage(&buffer[idb], cap - idb, &job.maps[(size_t)n * mpx::PIXELS],
+                            job.tempos[n]);
+  buffer.resize(idb);
+
+  std::vector<uint8_t> ext;
+  if (job.format == 'D')
+  {
+    ext.resize(cap + 1);
+    size_t extBytes = mpx::encodeExtHeader(ext.data(), ext.size(), job.pal, job.nbImages,
+                                           mpx::FLAG_DELTA);
+    for (int n = 0; n < job.nbImages; n++)
+    {
+      const uint8_t* map = &job.maps[(size_t)n * mpx::PIXELS];
+      extBytes += mpx::encodeExtImage(&ext[extBytes], ext.size() - extBytes, map,
+                                      n > 0 ? map - mpx::PIXELS : NULL, job.tempos[n]);
+    }
+    ext.resize(extBytes);
+  }
+  job.extended = fileContent(job.name, job.format, buffer, ext, job.out);
+  std::vector<uint8_t>().swap(job.maps);
+}
+
+static void writeStage(Job& job)
+{
+  FILE* fp = fopen(job.output.c_str(), "wb");
+  if (fp == NULL || fwrite(job.out.data(), 1, job.out.size(), fp) != job.out.size())
+    job.error = "cannot write " + job.output;
+  if (fp != NULL && fclose(fp) != 0 && job.error.empty())
+    job.error = "cannot write " + job.output;
+}
+
+static void runStage(Job& job, int stage)
+{
+  Clock::time_point t0 = Clock::now();
+  switch (stage)
+  {
+  case READ:    readStage(job); break;
+  case PALETTE: paletteStage(job); break;
+  case ENCODE:  encodeStage(job); break;
+  case WRITE:   writeStage(job); break;
+  }
+  job.ms[stage] = msSince(t0);
+}
+
+//---------------------------------------------------------------------------------
+// Thread pool: one queue per stage, a thread takes the latest stage ready
+//---------------------------------------------------------------------------------
+
+class Pipeline
+{
+public:
+  Pipeline(std::vector<Job>& jobs, int lastStage) : jobs(jobs), lastStage(lastStage) {}
+
+  void run(int nbThreads)
+  {
+    remaining = (int)jobs.size();
+    for (size_t i = 0; i < jobs.size(); i++)
+      queues[READ].push_back((int)i);
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < nbThreads; t++)
+      pool.emplace_back([this]() { work(); });
+    work();                                  // the caller is one of the threads
+    for (std::thread& t : pool)
+      t.join();
+  }
+
+private:
+  void work()
+  {
+    std::unique_lock<std::mutex> guard(lock);
+    for (;;)
+    {
+      int stage = lastStage;
+      while (stage >= 0 && queues[stage].empty())
+        stage--;
+      if (stage < 0)
+      {
+        if (remaining == 0)
+          return;
+        ready.wait(guard);
+        continue;
+      }
+      int i = queues[stage].front();
+      queues[stage].pop_front();
+
+      guard.unlock();
+      runStage(jobs[i], stage);
+      guard.lock();
+
+      if (jobs[i].error.empty() && stage < lastStage)
+        queues[stage + 1].push_back(i);
+      else if (--remaining == 0)
+      {
+        ready.notify_all();
+        continue;
+      }
+      ready.notify_one();
+    }
+  }
+
+  std::vector<Job>& jobs;
+  int lastStage;
+  std::mutex lock;
+  std::condition_variable ready;
+  std::deque<int> queues[NB_STAGES];
+  int remaining;
+};
+
+//---------------------------------------------------------------------------------
+// Batch
+//---------------------------------------------------------------------------------
+
+static std::string outputName(const Job& job, const std::string& outDir)
+{
+  fs::path dir = outDir.empty() ? fs::path(job.prefix).parent_path() : fs::path(outDir);
+  return (dir / (job.name + (job.format == 'C' ? ".c" : ".mpx"))).string();
+}
+
+//
+// Job of a MegaPix18 command line: prefix count tempo format [tempos]
+//
+static bool parseJob(const std::string& line, const fs::path& base, Job& job)
+{
+  char prefix[256];
+  char format[8];
+  int  tempo;
+  int  used;
+
+  if (sscanf(line.c_str(), "%255s %d %d %7s%n", prefix, &job.nbImages, &tempo, format, &used) != 4 ||
+      job.nbImages <= 0 || job.nbImages > mpx::MAX_IMAGES || strchr("MCD", format[0]) == NULL)
+    return false;
+  job.prefix = (base / prefix).string();
+  job.name = fs::path(prefix).filename().string();
+  job.format = format[0];
+  const char* rest = line.c_str() + used;
+  for (int n = 0; n < job.nbImages; n++)
+  {
+    int t = tempo;
+    int len = 0;
+    if (tempo == 0 && sscanf(rest, "%d%n", &t, &len) != 1)
+      return false;                          // no question in a batch
+    rest += len;
+    job.tempos.push_back(t);
+  }
+  return true;
+}
+
+static bool readManifest(const fs::path& manifest, std::vector<Job>& jobs)
+{
+  FILE* fp = fopen(manifest.string().c_str(), "r");
+  char line[1024];
+  int nbLine = 0;
+
+  if (fp == NULL)
+    return false;
+  while (fgets(line, sizeof(line), fp) != NULL)
+  {
+    nbLine++;
+    char* text = line + strspn(line, " \t");
+    if (*text == '#' || *text == '\n' || *text == '\r' || *text == 0)
+      continue;
+    Job job = Job();
+    if (!parseJob(text, manifest.parent_path(), job))
+    {
+      printf("!!! %s line %d: prefix number_of_bmp tempo_or_0 C_or_M_or_D [tempo_values] !!!\n",
+             manifest.string().c_str(), nbLine);
+      fclose(fp);
+      return false;
+    }
+    jobs.push_back(job);
+  }
+  fclose(fp);
+  return true;
+}
+
+//
+// Every prefix1.bmp of the directory starts an animation of the following
+// prefix2.bmp, prefix3.bmp... Sorted by prefix.
+//
+static void scanDirectory(const fs::path& dir, char format, int tempo, std::vector<Job>& jobs)
+{
+  std::map<std::string, int> series;
+
+  for (const fs::directory_entry& e : fs::directory_iterator(dir))
+  {
+    std::string file = e.path().filename().string();
+    if (!e.is_regular_file() || file.size() < 6 || file.compare(file.size() - 5, 5, "1.bmp") != 0)
+      continue;
+    std::string prefix = file.substr(0, file.size() - 5);
+    if (!prefix.empty() && isdigit((unsigned char)prefix.back()))
+      continue;                              // aa11.bmp, aa21.bmp...
+    int n = 1;
+    while (n < mpx::MAX_IMAGES && fs::exists(dir / (prefix + std::to_string(n + 1) + ".bmp")))
+      n++;
+    series[prefix] = n;
+  }
+  for (const auto& s : series)
+  {
+    Job job = Job();
+    job.prefix = (dir / s.first).string();
+    job.name = s.first;
+    job.format = format;
+    job.nbImages = s.second;
+    job.tempos.assign(s.second, tempo);
+    jobs.push_back(job);
+  }
+}
+
+//
+// n test animations of DEMO_IMAGES images in dir: colored tiles and a moving
+// block, the number of colors grows with the animation
+//
+static bool writeDemo(const fs::path& dir, int nbAnims)
+{
+  uint8_t rgb[mpx::PIXELS * 3];
+
+  fs::create_directories(dir);
+  for (int a = 0; a < nbAnims; a++)
+  {
+    for (int n = 0; n < DEMO_IMAGES; n++)
+    {
+      for (int p = 0; p < mpx::PIXELS; p++)
+      {
+        int x = p % mpx::WIDTH;
+        int y = p / mpx::WIDTH;
+        int tile = (x / 4 + y / 4 * 8 + a) % (4 + a % 60);
+        bool block = x / 4 == (n + a) % 8 && y / 4 == (n / 2 + a) % 4;
+        rgb[3*p]     = block ? 255 : (uint8_t)(tile * 37 + a);
+        rgb[3*p + 1] = block ? 255 : (uint8_t)(tile * 71);
+        rgb[3*p + 2] = block ? 0 : (uint8_t)(200 - tile * 3);
+      }
+      char name[64];
+      snprintf(name, sizeof(name), "demo%03d_%d.bmp", a, n + 1);
+      if (!bmpfile::write((dir / name).string().c_str(), rgb, mpx::WIDTH, mpx::HEIGHT))
+        return false;
+    }
+  }
+  return true;
+}
+
+//---------------------------------------------------------------------------------
+// Stream: PPM or Y4M frames, one MPX image per run of identical frames
+//---------------------------------------------------------------------------------
+
+class StreamWriter
+{
+public:
+  StreamWriter(const std::string& name, const std::string& outDir, char format, double fps,
+               int unitUs, bool quiet)
+    : name(name), outDir(outDir), format(format), fps(fps), unitUs(unitUs), quiet(quiet),
+      frameNo(0), pendingStart(0), hasPending(false), hasPrev(false), nbImages(0),
+      parts(0), images(0), dropped(0), split(0), bytes(0) {}
+
+  //
+  // One frame of R,G,B triplets, false if it cannot fit in any MPX
+  //
+  bool frame(const uint8_t* rgb)
+  {
+    uint8_t map[mpx::PIXELS];
+
+    if (!toMap(rgb, map))                    // palette full, next MPX
+    {
+      if (!closeImage(frameNo) || !flush())
+        return false;
+      pal.clear();
+      if (!toMap(rgb, map))
+      {
+        err = "frame " + std::to_string(frameNo + 1) + " has more than " +
+              std::to_string(mpx::ENC_COLORS) + " colors";
+        return false;
+      }
+    }
+    if (hasPending && memcmp(map, pending, sizeof(map)) == 0 &&
+        tempoOf(pendingStart, frameNo + 1) <= 255)
+    {
+      frameNo++;                             // same image, longer tempo
+      return true;
+    }
+    if (hasPending && tempoOf(pendingStart, frameNo) == 0)
+      dropped++;                             // under one unit, replaced
+    else
+    {
+      if (!closeImage(frameNo))
+        return false;
+      pendingStart = frameNo;
+      if (nbImages == mpx::MAX_IMAGES && !flush())
+        return false;
+    }
+    memcpy(pending, map, sizeof(map));
+    hasPending = true;
+    frameNo++;
+    return true;
+  }
+
+  bool finish()
+  {
+    return closeImage(frameNo) && flush();
+  }
+
+  void report(double ms) const
+  {
+    double s = ms / 1000.0;
+    printf("%ld frames at %.3f fps, %d images (%ld frames merged, %d dropped, %d split) in %d MPX, %ld bytes\n",
+           frameNo, fps, images, frameNo - (images - split) - dropped, dropped, split, parts, bytes);
+    printf("%.1f ms, %.0f frames/s\n", ms, s > 0 ? frameNo / s : 0);
+  }
+
+  const std::string& error() const { return err; }
+
+private:
+  bool toMap(const uint8_t* rgb, uint8_t* map)
+  {
+    mpx::PaletteBuilder trial = pal;         // no color of a rejected frame
+    for (int p = 0; p < mpx::PIXELS; p++, rgb += 3)
+    {
+      int idx = trial.index(rgb[0], rgb[1], rgb[2]);
+      if (idx < 0)
+        return false;
+      map[p] = (uint8_t)idx;
+    }
+    pal = trial;
+    return true;
+  }
+
+  //
+  // Tempo in units of the frames first to end (excluded), from the stream
+  // time so that the rounding does not drift
+  //
+  int tempoOf(long first, long end) const
+  {
+    double perFrame = 1e6 / unitUs / fps;
+    return (int)(llround(end * perFrame) - llround(first * perFrame));
+  }
+
+  //
+  // Closes the pending image, repeated when it lasts more than the 255 units
+  // of one tempo byte, false if a full MPX cannot be written
+  //
+  bool closeImage(long end)
+  {
+    uint8_t image[2 * mpx::PIXELS + 2 + mpx::EXT_IMAGE_HEADER];
+
+    if (!hasPending)
+      return true;
+    int left = tempoOf(pendingStart, end);
+    if (left < 1)
+      left = 1;                              // last frame under one unit
+    for (bool first = true; left > 0; first = false)
+    {
+      int tempo = left > 255 ? 255 : left;
+      left -= tempo;
+      if (nbImages == mpx::MAX_IMAGES && !flush())
+        return false;
+      if (!first)
+        split++;
+      size_t nb = mpx::encodeImage(image, sizeof(image), pending, tempo);
+      classic.insert(classic.end(), image, image + nb);
+      if (format == 'D')
+      {
+        nb = mpx::encodeExtImage(image, sizeof(image), pending, hasPrev ? prev : NULL, tempo);
+        ext.insert(ext.end(), image, image + nb);
+        memcpy(prev, pending, sizeof(prev));
+        hasPrev = true;
+      }
+      nbImages++;
+    }
+    hasPending = false;
+    return true;
+  }
+
+  //
+  // Writes the MPX of the images closed so far: name.mpx, then name2.mpx...
+  //
+  bool flush()
+  {
+    uint8_t header[2 + 3 * mpx::MAX_COLORS + 2];
+    std::vector<uint8_t> out;
+
+    if (nbImages == 0)
+      return true;
+    parts++;
+    std::string part = name + (parts > 1 ? std::to_string(parts) : "");
+    fs::path file = fs::path(outDir) / (part + (format == 'C' ? ".c" : ".mpx"));
+    size_t nb = mpx::encodeHeader(header, sizeof(header), pal, nbImages);
+    classic.insert(classic.begin(), header, header + nb);
+    nb = mpx::encodeExtHeader(header, sizeof(header), pal, nbImages, mpx::FLAG_DELTA, unitUs);
+    ext.insert(ext.begin(), header, header + nb);
+    bool extended = fileContent(part, format, classic, ext, out, unitUs != mpx::TEMPO_US);
+
+    FILE* fp = fopen(file.string().c_str(), "wb");
+    bool ok = fp != NULL && fwrite(out.data(), 1, out.size(), fp) == out.size();
+    if (fp == NULL || fclose(fp) != 0 || !ok)
+    {
+      err = "cannot write " + file.string();
+      return false;
+    }
+    if (!quiet)
+      printf("%-24s %3d images %3d colors %6zu bytes%s\n", file.string().c_str(), nbImages,
+             pal.size() - 2, out.size(), extended ? " (extended)" : "");
+    images += nbImages;
+    bytes += (long)out.size();
+    nbImages = 0;
+    hasPrev = false;                         // the first image is never a delta
+    classic.clear();
+    ext.clear();
+    return true;
+  }
+
+  std::string name;
+  std::string outDir;
+  char        format;
+  double      fps;
+  int         unitUs;                        // tempo unit
+  bool        quiet;
+  mpx::PaletteBuilder pal;
+  uint8_t     pending[mpx::PIXELS];          // image being merged
+  uint8_t     prev[mpx::PIXELS];             // last closed image, deltas
+  long        frameNo;
+  long        pendingStart;
+  bool        hasPending;
+  bool        hasPrev;
+  int         nbImages;                      // in the current MPX
+  std::vector<uint8_t> classic;              // images of the current MPX
+  std::vector<uint8_t> ext;
+  int         parts;
+  int         images;
+  int         dropped;
+  int         split;                         // repeats of over-long images
+  long        bytes;
+  std::string err;
+};
+
+static int convertStream(const char* input, const std::string& name, const std::string& outDir,
+                         char format, double fps, int unitUs, bool quiet)
+{
+  FILE* in = input ? fopen(input, "rb") : stdin;
+  if (in == NULL)
+  {
+    printf("!!! cannot read %s !!!\n", input);
+    return 1;
+  }
+  framein::Reader reader(in);
+  if (!reader.open() || reader.frameWidth() != mpx::WIDTH || reader.frameHeight() != mpx::HEIGHT)
+  {
+    printf("!!! %s !!!\n", reader.error().empty() ? "frames must be 32x16" : reader.error().c_str());
+    return 1;
+  }
+  if (fps <= 0)
+    fps = reader.hasRate() ? reader.fps() : DEFAULT_FPS;
+  if (!quiet && 1e6 / fps > 255.0 * unitUs)
+    printf("one frame at %.3f fps is over 255 units of %d us, its images are repeated\n",
+           fps, unitUs);
+
+  Clock::time_point t0 = Clock::now();
+  StreamWriter writer(name, outDir, format, fps, unitUs, quiet);
+  uint8_t rgb[mpx::PIXELS * 3];
+  bool ok = true;
+  while (ok && reader.next(rgb))
+    ok = writer.frame(rgb);
+  ok = ok && reader.error().empty() && writer.finish();
+  if (input)
+    fclose(in);
+  if (!ok)
+    printf("!!! %s !!!\n", writer.error().empty() ? reader.error().c_str() : writer.error().c_str());
+  writer.report(msSince(t0));
+  return ok ? 0 : 1;
+}
+
+struct Report
+{
+  double ms;
+  double stageMs[NB_STAGES];
+  int    images;
+  int    failures;
+};
+
+static Report convert(std::vector<Job>& jobs, int nbThreads, int lastStage)
+{
+  Report r = Report();
+  Pipeline pipeline(jobs, lastStage);
+  Clock::time_point t0 = Clock::now();
+
+  for (Job& job : jobs)
+  {
+    job.error.clear();
+    job.out.clear();
+    memset(job.ms, 0, sizeof(job.ms));
+  }
+  pipeline.run(nbThreads);
+  r.ms = msSince(t0);
+  for (const Job& job : jobs)
+  {
+    for (int s = 0; s < NB_STAGES; s++)
+      r.stageMs[s] += job.ms[s];
+    r.images += job.nbImages;
+    r.failures += !job.error.empty();
+  }
+  return r;
+}
+
+static void printReport(const char* title, const Report& r, size_t nbJobs, int nbThreads)
+{
+  double s = r.ms / 1000.0;
+  printf("%-8s %2d threads: %zu animations, %d images in %.1f ms, %.0f animations/s, %.0f images/s\n",
+         title, nbThreads, nbJobs, r.images, r.ms, s > 0 ? nbJobs / s : 0, s > 0 ? r.images / s : 0);
+  printf("%-8s stages     :", "");
+  for (int st = 0; st < NB_STAGES; st++)
+    printf(" %s %.1f ms", stageNames[st], r.stageMs[st]);
+  printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+  int nbThreads = (int)std::thread::hardware_concurrency();
+  std::string outDir;
+  char format = 'M';
+  int tempo = DEFAULT_TEMPO;
+  bool check = false;
+  bool quiet = false;
+  int demo = 0;
+  const char* stream = NULL;
+  double fps = 0;
+  int unitUs = mpx::TEMPO_US;
+  int colors = mpx::ENC_COLORS;
+  quant::Dither dither = quant::DITHER_NONE;
+  bool badDither = false;
+  const char* input = NULL;
+
+  printf("%s %s\n\n", argv[0], VERSION);
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+      nbThreads = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+      outDir = argv[++i];
+    else if (strcmp(argv[i], "-M") == 0 || strcmp(argv[i], "-C") == 0 || strcmp(argv[i], "-D") == 0)
+      format = argv[i][1];
+    else if (strcmp(argv[i], "-tempo") == 0 && i + 1 < argc)
+      tempo = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-colors") == 0 && i + 1 < argc)
+      colors = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-dither") == 0 && i + 1 < argc)
+    {
+      i++;
+      dither = strcmp(argv[i], "ordered") == 0 ? quant::DITHER_ORDERED :
+               strcmp(argv[i], "fs") == 0 ? quant::DITHER_DIFFUSION : quant::DITHER_NONE;
+      badDither = dither == quant::DITHER_NONE && strcmp(argv[i], "none") != 0;
+    }
+    else if (strcmp(argv[i], "-check") == 0)
+      check = true;
+    else if (strcmp(argv[i], "-q") == 0)
+      quiet = true;
+    else if (strcmp(argv[i], "-demo") == 0 && i + 1 < argc)
+      demo = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-stream") == 0 && i + 1 < argc)
+      stream = argv[++i];
+    else if (strcmp(argv[i], "-fps") == 0 && i + 1 < argc)
+      fps = atof(argv[++i]);
+    else if (strcmp(argv[i], "-unit") == 0 && i + 1 < argc)
+      unitUs = atoi(argv[++i]);
+    else if (argv[i][0] != '-' && input == NULL)
+      input = argv[i];
+    else
+      input = NULL, stream = NULL, i = argc;
+  }
+  bool badUnit = unitUs < mpx::UNIT_STEP_US || unitUs > 255 * mpx::UNIT_STEP_US ||
+                 unitUs % mpx::UNIT_STEP_US != 0 ||
+                 (unitUs != mpx::TEMPO_US && (stream == NULL || format != 'D'));
+  bool badQuant = badDither || colors < 1 || colors > mpx::ENC_COLORS ||
+                  (stream != NULL && (colors != mpx::ENC_COLORS || dither != quant::DITHER_NONE));
+  if ((input == NULL && stream == NULL) || nbThreads <= 0 || tempo <= 0 || tempo > 255 || fps < 0 ||
+      badUnit || badQuant)
+  {
+    printf("syntaxe: %s [-j n] [-o dir] [-M | -C | -D] [-tempo n] [-colors n] [-dither none | ordered | fs]\n", argv[0]);
+    printf("         [-check] [-q] [-demo n] directory | manifest\n");
+    printf("         manifest lines: bmp_name_prefix number_of_bmp tempo_or_0 C_or_M_or_D [tempo_values]\n");
+    printf("         -colors: palette of 1 to %d colors, quantized when the images have more\n", mpx::ENC_COLORS);
+    printf("         %s -stream name [-fps n] [-unit us] [-o dir] [-M | -C | -D] [-q] [file]\n", argv[0]);
+    printf("         PPM or Y4M frames of %dx%d from file or stdin\n", mpx::WIDTH, mpx::HEIGHT);
+    printf("         -unit: tempo unit of -D, %d to %d us by %d\n", mpx::UNIT_STEP_US,
+           255 * mpx::UNIT_STEP_US, mpx::UNIT_STEP_US);
+    return 1;
+  }
+
+  std::vector<Job> jobs;
+  std::error_code ec;
+  if (!outDir.empty())
+    fs::create_directories(outDir, ec);
+  if (stream != NULL)
+    return convertStream(input, stream, outDir, format, fps, unitUs, quiet);
+  if (demo > 0 && !writeDemo(input, demo))
+  {
+    printf("!!! cannot write the demo animations in %s !!!\n", input);
+    return 1;
+  }
+  if (fs::is_directory(input, ec))
+    scanDirectory(input, format, tempo, jobs);
+  else if (!readManifest(input, jobs))
+  {
+    printf("!!! cannot read %s !!!\n", input);
+    return 1;
+  }
+  for (Job& job : jobs)
+  {
+    job.output = outputName(job, outDir);
+    job.maxColors = colors;
+    job.dither = dither;
+  }
+
+  std::vector<std::vector<uint8_t> > single;
+  if (check)                                 // reference outputs, nothing written
+  {
+    Report r = convert(jobs, 1, ENCODE);
+    printReport("single", r, jobs.size(), 1);
+    for (const Job& job : jobs)
+      single.push_back(job.out);
+  }
+
+  Report r = convert(jobs, nbThreads, WRITE);
+  int differ = 0;
+  for (size_t i = 0; i < jobs.size(); i++)
+  {
+    const Job& job = jobs[i];
+    bool same = !check || job.out == single[i];
+    differ += !same;
+    if (!job.error.empty())
+      printf("!!! %s !!!\n", job.error.c_str());
+    else if (!quiet || !same)
+    {
+      printf("%-24s %3d images %3d colors %6zu bytes%s%s%s\n", job.output.c_str(), job.nbImages,
+             job.pal.size() - 2, job.out.size(), job.extended ? " (extended)" : "",
+             job.quantized ? " (quantized)" : "", same ? "" : "  DIFFERS FROM ONE THREAD");
+      if (job.quantized && !quiet)
+      {
+        printf("    palette in %.2f ms\n", job.quantMs);
+        for (int n = 0; n < job.nbImages; n++)
+          printf("    image %3d  error mean %5.2f max %6.2f  %.3f ms\n", n + 1,
+                 job.imageErr[n].mean, job.imageErr[n].max, job.imageMs[n]);
+      }
+    }
+  }
+  printReport("batch", r, jobs.size(), nbThreads);
+  if (check)
+    printf("outputs identical to one thread: %s\n", differ ? "NO" : "yes");
+  return r.failures || differ ? 1 : 0;
+}
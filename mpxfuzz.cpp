@@ -0,0 +1,234 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// mpxfuzz.cpp
+//
+// 1. Fuzz harness of the MPX ingest: mpx::validate() then the unchecked render
+// --> an input that validates is drawn image by image with renderVerified()
+//     into an LED array and a palette of exactly nbPal colors, the input, the
+//     palette and the LEDs each in its own heap block of the exact size, so
+//     AddressSanitizer stops on the first byte read or written out of bounds
+// --> the checked renderImage() must give the same LEDs after every image:
+//     validate() must not accept an image the checked decoder would clamp
+// --> clang: libFuzzer entry point, cmake -DMPX_FUZZ=ON, corpus of MPX files
+//       ./build/mpxfuzz -max_len=20000 corpus/
+// --> g++: standalone driver, the motifs of motifsMPX.h, their extended
+//     variants (delta, long runs, packed, tempo unit) and n random mutations of them;
+//     -DMPX_FUZZ=ON adds AddressSanitizer and UBSan
+//
+// usage: mpxfuzz [-n count] [-seed n] [file.mpx ...]
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Validator and unchecked render
+// v1.1   15 Oct. 2026     Tempo unit in the corpus
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "mpx.h"
+#include "mpxrender.h"
+#include "motifsMPX.h"
+
+#define VERSION "v1.1  2026-10-15"
+
+struct Led                             // CRGB layout
+{
+  uint8_t r, g, b;
+};
+
+static long nbValid = 0;
+static long nbImages = 0;
+
+//
+// One input: validate, then both renders of every image, abort on a mismatch
+//
+static void checkInput(const uint8_t* input, size_t size)
+{
+  std::vector<uint8_t> data(input, input + size);       // exact size for ASan
+  mpx::Animation anim = mpx::Animation();
+
+  if (size == 0 || !mpx::validate(data.data(), size, anim))
+    return;
+  nbValid++;
+
+  std::vector<uint8_t> palCol(3 * mpx::PAL_SIZE, 0);
+  std::vector<Led> full(mpx::PAL_SIZE);
+  mpx::readPalette(data.data(), anim.hdr, palCol.data());
+  mpx::scalePalette(palCol.data(), mpx::PAL_SIZE, 3, full.data());
+  std::vector<Led> pal(full.begin(), full.begin() + anim.nbPal);  // only nbPal colors
+
+  std::vector<Led> checked(mpx::PIXELS, Led { 0, 0, 0 });
+  std::vector<Led> verified(mpx::PIXELS, Led { 0, 0, 0 });
+  for (int n = 0; n < anim.idx.nbImages; n++)
+  {
+    mpx::Image img;
+    mpx::indexedImage(data.data(), anim.idx, n, img);
+    mpx::renderImage(img, full.data(), checked.data());
+    mpx::renderVerified(img, pal.data(), verified.data());
+    if (memcmp(checked.data(), verified.data(), mpx::PIXELS * sizeof(Led)) != 0)
+    {
+      printf("!!! image %d of a %zu byte MPX: unchecked render differs !!!\n", n, size);
+      abort();
+    }
+    nbImages++;
+  }
+}
+
+#ifdef MPX_LIBFUZZER
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+  checkInput(data, size);
+  return 0;
+}
+
+#else
+
+static uint32_t seed = 1;
+
+static uint32_t rnd(uint32_t n)
+{
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 8) % n;
+}
+
+//
+// Extended variant of a classic MPX, the encoder picks delta, long or packed
+//
+static std::vector<uint8_t> extended(const std::vector<uint8_t>& mpxData, int tempoUs)
+{
+  static uint8_t maps[mpx::MAX_IMAGES][mpx::PIXELS];
+  std::vector<uint8_t> out;
+  mpx::Header hdr;
+  mpx::Image img;
+  int n = 0;
+
+  if (!mpx::readHeader(mpxData.data(), mpxData.size(), hdr))
+    return out;
+  out.assign(mpxData.begin(), mpxData.begin() + hdr.firstImage);
+  out.insert(out.begin(), mpx::EXT_MARK | mpx::FLAG_DELTA);
+  if (tempoUs != mpx::TEMPO_US)
+  {
+    out[0] |= mpx::FLAG_UNIT;
+    out.insert(out.begin() + 1, (uint8_t)(tempoUs / mpx::UNIT_STEP_US));
+  }
+  mpx::ImageIterator it(mpxData.data(), mpxData.size(), hdr);
+  while (it.next(img))
+  {
+    uint8_t buf[2 * mpx::PIXELS + 2 + mpx::EXT_IMAGE_HEADER];
+    mpx::decodeImage(img, maps[n]);
+    size_t nb = mpx::encodeExtImage(buf, sizeof(buf), maps[n], n > 0 ? maps[n - 1] : NULL, img.tempo);
+    out.insert(out.end(), buf, buf + nb);
+    n++;
+  }
+  return out;
+}
+
+//
+// A few random edits: byte values, header counts, insertions, deletions,
+// truncation
+//
+static std::vector<uint8_t> mutate(std::vector<uint8_t> d)
+{
+  int edits = 1 + rnd(4);
+  for (int e = 0; e < edits && !d.empty(); e++)
+  {
+    size_t pos = rnd((uint32_t)d.size());
+    switch (rnd(6))
+    {
+    case 0:  d[pos] ^= (uint8_t)(1 << rnd(8)); break;
+    case 1:  d[pos] = (uint8_t)rnd(256); break;
+    case 2:  d[pos] = (uint8_t)(rnd(2) ? 0x00 : 0xFF); break;
+    case 3:  d.insert(d.begin() + pos, (uint8_t)rnd(256)); break;
+    case 4:  d.erase(d.begin() + pos); break;
+    default: d.resize(pos); break;
+    }
+  }
+  return d;
+}
+
+int main(int argc, char** argv)
+{
+  std::vector<std::vector<uint8_t> > corpus;
+  long count = 200000;
+
+  printf("%s %s\n\n", argv[0], VERSION);
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+      count = atol(argv[++i]);
+    else if (strcmp(argv[i], "-seed") == 0 && i + 1 < argc)
+      seed = (uint32_t)atol(argv[++i]);
+    else if (argv[i][0] == '-')
+    {
+      printf("syntaxe: %s [-n count] [-seed n] [file.mpx ...]\n", argv[0]);
+      return 1;
+    }
+    else
+    {
+      FILE* fp = fopen(argv[i], "rb");
+      if (fp == NULL)
+      {
+        printf("!!! cannot read %s !!!\n", argv[i]);
+        return 1;
+      }
+      std::vector<uint8_t> d;
+      int c;
+      while ((c = fgetc(fp)) != EOF)
+        d.push_back((uint8_t)c);
+      fclose(fp);
+      corpus.push_back(d);
+    }
+  }
+
+  const char* motifs[] = { palette, donald, heart, mickey, perle, tjo };
+  const size_t sizes[] = { sizeof(palette), sizeof(donald), sizeof(heart),
+                           sizeof(mickey), sizeof(perle), sizeof(tjo) };
+  for (int m = 0; m < 6; m++)
+  {
+    corpus.push_back(std::vector<uint8_t>(motifs[m], motifs[m] + sizes[m]));
+    corpus.push_back(extended(corpus.back(), m % 2 ? 1000 : mpx::TEMPO_US));
+  }
+
+  long seeds = 0;
+  for (const std::vector<uint8_t>& d : corpus)
+  {
+    checkInput(d.data(), d.size());
+    seeds++;
+  }
+  if (nbValid != seeds)
+    printf("!!! %ld of the %ld corpus files do not validate !!!\n", seeds - nbValid, seeds);
+
+  for (long i = 0; i < count; i++)
+  {
+    std::vector<uint8_t> d = mutate(corpus[rnd((uint32_t)corpus.size())]);
+    checkInput(d.data(), d.size());
+  }
+  printf("%ld inputs, %ld valid, %ld images drawn by both renders, same LEDs\n",
+         seeds + count, nbValid, nbImages);
+  return 0;
+}
+
+#endif // MPX_LIBFUZZER
@@ -0,0 +1,492 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// mpxlive.h
+//
+// 1. Live frame streaming to MegaPix over UDP, shared by MegaPix.ino and
+//    livesend.cpp
+// --> one 32x16 frame per packet (palette indices or delta of them), or two
+//     packets of 8 lines in RGB; the palette of the indices is a packet too
+// --> each frame carries a sequence number and the sender time, the device
+//     plays it DELAY_MS after its earliest possible arrival (jitter buffer of
+//     DEPTH frames), frames older than the one shown are dropped
+// --> a delta frame lists the changed runs against the last full index frame
+//     (sequence ref), so a lost delta costs one frame only; it is dropped when
+//     that key frame is missing, the sender sends one every few frames
+// --> packets start with 0xFF 'L', neither an MPX file nor an mpxudp.h
+//     packet does
+// --> PacketRing hands the packets from the UDP task to loop(), one producer
+//     one consumer, no lock
+//
+//  +------------------+
+//  | 0xFF 'L'  type   |   PALETTE  count (0 = 256), count x R,G,B
+//  | seq        (16)  |   INDEX    PIXELS palette indices
+//  | ref        (16)  |   DELTA    runs: first (16), count (8), count indices
+//  | time ms    (32)  |   RGB      ref = part 0 or 1, 8 lines x 32 x R,G,B
+//  | payload          |
+//  +------------------+   numbers are little endian
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Live streaming, jitter buffer, counters
+// v1.1   16 Oct. 2026     PacketRing built on SpscRing
+//
+
+#ifndef MPXLIVE_H
+#define MPXLIVE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "mpx.h"
+#include "spscring.h"
+
+namespace mpxlive
+{
+
+const uint8_t MAGIC0 = 0xFF;
+const uint8_t MAGIC1 = 'L';
+
+const uint8_t PALETTE = 'P';
+const uint8_t INDEX   = 'I';
+const uint8_t DELTA   = 'D';
+const uint8_t RGB     = 'R';
+
+const int HEADER_SIZE = 11;
+const int PART_LINES  = mpx::HEIGHT / 2;                // RGB frame in two packets
+const int PART_PIXELS = PART_LINES * mpx::WIDTH;
+const int MAX_PACKET  = HEADER_SIZE + 1 + 256 * 3;      // PALETTE is the biggest
+const int DEPTH       = 6;                              // frames in the jitter buffer
+const uint32_t DELAY_MS   = 50;                         // playout delay
+const uint32_t TIMEOUT_MS = 2000;                       // stream over
+
+inline void put16(uint8_t* p, uint32_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+inline void put32(uint8_t* p, uint32_t v) { put16(p, v); put16(p + 2, v >> 16); }
+inline uint16_t get16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+inline uint32_t get32(const uint8_t* p) { return get16(p) | ((uint32_t)get16(p + 2) << 16); }
+
+//
+// Sequence order with wrap around, > 0 when a is after b
+//
+inline int seqDiff(uint16_t a, uint16_t b) { return (int16_t)(uint16_t)(a - b); }
+
+inline bool isLive(const uint8_t* pkt, size_t len)
+{
+  return len >= HEADER_SIZE && pkt[0] == MAGIC0 && pkt[1] == MAGIC1;
+}
+
+inline size_t makeHeader(uint8_t* pkt, uint8_t type, uint16_t seq, uint16_t ref, uint32_t time)
+{
+  pkt[0] = MAGIC0;
+  pkt[1] = MAGIC1;
+  pkt[2] = type;
+  put16(pkt + 3, seq);
+  put16(pkt + 5, ref);
+  put32(pkt + 7, time);
+  return HEADER_SIZE;
+}
+
+//
+// Delta runs of cur against the key frame prev in out, len receives the payload size (0
+// when nothing changed). False when it does not fit in cap, send an INDEX
+// frame then. Gaps shorter than a run header are sent as changed pixels.
+//
+inline bool encodeDelta(const uint8_t* prev, const uint8_t* cur, uint8_t* out, size_t cap,
+                        size_t& len)
+{
+  int p = 0;
+
+  len = 0;
+
+  while (p < mpx::PIXELS)
+  {
+    if (cur[p] == prev[p])
+    {
+      p++;
+      continue;
+    }
+    int first = p;
+    int last = p;                                       // last changed pixel
+    while (p < mpx::PIXELS && p - first < 255)
+    {
+      if (cur[p] != prev[p])
+        last = p;
+      else if (p - last > 3)
+        break;
+      p++;
+    }
+    int count = last - first + 1;
+    if (len + 3 + count > cap)
+      return false;
+    put16(out + len, (uint32_t)first);
+    out[len + 2] = (uint8_t)count;
+    memcpy(out + len + 3, cur + first, count);
+    len += 3 + count;
+    p = last + 1;
+  }
+  return true;
+}
+
+//
+// Device counters, times in ms
+//
+struct Stats
+{
+  uint32_t received;                  // frames complete
+  uint32_t shown;
+  uint32_t late;                      // after a newer one or past the delay
+  uint32_t lost;                      // sequence numbers never shown
+  uint32_t overflow;                  // pushed out of the jitter buffer
+  uint32_t deltaMiss;                 // delta against a frame not decoded
+  uint32_t invalid;                   // malformed packets
+  uint32_t latencyMax;                // arrival to display
+  uint32_t latencySum;
+  uint32_t jitter;                    // mean transit variation, RFC 3550
+  uint32_t fps;                       // frames shown last second
+};
+
+//
+// Jitter buffer and frame decoder, loop() side
+//
+class Player
+{
+public:
+  Player(uint32_t delayMs = DELAY_MS) : delay(delayMs) { reset(); }
+
+  void reset()
+  {
+    memset(&counters, 0, sizeof(counters));
+    memset(palette, 0, sizeof(palette));
+    for (int i = 0; i < DEPTH; i++)
+      slots[i].state = FREE;
+    started = false;
+    refValid = false;
+    clockSet = false;
+    lastTransitSet = false;
+    jitter16 = 0;
+    lastPacket = 0;
+    fpsStart = 0;
+    fpsShown = 0;
+  }
+
+  //
+  // Handle one live packet received at now
+  //
+  void onPacket(const uint8_t* pkt, size_t len, uint32_t now)
+  {
+    if (!isLive(pkt, len))
+      return;
+    uint8_t  type = pkt[2];
+    uint16_t seq  = get16(pkt + 3);
+    uint16_t ref  = get16(pkt + 5);
+    uint32_t time = get32(pkt + 7);
+    const uint8_t* data = pkt + HEADER_SIZE;
+    size_t size = len - HEADER_SIZE;
+
+    lastPacket = now;
+    if (type == PALETTE)
+    {
+      int count = size >= 1 ? (data[0] == 0 ? 256 : data[0]) : 0;
+      if (size < 1 + 3 * (size_t)count || count == 0)
+      {
+        counters.invalid++;
+        return;
+      }
+      memcpy(palette, data + 1, 3 * count);
+      return;
+    }
+    if ((type == INDEX && size != (size_t)mpx::PIXELS) ||
+        (type == RGB && (size != (size_t)PART_PIXELS * 3 || ref > 1)) ||
+        (type != INDEX && type != RGB && type != DELTA))
+    {
+      counters.invalid++;
+      return;
+    }
+    updateClock(time, now);
+    if (started && seqDiff(seq, shownSeq) <= 0)
+    {
+      counters.late++;                                  // a newer one is shown
+      return;
+    }
+
+    Slot* slot = slotFor(seq);
+    if (slot == NULL)
+      return;
+    switch (type)
+    {
+    case INDEX:
+      memcpy(refIndex, data, mpx::PIXELS);
+      refSeq = seq;
+      refValid = true;
+      toRgb(refIndex, slot->rgb);
+      slot->parts = 3;
+      break;
+
+    case DELTA:
+      if (!refValid || ref != refSeq || !applyDelta(data, size))
+      {
+        counters.deltaMiss++;
+        slot->state = FREE;
+        return;
+      }
+      toRgb(work, slot->rgb);
+      slot->parts = 3;
+      break;
+
+    case RGB:
+      memcpy(slot->rgb + ref * PART_PIXELS * 3, data, PART_PIXELS * 3);
+      slot->parts |= (uint8_t)(1 << ref);
+      break;
+    }
+    if (slot->parts == 3 && slot->state != READY)
+    {
+      slot->state = READY;
+      slot->arrival = now;
+      slot->playAt = time + transit + delay;
+      counters.received++;
+      if ((int32_t)(now - slot->playAt) > (int32_t)delay)
+      {
+        counters.late++;                                // past the jitter buffer
+        slot->state = FREE;
+      }
+    }
+  }
+
+  //
+  // Frame due at now, R,G,B line by line, NULL if none. The pixels stay
+  // valid until the next onPacket().
+  //
+  const uint8_t* frame(uint32_t now)
+  {
+    if (now - fpsStart >= 1000)
+    {
+      counters.fps = fpsShown;
+      fpsShown = 0;
+      fpsStart = now;
+    }
+
+    Slot* next = NULL;
+    for (int i = 0; i < DEPTH; i++)
+      if (slots[i].state == READY && (next == NULL || seqDiff(slots[i].seq, next->seq) < 0))
+        next = &slots[i];
+    if (next == NULL || (int32_t)(now - next->playAt) < 0)
+      return NULL;
+
+    for (int i = 0; i < DEPTH; i++)                     // incomplete older frames
+      if (slots[i].state == PARTIAL && seqDiff(slots[i].seq, next->seq) < 0)
+        slots[i].state = FREE;
+    if (started)
+      counters.lost += seqDiff(next->seq, shownSeq) - 1;
+    started = true;
+    shownSeq = next->seq;
+    next->state = FREE;
+
+    uint32_t latency = now - next->arrival;
+    counters.latencySum += latency;
+    if (latency > counters.latencyMax)
+      counters.latencyMax = latency;
+    counters.shown++;
+    fpsShown++;
+    return next->rgb;
+  }
+
+  //
+  // A live packet came in the last TIMEOUT_MS
+  //
+  bool active(uint32_t now) const { return lastPacket != 0 && now - lastPacket < TIMEOUT_MS; }
+
+  const Stats& stats()
+  {
+    counters.jitter = jitter16 >> 4;
+    return counters;
+  }
+
+private:
+  enum { FREE, PARTIAL, READY };
+
+  struct Slot
+  {
+    uint8_t  state;
+    uint8_t  parts;                                     // bit per RGB part
+    uint16_t seq;
+    uint32_t arrival;
+    uint32_t playAt;
+    uint8_t  rgb[mpx::PIXELS * 3];
+  };
+
+  //
+  // Smallest transit time seen sets the play time, the variation the jitter
+  //
+  void updateClock(uint32_t time, uint32_t now)
+  {
+    uint32_t t = now - time;
+    if (!clockSet || (int32_t)(t - transit) < 0)
+    {
+      transit = t;
+      clockSet = true;
+    }
+    int32_t d = (int32_t)(t - lastTransit);
+    if (d < 0)
+      d = -d;
+    if (lastTransitSet)
+      jitter16 += d - (int32_t)((jitter16 + 8) >> 4);
+    lastTransit = t;
+    lastTransitSet = true;
+  }
+
+  //
+  // Slot of frame seq, a free one or the oldest one pushed out
+  //
+  Slot* slotFor(uint16_t seq)
+  {
+    Slot* oldest = NULL;
+    for (int i = 0; i < DEPTH; i++)
+    {
+      if (slots[i].state == FREE)
+        continue;
+      if (slots[i].seq == seq)
+        return slots[i].state == READY ? NULL : &slots[i];   // duplicate or part
+      if (oldest == NULL || seqDiff(slots[i].seq, oldest->seq) < 0)
+        oldest = &slots[i];
+    }
+    Slot* slot = NULL;
+    for (int i = 0; i < DEPTH && slot == NULL; i++)
+      if (slots[i].state == FREE)
+        slot = &slots[i];
+    if (slot == NULL)
+    {
+      if (seqDiff(seq, oldest->seq) < 0)
+      {
+        counters.overflow++;                            // older than all of them
+        return NULL;
+      }
+      counters.overflow++;
+      slot = oldest;
+    }
+    slot->state = PARTIAL;
+    slot->parts = 0;
+    slot->seq = seq;
+    return slot;
+  }
+
+  bool applyDelta(const uint8_t* data, size_t size)
+  {
+    size_t pos = 0;
+
+    memcpy(work, refIndex, mpx::PIXELS);
+    while (pos + 3 <= size)
+    {
+      int first = get16(data + pos);
+      int count = data[pos + 2];
+      if (first + count > mpx::PIXELS || pos + 3 + count > size)
+        return false;
+      memcpy(work + first, data + pos + 3, count);
+      pos += 3 + count;
+    }
+    return pos == size;
+  }
+
+  void toRgb(const uint8_t* map, uint8_t* rgb) const
+  {
+    for (int p = 0; p < mpx::PIXELS; p++)
+    {
+      const uint8_t* c = palette + 3 * map[p];
+      rgb[3*p]     = c[0];
+      rgb[3*p + 1] = c[1];
+      rgb[3*p + 2] = c[2];
+    }
+  }
+
+  uint32_t delay;
+  Stats    counters;
+  Slot     slots[DEPTH];
+  uint8_t  palette[256 * 3];
+  uint8_t  refIndex[mpx::PIXELS];                       // last key frame
+  uint8_t  work[mpx::PIXELS];                           // key frame + delta
+  uint16_t refSeq;
+  bool     refValid;
+  bool     started;                                     // a frame has been shown
+  uint16_t shownSeq;
+  bool     clockSet;
+  uint32_t transit;                                     // smallest now - time
+  bool     lastTransitSet;
+  uint32_t lastTransit;
+  int32_t  jitter16;                                    // jitter x 16
+  uint32_t lastPacket;
+  uint32_t fpsStart;
+  uint32_t fpsShown;
+};
+
+//
+// Packets from the UDP task to loop(), one producer, one consumer
+//
+template <int N, int SIZE>
+class PacketRing
+{
+public:
+  //
+  // Producer, false when the ring is full or the packet too big
+  //
+  bool push(const uint8_t* pkt, size_t len)
+  {
+    if (len > (size_t)SIZE)
+    {
+      ring.drop();
+      return false;
+    }
+    Packet* slot = ring.claim();
+    if (slot == NULL)
+      return false;
+    memcpy(slot->data, pkt, len);                       // only the used bytes
+    slot->len = len;
+    ring.publish();
+    return true;
+  }
+
+  //
+  // Consumer, copies the oldest packet to pkt, false when empty
+  //
+  bool pop(uint8_t* pkt, size_t& len)
+  {
+    const Packet* slot = ring.peek();
+    if (slot == NULL)
+      return false;
+    len = slot->len;
+    memcpy(pkt, slot->data, len);
+    ring.release();
+    return true;
+  }
+
+  uint32_t rejected() const { return ring.rejected(); }
+
+private:
+  struct Packet
+  {
+    size_t  len;
+    uint8_t data[SIZE];
+  };
+  SpscRing<Packet, N> ring;
+};
+
+} // namespace mpxlive
+
+#endif // MPXLIVE_H
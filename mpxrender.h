@@ -0,0 +1,206 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// mpxrender.h
+//
+// 1. Render of decoded MPX runs into the MegaPix LED array
+// --> the palette is scaled once per palette or intensity change
+// --> each RLE run becomes one span fill per line, the serpentine order comes
+//     from the ledmap.h table, no division and no branch per pixel
+// --> Pixel is CRGB in the firmware, any 3 byte R,G,B struct on the host
+// --> renderRgb() draws the R,G,B frames of the live stream (mpxlive.h)
+// --> packed images skip the runs, one table lookup and one store per pixel
+// --> renderVerified() draws the images of a validated animation (mpx.h
+//     validate()) without bound checks
+// --> MPX_STRIPS, defined before the include, drives the matrix as that
+//     many parallel strips (ledmap.h), 1 by default
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Pre-scaled palette and span render
+// v1.1   15 Oct. 2026     R,G,B frames
+// v1.2   15 Oct. 2026     Packed images
+// v1.3   15 Oct. 2026     Unchecked render of validated animations
+// v1.4   15 Oct. 2026     LedMap is a ledmap::Layout of MPX_STRIPS parallel strips
+//
+
+#ifndef MPXRENDER_H
+#define MPXRENDER_H
+
+#include "mpx.h"
+#include "ledmap.h"
+
+namespace mpx
+{
+
+#ifndef MPX_STRIPS
+#define MPX_STRIPS 1                     // parallel LED strips, HEIGHT / MPX_STRIPS lines each
+#endif
+
+typedef ledmap::Layout<WIDTH, HEIGHT, ledmap::SERPENTINE, 1, MPX_STRIPS> LedMap;
+
+//
+// MegaPix intensity rule: 0 = off, 1 = 1/5, 2 = 1/3, 3 = full, other = 1/2
+//
+inline uint8_t scaleLevel(uint8_t value, int intensity)
+{
+  switch (intensity)
+  {
+  case 0:  return 0;
+  case 1:  return (uint8_t)(value / 5);
+  case 2:  return (uint8_t)(value / 3);
+  case 3:  return value;
+  default: return (uint8_t)(value / 2);
+  }
+}
+
+//
+// Scale the palCol palette (3 bytes per color, B&W first) for intensity
+//
+template <class Pixel>
+inline void scalePalette(const uint8_t* palCol, int nbColors, int intensity, Pixel* scaled)
+{
+  for (int i = 0; i < nbColors; i++)
+  {
+    scaled[i].r = scaleLevel(palCol[3*i], intensity);
+    scaled[i].g = scaleLevel(palCol[3*i + 1], intensity);
+    scaled[i].b = scaleLevel(palCol[3*i + 2], intensity);
+  }
+}
+
+//
+// decodeRuns() sink filling leds[] with the scaled palette colors
+//
+template <class Pixel>
+struct SpanSink
+{
+  Pixel*       leds;
+  const Pixel* palette;                  // scaled palette
+
+  void operator()(int first, int count, int idcolor)
+  {
+    const Pixel color = palette[idcolor];
+
+    if (count == 1)                      // most runs of a drawing
+    {
+      leds[LedMap::led[first]] = color;
+      return;
+    }
+    while (count > 0)                    // one span per line
+    {
+      int n = WIDTH - first % WIDTH;
+      if (n > count)
+        n = count;
+      int a = LedMap::led[first];
+      int b = LedMap::led[first + n - 1];
+      Pixel* span = leds + (a < b ? a : b);
+      Pixel* end = span + n;
+      do                                 // short spans, keep the loop plain
+        *span++ = color;
+      while (span < end);
+      first += n;
+      count -= n;
+    }
+  }
+};
+
+//
+// Packed image straight into leds[], pixels in LedMap order
+//
+template <class Pixel>
+inline int renderPacked(const Image& img, const Pixel* palette, Pixel* leds)
+{
+  uint8_t local[MAX_LOCAL];
+  Pixel colors[MAX_LOCAL];
+  const uint8_t* packed;
+  int bits;
+
+  if (!readPacked(img, bits, local, packed))
+    return 0;
+  for (int i = 0; i < MAX_LOCAL; i++)
+    colors[i] = palette[local[i]];
+  const uint16_t* led = LedMap::led;
+  const uint8_t* end = packed + PIXELS * bits / 8;
+  switch (bits)
+  {
+  case 4:
+    for (; packed < end; packed++, led += 2)
+    {
+      leds[led[0]] = colors[*packed & 0x0F];
+      leds[led[1]] = colors[*packed >> 4];
+    }
+    break;
+  default:                               // 1 or 2 bits
+    for (int mask = (1 << bits) - 1; packed < end; packed++)
+      for (unsigned k = 0, v = *packed; k < 8; k += bits, v >>= bits)
+        leds[*led++] = colors[v & mask];
+    break;
+  }
+  return PIXELS;
+}
+
+template <class Pixel>
+inline int renderImage(const Image& img, const Pixel* palette, Pixel* leds)
+{
+  if (img.coding == CODING_PACKED)
+    return renderPacked(img, palette, leds);
+  SpanSink<Pixel> sink = { leds, palette };
+  return decodeRuns(img, sink);
+}
+
+//
+// Image of a validated animation, palette holds at least its nbPal colors
+//
+template <class Pixel>
+inline void renderVerified(const Image& img, const Pixel* palette, Pixel* leds)
+{
+  if (img.coding == CODING_PACKED)
+  {
+    renderPacked(img, palette, leds);
+    return;
+  }
+  SpanSink<Pixel> sink = { leds, palette };
+  decodeVerified(img, sink);
+}
+
+//
+// PIXELS R,G,B triplets line by line into leds[], scaled for intensity
+//
+template <class Pixel>
+inline void renderRgb(const uint8_t* rgb, int intensity, Pixel* leds)
+{
+  uint8_t level[256];
+
+  for (int v = 0; v < 256; v++)
+    level[v] = scaleLevel((uint8_t)v, intensity);
+  for (int p = 0; p < PIXELS; p++, rgb += 3)
+  {
+    Pixel& led = leds[LedMap::led[p]];
+    led.r = level[rgb[0]];
+    led.g = level[rgb[1]];
+    led.b = level[rgb[2]];
+  }
+}
+
+} // namespace mpx
+
+#endif // MPXRENDER_H
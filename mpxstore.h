@@ -0,0 +1,574 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// mpxstore.h
+//
+// 1. Flash store of MPX animations, played in place from memory-mapped flash
+// --> a log of records in a raw data partition: each record starts on a
+//     sector, header then the file, the next one goes after it and the log
+//     wraps to sector 0 at the end, erasing the oldest records on its way
+// --> a record is written once: sectors erased, file programmed (chunks in
+//     any order, see mpxudp::Storage), header programmed last with the CRC32
+//     of the file, so a power cut leaves no half record; removing a record
+//     clears its live word, no erase
+// --> mount() scans the headers only, data() points into the mapped flash:
+//     no copy to RAM, animations up to the partition size
+// --> begin() never erases the records given as keep (the one being played,
+//     the newest one), the loop() task may read them while the UDP task writes
+// --> Flash is PartitionFlash on the ESP32 (and the host emulator), FileFlash
+//     on Linux: a file, or a temporary one, mapped read-only, NOR semantics
+//     (erase to 0xFF, programming clears bits) and power cut simulation
+//
+//  record, sector aligned        numbers are little endian
+//  +------------------+
+//  | 'M' 'P' 'X' 'S'  |
+//  | seq        (32)  |  1, 2... newest is the highest
+//  | length     (32)  |  of the file
+//  | crc32      (32)  |  of the file
+//  | hcrc       (32)  |  of the 16 bytes above
+//  | live       (32)  |  0xFFFFFFFF, 0 = removed
+//  | 0xFF x 8         |
+//  | file             |
+//  +------------------+
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Record log, zero-copy playback, file-backed flash
+//
+
+#ifndef MPXSTORE_H
+#define MPXSTORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+#include "mpxudp.h"
+
+#if defined(ESP32)
+#include <esp_partition.h>
+#include <esp_idf_version.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mpxstore
+{
+
+const uint32_t SECTOR_SIZE = 4096;            // erase unit
+const uint32_t HEADER_SIZE = 32;
+const uint32_t NONE        = 0xFFFFFFFF;      // no record
+const int      MAX_RECORDS = 64;              // live records, the oldest go beyond
+
+const uint8_t MAGIC[4] = { 'M', 'P', 'X', 'S' };
+
+struct Record
+{
+  uint32_t offset;                            // of the header in the partition
+  uint32_t length;                            // of the file
+  uint32_t seq;
+  uint32_t crc;
+};
+
+inline uint32_t sectors(uint32_t length)
+{
+  return (HEADER_SIZE + length + SECTOR_SIZE - 1) / SECTOR_SIZE;
+}
+
+//
+// Records of a Flash: uint32_t size(), const uint8_t* map(),
+// bool erase(offset, len) of whole sectors, bool write(offset, data, len).
+// One writer task; recordAt() and data() only read the mapped headers and
+// files and may be called from any task.
+//
+template <class Flash>
+class Store
+{
+public:
+  explicit Store(Flash& flash) : flash(flash)
+  {
+    nb = 0;
+    head = 0;
+    nextSeq = 1;
+    pendOffset = NONE;
+    pendSize = 0;
+  }
+
+  //
+  // Read the headers, the log goes on after the newest record
+  //
+  bool mount()
+  {
+    const uint32_t size = flash.size();
+    Record rec;
+    bool live;
+
+    nb = 0;
+    pendOffset = NONE;
+    if (!flash.map() || size < SECTOR_SIZE)
+      return false;
+    for (uint32_t off = 0; off < size; )
+    {
+      if (!readHeader(off, rec, live) || !live)
+      {                                       // a removed record may hide newer ones
+        off += SECTOR_SIZE;
+        continue;
+      }
+      if (nb == MAX_RECORDS)                  // keep the newest
+      {
+        if (rec.seq < table[0].seq)
+          kill(rec);
+        else
+        {
+          kill(table[0]);
+          drop(0);
+        }
+      }
+      if (nb < MAX_RECORDS)
+        insert(rec);
+      off += sectors(rec.length) * SECTOR_SIZE;
+    }
+
+    head = 0;
+    nextSeq = 1;
+    if (nb > 0)
+    {
+      const Record& last = table[nb - 1];
+      head = last.offset + sectors(last.length) * SECTOR_SIZE;
+      nextSeq = last.seq + 1;
+    }
+    if (head >= size)
+      head = 0;
+    return true;
+  }
+
+  int count() const { return nb; }
+  const Record& record(int i) const { return table[i]; }  // 0 = oldest
+
+  //
+  // Header at offset, any task
+  //
+  bool recordAt(uint32_t offset, Record& rec) const
+  {
+    bool live;
+    return offset != NONE && readHeader(offset, rec, live) && live;
+  }
+
+  const uint8_t* data(const Record& rec) const { return flash.map() + rec.offset + HEADER_SIZE; }
+
+  //
+  // CRC of the file, the header alone is checked by mount()
+  //
+  bool check(const Record& rec) const
+  {
+    return mpxudp::crc32(data(rec), rec.length) == rec.crc;
+  }
+
+  //
+  // Biggest file of the partition
+  //
+  uint32_t capacity() const
+  {
+    uint32_t size = flash.size() / SECTOR_SIZE * SECTOR_SIZE;
+    return size > HEADER_SIZE ? size - HEADER_SIZE : 0;
+  }
+
+  //
+  // Where begin() puts a file of size bytes
+  //
+  uint32_t nextOffset(uint32_t size) const
+  {
+    return head + sectors(size) * SECTOR_SIZE <= flash.size() ? head : 0;
+  }
+
+  //
+  // Erase room for a file of size bytes after the newest record, or at sector
+  // 0, the records in the way are removed first. False when the records keepA
+  // or keepB (offsets) are in the way, or size does not fit the partition.
+  //
+  bool begin(uint32_t size, uint32_t keepA = NONE, uint32_t keepB = NONE)
+  {
+    pendOffset = NONE;
+    if (size == 0 || size > capacity())
+      return false;
+    uint32_t len = sectors(size) * SECTOR_SIZE;
+    uint32_t off = nextOffset(size);
+
+    const uint32_t keep[2] = { keepA, keepB };
+    for (int k = 0; k < 2; k++)               // removed or not, they are read
+    {
+      Record rec;
+      bool live;
+      if (keep[k] != NONE && readHeader(keep[k], rec, live) && overlaps(rec, off, len))
+        return false;
+    }
+    for (int i = 0; i < nb; )
+      if (overlaps(table[i], off, len) || (i == 0 && nb == MAX_RECORDS))
+      {                                       // header first: a cut erase is no half record
+        kill(table[i]);
+        drop(i);
+      }
+      else
+        i++;
+    if (!flash.erase(off, len))
+      return false;
+    pendOffset = off;
+    pendSize = size;
+    return true;
+  }
+
+  //
+  // Program len bytes of the file at pos, once
+  //
+  bool write(uint32_t pos, const uint8_t* src, uint32_t len)
+  {
+    if (pendOffset == NONE || pos > pendSize || len > pendSize - pos)
+      return false;
+    return flash.write(pendOffset + HEADER_SIZE + pos, src, len);
+  }
+
+  //
+  // Mapped view of the file being written, NULL when none
+  //
+  const uint8_t* pending() const
+  {
+    return pendOffset == NONE ? NULL : flash.map() + pendOffset + HEADER_SIZE;
+  }
+
+  //
+  // Program the header, the record becomes the newest. False when the flash
+  // did not take the file or the header.
+  //
+  bool commit(Record& rec)
+  {
+    if (pendOffset == NONE)
+      return false;
+    uint8_t hdr[24];
+    memcpy(hdr, MAGIC, 4);
+    mpxudp::put32(hdr + 4, nextSeq);
+    mpxudp::put32(hdr + 8, pendSize);
+    mpxudp::put32(hdr + 12, mpxudp::crc32(pending(), pendSize));
+    mpxudp::put32(hdr + 16, mpxudp::crc32(hdr, 16));
+    mpxudp::put32(hdr + 20, NONE);
+    uint32_t off = pendOffset;
+    pendOffset = NONE;
+    bool live;
+    if (!flash.write(off, hdr, 20) || !readHeader(off, rec, live) || !live)
+      return false;
+    insert(rec);
+    nextSeq++;
+    head = off + sectors(rec.length) * SECTOR_SIZE;
+    if (head >= flash.size())
+      head = 0;
+    return true;
+  }
+
+  //
+  // File from RAM
+  //
+  bool add(const uint8_t* src, uint32_t size, Record& rec,
+           uint32_t keepA = NONE, uint32_t keepB = NONE)
+  {
+    return begin(size, keepA, keepB) && write(0, src, size) && commit(rec);
+  }
+
+  bool remove(int i)
+  {
+    if (i < 0 || i >= nb)
+      return false;
+    kill(table[i]);
+    drop(i);
+    return true;
+  }
+
+private:
+  bool readHeader(uint32_t off, Record& rec, bool& live) const
+  {
+    const uint8_t* p = flash.map() + off;
+
+    if (off % SECTOR_SIZE || off > flash.size() - HEADER_SIZE || memcmp(p, MAGIC, 4) ||
+        mpxudp::get32(p + 16) != mpxudp::crc32(p, 16))
+      return false;
+    rec.offset = off;
+    rec.seq    = mpxudp::get32(p + 4);
+    rec.length = mpxudp::get32(p + 8);
+    rec.crc    = mpxudp::get32(p + 12);
+    live = mpxudp::get32(p + 20) == NONE;
+    return rec.length > 0 && rec.length <= flash.size() - off - HEADER_SIZE;
+  }
+
+  static bool overlaps(const Record& rec, uint32_t off, uint32_t len)
+  {
+    return rec.offset < off + len && off < rec.offset + sectors(rec.length) * SECTOR_SIZE;
+  }
+
+  void kill(const Record& rec)
+  {
+    static const uint8_t zero[4] = { 0, 0, 0, 0 };
+    flash.write(rec.offset + 20, zero, 4);
+  }
+
+  void insert(const Record& rec)              // by seq, oldest first
+  {
+    int i = nb++;
+    for (; i > 0 && table[i - 1].seq > rec.seq; i--)
+      table[i] = table[i - 1];
+    table[i] = rec;
+  }
+
+  void drop(int i)
+  {
+    for (nb--; i < nb; i++)
+      table[i] = table[i + 1];
+  }
+
+  Flash&   flash;
+  Record   table[MAX_RECORDS];                // live records, oldest first
+  int      nb;
+  uint32_t head;                              // next record
+  uint32_t nextSeq;
+  uint32_t pendOffset;                        // record being written, NONE = none
+  uint32_t pendSize;
+};
+
+//
+// mpxudp::Receiver storage: uploads written in place in the store, the records
+// keepA and keepB (offsets, set by other tasks) are never erased
+//
+template <class S>
+class Upload : public mpxudp::Storage
+{
+public:
+  Upload(S& store, const std::atomic<uint32_t>& keepA, const std::atomic<uint32_t>& keepB)
+    : store(store), keepA(keepA), keepB(keepB) {}
+
+  const uint8_t* open(size_t total)
+  {
+    if (total > store.capacity() || !store.begin((uint32_t)total, keepA.load(), keepB.load()))
+      return NULL;
+    return store.pending();
+  }
+
+  bool write(size_t pos, const uint8_t* data, size_t len)
+  {
+    return store.write((uint32_t)pos, data, (uint32_t)len);
+  }
+
+private:
+  S& store;
+  const std::atomic<uint32_t>& keepA;
+  const std::atomic<uint32_t>& keepB;
+};
+
+#if defined(ESP32)
+
+//
+// Data partition found by label, or the SPIFFS partition of the default
+// tables, mapped in the data address space
+//
+class PartitionFlash
+{
+public:
+  PartitionFlash() : part(NULL), view(NULL) {}
+
+  bool begin(const char* label)
+  {
+    const void* p;
+
+    part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (!part)
+      part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, NULL);
+    if (!part)
+      return false;
+#if ESP_IDF_VERSION_MAJOR >= 5
+    if (esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &p, &handle) != ESP_OK)
+#else
+    if (esp_partition_mmap(part, 0, part->size, SPI_FLASH_MMAP_DATA, &p, &handle) != ESP_OK)
+#endif
+      return false;
+    view = (const uint8_t*)p;
+    return true;
+  }
+
+  uint32_t size() const { return part ? part->size : 0; }
+  const uint8_t* map() const { return view; }
+
+  bool erase(uint32_t offset, uint32_t len)
+  {
+    return esp_partition_erase_range(part, offset, len) == ESP_OK;
+  }
+
+  bool write(uint32_t offset, const void* data, uint32_t len)
+  {
+    return esp_partition_write(part, offset, data, len) == ESP_OK;
+  }
+
+private:
+  const esp_partition_t* part;
+  const uint8_t* view;
+#if ESP_IDF_VERSION_MAJOR >= 5
+  esp_partition_mmap_handle_t handle;
+#else
+  spi_flash_mmap_handle_t handle;
+#endif
+};
+
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+
+//
+// Flash in a file, or in a temporary one when path is NULL. Reads go through
+// a read-only mapping: a write through data() faults as on the ESP32.
+//
+class FileFlash
+{
+public:
+  FileFlash() : fd(-1), bytes(0), view(NULL), rw(NULL), budget(-1), cutKeep(0) {}
+  ~FileFlash() { end(); }
+
+  //
+  // Open path, a missing or shorter file is extended with erased sectors
+  //
+  bool begin(const char* path, uint32_t size)
+  {
+    end();
+    size = size / SECTOR_SIZE * SECTOR_SIZE;
+    if (path)
+      fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    else
+    {
+      char tmp[] = "/tmp/mpxstoreXXXXXX";
+      if ((fd = mkstemp(tmp)) >= 0)
+        unlink(tmp);
+    }
+    struct stat st;
+    if (fd < 0 || size == 0 || fstat(fd, &st) != 0)
+      return fail();
+    if ((uint64_t)st.st_size < size)
+    {
+      if (ftruncate(fd, size) != 0)
+        return fail();
+      uint8_t erased[SECTOR_SIZE];
+      memset(erased, 0xFF, sizeof(erased));
+      for (uint32_t off = (uint32_t)st.st_size; off < size; )
+      {
+        uint32_t n = (uint32_t)(SECTOR_SIZE - off % SECTOR_SIZE);
+        if (pwrite(fd, erased, n, off) != (ssize_t)n)
+          return fail();
+        off += n;
+      }
+    }
+    void* r = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    void* w = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    view = r == MAP_FAILED ? NULL : (const uint8_t*)r;
+    rw = w == MAP_FAILED ? NULL : (uint8_t*)w;
+    bytes = size;
+    if (!view || !rw)
+      return fail();
+    return true;
+  }
+
+  void end()
+  {
+    if (view)
+      munmap((void*)view, bytes);
+    if (rw)
+      munmap(rw, bytes);
+    if (fd >= 0)
+      close(fd);
+    fd = -1;
+    view = NULL;
+    rw = NULL;
+    bytes = 0;
+  }
+
+  uint32_t size() const { return bytes; }
+  const uint8_t* map() const { return view; }
+
+  bool erase(uint32_t offset, uint32_t len)
+  {
+    if (!rw || offset % SECTOR_SIZE || len % SECTOR_SIZE || offset > bytes || len > bytes - offset)
+      return false;
+    uint32_t n = power(len);
+    memset(rw + offset, 0xFF, n);
+    return n == len;
+  }
+
+  bool write(uint32_t offset, const void* data, uint32_t len)
+  {
+    if (!rw || offset > bytes || len > bytes - offset)
+      return false;
+    const uint8_t* src = (const uint8_t*)data;
+    uint32_t n = power(len);
+    for (uint32_t i = 0; i < n; i++)          // NOR: bits go from 1 to 0 only
+      rw[offset + i] &= src[i];
+    return n == len;
+  }
+
+  //
+  // Power cut: ops more erase or write operations go through, the next one
+  // stops after keep % (len + 1) bytes, the following ones do nothing.
+  // ops < 0 powers the flash again.
+  //
+  void cutAfter(int ops, uint32_t keep = 0)
+  {
+    budget = ops;
+    cutKeep = keep;
+  }
+
+private:
+  uint32_t power(uint32_t len)                // bytes this operation may change
+  {
+    if (budget < 0)
+      return len;
+    if (budget-- > 0)
+      return len;
+    budget = 0;
+    uint32_t n = cutKeep % (len + 1);
+    cutKeep = 0;
+    return n;
+  }
+
+  bool fail()
+  {
+    end();
+    return false;
+  }
+
+  int      fd;
+  uint32_t bytes;
+  const uint8_t* view;                        // read-only mapping
+  uint8_t* rw;                                // programming mapping
+  int      budget;                            // operations before the cut, -1 = powered
+  uint32_t cutKeep;
+};
+
+#endif
+
+} // namespace mpxstore
+
+#endif // MPXSTORE_H
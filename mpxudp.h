@@ -0,0 +1,424 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// mpxudp.h
+//
+// 1. Chunked MPX upload over UDP, shared by MegaPix.ino and SendMotifUDP.cpp
+// --> the file is cut in chunks of CHUNK_SIZE bytes, each DATA packet carries
+//     the session id, chunk index, chunk count, total length and file CRC32
+// --> after a window of chunks the sender asks with a QUERY, the device
+//     answers ACK (complete, CRC OK) or NACK with the bitmap of the received
+//     chunks, the sender sends again only the missing ones
+// --> packets start with 0xFF, an MPX file never does (max 223 colors) so the
+//     device still accepts the former raw packets
+// --> Receiver works in a caller-supplied buffer, no heap, or writes the
+//     chunks through a Storage (flash store, mpxstore.h) and reads them back
+//     from its memory view for the CRC
+//
+//  DATA, QUERY (no payload)       ACK, NACK
+//  +------------------+           +------------------+
+//  | 0xFF 'U'  type   |           | 0xFF 'U'  type   |
+//  | session    (16)  |           | session    (16)  |
+//  | index      (16)  |           | status     (8)   |
+//  | count      (16)  |           | base       (16)  |  first missing chunk
+//  | total      (32)  |           | bitmap  32 bytes |  chunks base..base+255
+//  | crc32      (32)  |           +------------------+
+//  | payload          |
+//  +------------------+           numbers are little endian
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Chunked upload, selective retransmit
+// v1.1   15 Oct. 2026     Receiver::setBuffer()
+// v1.2   15 Oct. 2026     Receiver::setStorage(), uploads bigger than RAM
+//
+
+#ifndef MPXUDP_H
+#define MPXUDP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+namespace mpxudp
+{
+
+const uint8_t MAGIC0 = 0xFF;
+const uint8_t MAGIC1 = 'U';
+
+const uint8_t DATA  = 'D';
+const uint8_t QUERY = 'Q';
+const uint8_t ACK   = 'A';
+const uint8_t NACK  = 'N';
+
+const int CHUNK_SIZE   = 1400;      // payload, the packet stays under the 1470 MTU
+const int HEADER_SIZE  = 17;        // DATA and QUERY header
+const int BITMAP_BYTES = 32;        // 256 chunks per NACK
+const int REPLY_SIZE   = 8 + BITMAP_BYTES;
+const int PACKET_SIZE  = HEADER_SIZE + CHUNK_SIZE;
+const int MAX_CHUNKS   = 1024;      // 1.4 MB
+
+enum Status
+{
+  OK        = 0,                    // upload complete
+  PENDING   = 1,                    // chunks missing
+  CRC_ERROR = 2,                    // all chunks there, CRC mismatch, start again
+  TOO_BIG   = 3                     // does not fit the device buffer
+};
+
+//
+// CRC32 (IEEE 802.3), nibble table
+//
+inline uint32_t crc32(const uint8_t* data, size_t len, uint32_t crc = 0)
+{
+  static const uint32_t table[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4,
+    0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+  };
+
+  crc = ~crc;
+  for (size_t i = 0; i < len; i++)
+  {
+    crc = table[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+    crc = table[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+  }
+  return ~crc;
+}
+
+inline void put16(uint8_t* p, uint32_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+inline void put32(uint8_t* p, uint32_t v) { put16(p, v); put16(p + 2, v >> 16); }
+inline uint16_t get16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+inline uint32_t get32(const uint8_t* p) { return get16(p) | ((uint32_t)get16(p + 2) << 16); }
+
+//
+// Packet of this protocol, or a former raw MPX packet
+//
+inline bool isFramed(const uint8_t* pkt, size_t len)
+{
+  return len >= 3 && pkt[0] == MAGIC0 && pkt[1] == MAGIC1;
+}
+
+inline int chunkCount(size_t total)
+{
+  return (int)((total + CHUNK_SIZE - 1) / CHUNK_SIZE);
+}
+
+//
+// DATA or QUERY packet, returns its size
+//
+inline size_t makePacket(uint8_t* pkt, uint8_t type, uint16_t session, int index,
+                         const uint8_t* data, size_t total, uint32_t crc)
+{
+  size_t len = 0;
+
+  pkt[0] = MAGIC0;
+  pkt[1] = MAGIC1;
+  pkt[2] = type;
+  put16(pkt + 3, session);
+  put16(pkt + 5, (uint32_t)index);
+  put16(pkt + 7, (uint32_t)chunkCount(total));
+  put32(pkt + 9, (uint32_t)total);
+  put32(pkt + 13, crc);
+  if (type == DATA)
+  {
+    size_t pos = (size_t)index * CHUNK_SIZE;
+    len = total - pos < (size_t)CHUNK_SIZE ? total - pos : (size_t)CHUNK_SIZE;
+    memcpy(pkt + HEADER_SIZE, data + pos, len);
+  }
+  return HEADER_SIZE + len;
+}
+
+//
+// Destination of an upload other than the RAM buffer of the Receiver.
+// open() prepares total bytes (erased flash) and returns their read-only view,
+// NULL when they do not fit; each byte is written once, chunks in any order.
+//
+class Storage
+{
+public:
+  virtual const uint8_t* open(size_t total) = 0;
+  virtual bool write(size_t pos, const uint8_t* data, size_t len) = 0;
+
+protected:
+  ~Storage() {}
+};
+
+//
+// Device side: rebuilds the file in buffer, answers QUERY packets
+//
+class Receiver
+{
+public:
+  Receiver(uint8_t* buffer, size_t capacity) : buffer(buffer), capacity(capacity)
+  {
+    storage = NULL;
+    target = NULL;
+    view = buffer;
+    session = 0;
+    active = false;
+    status = PENDING;
+    complete = false;
+  }
+
+  //
+  // Handle one framed packet, returns the size of the reply to send, 0 if none
+  //
+  size_t onPacket(const uint8_t* pkt, size_t len, uint8_t* reply)
+  {
+    if (len < HEADER_SIZE || (pkt[2] != DATA && pkt[2] != QUERY))
+      return 0;
+
+    uint16_t id    = get16(pkt + 3);
+    int      index = get16(pkt + 5);
+    int      count = get16(pkt + 7);
+    uint32_t size  = get32(pkt + 9);
+    uint32_t crc   = get32(pkt + 13);
+
+    if (!active || id != session)              // new upload
+    {
+      if (size == 0 || count != chunkCount(size))
+        return 0;
+      start(id, count, size, crc);
+    }
+    else if (size != total || crc != fileCrc)
+      return 0;                                // not this upload
+    if (status == TOO_BIG || status == OK)
+      return makeReply(reply);                 // nothing more to receive
+
+    if (pkt[2] == QUERY)
+      return makeReply(reply);
+
+    size_t pos = (size_t)index * CHUNK_SIZE;
+    size_t chunk = total - pos < (size_t)CHUNK_SIZE ? total - pos : (size_t)CHUNK_SIZE;
+    if (index >= nbChunks || len != HEADER_SIZE + chunk)
+      return 0;
+    if (!(received[index / 8] & (1 << (index % 8))))
+    {
+      if (!target)
+        memcpy(buffer + pos, pkt + HEADER_SIZE, chunk);
+      else if (!target->write(pos, pkt + HEADER_SIZE, chunk))
+        return 0;                              // the sender will send it again
+      received[index / 8] |= (uint8_t)(1 << (index % 8));
+      nbReceived++;
+    }
+    if (nbReceived < nbChunks)
+      return 0;                                // the QUERY will tell
+
+    if (crc32(view, total) == fileCrc)
+    {
+      status = OK;
+      complete = true;
+    }
+    else                                       // start again
+    {
+      status = CRC_ERROR;
+      memset(received, 0, sizeof(received));
+      nbReceived = 0;
+      if (target && (view = target->open(total)) == NULL)
+        status = TOO_BIG;                      // flash is written once, erase again
+    }
+    return makeReply(reply);
+  }
+
+  //
+  // Next chunks go to buffer (same capacity), once the upload is complete
+  //
+  void setBuffer(uint8_t* next) { buffer = next; }
+
+  //
+  // Next uploads go to storage, NULL = back to the buffer
+  //
+  void setStorage(Storage* next) { storage = next; }
+
+  //
+  // True once per completed upload, size of the file in buffer or storage
+  //
+  bool takeComplete(size_t& size)
+  {
+    if (!complete)
+      return false;
+    complete = false;
+    size = total;
+    return true;
+  }
+
+private:
+  void start(uint16_t id, int count, uint32_t size, uint32_t crc)
+  {
+    session = id;
+    active = true;
+    complete = false;
+    nbChunks = count;
+    total = size;
+    fileCrc = crc;
+    nbReceived = 0;
+    memset(received, 0, sizeof(received));
+    target = storage;
+    view = buffer;
+    if (count > MAX_CHUNKS)
+      status = TOO_BIG;
+    else if (target)
+      status = (view = target->open(size)) != NULL ? PENDING : TOO_BIG;
+    else
+      status = size > capacity ? TOO_BIG : PENDING;
+  }
+
+  size_t makeReply(uint8_t* reply)
+  {
+    reply[0] = MAGIC0;
+    reply[1] = MAGIC1;
+    reply[2] = status == OK ? ACK : NACK;
+    put16(reply + 3, session);
+    reply[5] = (uint8_t)status;
+
+    int base = 0;                              // first missing chunk
+    while (base < nbChunks && (received[base / 8] & (1 << (base % 8))))
+      base++;
+    put16(reply + 6, (uint32_t)base);
+    memset(reply + 8, 0, BITMAP_BYTES);
+    for (int i = 0; i < BITMAP_BYTES * 8 && base + i < nbChunks; i++)
+      if (received[(base + i) / 8] & (1 << ((base + i) % 8)))
+        reply[8 + i / 8] |= (uint8_t)(1 << (i % 8));
+    if (status != PENDING && status != CRC_ERROR)
+      return 8;
+    if (status == CRC_ERROR)
+      status = PENDING;                        // told once
+    return REPLY_SIZE;
+  }
+
+  uint8_t* buffer;
+  size_t   capacity;
+  Storage* storage;                            // for the next upload
+  Storage* target;                             // of this upload, NULL = buffer
+  const uint8_t* view;                         // file being rebuilt
+  bool     active;                             // an upload started
+  bool     complete;                           // not taken yet
+  uint16_t session;
+  int      nbChunks;
+  uint32_t total;
+  uint32_t fileCrc;
+  int      nbReceived;
+  int      status;
+  uint8_t  received[MAX_CHUNKS / 8];
+};
+
+//
+// Sender side counters
+//
+struct Stats
+{
+  int packets;                                 // DATA packets sent
+  int resent;                                  // of which sent again
+  int queries;
+  int timeouts;                                // QUERY without answer
+};
+
+const int MAX_TIMEOUTS   = 20;                 // in a row
+const int MAX_CRC_ERRORS = 3;
+
+//
+// Upload data through link, window chunks between two QUERY packets.
+// Link has bool send(const uint8_t*, size_t) and
+// int recv(uint8_t*, size_t, int timeoutMs), <= 0 on timeout.
+// Returns OK, TOO_BIG, CRC_ERROR or -1 when the device does not answer.
+//
+template <class Link>
+inline int upload(Link& link, const uint8_t* data, size_t total, uint16_t session,
+                  int window, int timeoutMs, Stats& stats)
+{
+  uint8_t  pkt[PACKET_SIZE];
+  uint8_t  reply[REPLY_SIZE + 16];
+  uint8_t  acked[MAX_CHUNKS / 8];
+  uint8_t  sent[MAX_CHUNKS / 8];
+  int      count = chunkCount(total);
+  uint32_t crc = crc32(data, total);
+  int      crcErrors = 0;
+  int      silent = 0;
+
+  memset(&stats, 0, sizeof(stats));
+  if (total == 0 || count > MAX_CHUNKS)
+    return TOO_BIG;
+  memset(acked, 0, sizeof(acked));
+  memset(sent, 0, sizeof(sent));
+
+  for (;;)
+  {
+    int n = 0;                                 // first missing chunks
+    for (int i = 0; i < count && n < window; i++)
+    {
+      if (acked[i / 8] & (1 << (i % 8)))
+        continue;
+      link.send(pkt, makePacket(pkt, DATA, session, i, data, total, crc));
+      stats.packets++;
+      if (sent[i / 8] & (1 << (i % 8)))
+        stats.resent++;
+      sent[i / 8] |= (uint8_t)(1 << (i % 8));
+      n++;
+    }
+    link.send(pkt, makePacket(pkt, QUERY, session, 0, data, total, crc));
+    stats.queries++;
+
+    int len;                                   // answer of this session
+    do
+      len = link.recv(reply, sizeof(reply), timeoutMs);
+    while (len > 0 && (!isFramed(reply, len) || len < 8 || get16(reply + 3) != session));
+    if (len <= 0)
+    {
+      stats.timeouts++;
+      if (++silent >= MAX_TIMEOUTS)
+        return -1;
+      continue;
+    }
+    silent = 0;
+
+    switch (reply[5])
+    {
+    case OK:
+      return OK;
+
+    case TOO_BIG:
+      return TOO_BIG;
+
+    case CRC_ERROR:
+      if (++crcErrors >= MAX_CRC_ERRORS)
+        return CRC_ERROR;
+      memset(acked, 0, sizeof(acked));
+      break;
+
+    default:                                   // PENDING, bitmap from base
+      if (len < REPLY_SIZE)
+        break;
+      int base = get16(reply + 6);
+      for (int i = 0; i < base && i < count; i++)
+        acked[i / 8] |= (uint8_t)(1 << (i % 8));
+      for (int i = 0; i < BITMAP_BYTES * 8 && base + i < count; i++)
+        if (reply[8 + i / 8] & (1 << (i % 8)))
+          acked[(base + i) / 8] |= (uint8_t)(1 << ((base + i) % 8));
+      break;
+    }
+  }
+}
+
+} // namespace mpxudp
+
+#endif // MPXUDP_H
@@ -0,0 +1,116 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// pacer.h
+//
+// 1. Frame presentation against absolute deadlines, MegaPix.ino
+// --> the next image is due at the deadline of the previous one plus its
+//     duration, not at the time it was drawn plus its duration: the decode
+//     and show times do not add up, the animation keeps its rhythm
+// --> an image whose whole duration is over before it could be shown is
+//     dropped, the following one is due at the same deadline
+// --> jitter: how late each image is shown after its deadline, min, mean and
+//     max, with the shown and dropped counts since the last resetStats()
+// --> times in any unit (us on the ESP32), 32 bits with wrap around
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Absolute deadlines, jitter and drop counters
+//
+
+#ifndef PACER_H
+#define PACER_H
+
+#include <stdint.h>
+
+struct PacerStats
+{
+  uint32_t shown;
+  uint32_t dropped;
+  uint32_t jitterMin;
+  uint32_t jitterMax;
+  uint64_t jitterSum;                          // mean = jitterSum / shown
+
+  uint32_t jitterMean() const { return shown ? (uint32_t)(jitterSum / shown) : 0; }
+};
+
+class Pacer
+{
+public:
+  Pacer() : next(0)
+  {
+    resetStats();
+  }
+
+  //
+  // New timeline, the first image is due now
+  //
+  void restart(uint32_t now) { next = now; }
+
+  bool isDue(uint32_t now) const { return (int32_t)(now - next) >= 0; }
+  uint32_t deadline() const { return next; }
+
+  //
+  // The image due lasts duration and its time is already over: it is dropped,
+  // true if so. Images of no duration are never dropped.
+  //
+  bool skip(uint32_t now, uint32_t duration)
+  {
+    if (duration == 0 || (int32_t)(now - (next + duration)) < 0)
+      return false;
+    next += duration;
+    st.dropped++;
+    return true;
+  }
+
+  //
+  // The image due has been shown at now, it lasts duration
+  //
+  void shown(uint32_t now, uint32_t duration)
+  {
+    uint32_t jitter = (int32_t)(now - next) > 0 ? now - next : 0;
+    if (jitter < st.jitterMin)
+      st.jitterMin = jitter;
+    if (jitter > st.jitterMax)
+      st.jitterMax = jitter;
+    st.jitterSum += jitter;
+    st.shown++;
+    next += duration;
+  }
+
+  const PacerStats& stats() const { return st; }
+
+  void resetStats()
+  {
+    st.shown = 0;
+    st.dropped = 0;
+    st.jitterMin = 0xFFFFFFFF;
+    st.jitterMax = 0;
+    st.jitterSum = 0;
+  }
+
+private:
+  uint32_t   next;                             // deadline of the image due
+  PacerStats st;
+};
+
+#endif // PACER_H
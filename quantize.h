@@ -0,0 +1,472 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// quantize.h
+//
+// 1. Color quantization of the BMP animations, MegaPix18 and mpxconv
+// --> one palette for all the images of an animation, built in Oklab where
+//     distances follow the perceived differences: weighted median cut of
+//     the colors used, then k-means (Lloyd) iterations from these boxes
+// --> Black and White are always pal[0] and pal[1] of an MPX: they are fixed
+//     centroids, the other colors move around them
+// --> distance kernel over the palette in separate L, a, b arrays padded to
+//     blocks of 8, the compiler vectorizes the block loop (SSE/AVX/NEON)
+// --> map() gives the palette indices of one image with no dithering,
+//     ordered dithering (Bayer 4x4 between the two closest colors, the same
+//     pattern on every image so a still area does not flicker) or error
+//     diffusion (Floyd-Steinberg in Oklab, serpentine)
+// --> error of an image: mean and max distance in Oklab x100 between the
+//     source pixels and the colors shown, about 1 for a just noticeable
+//     difference
+// --> deterministic: same input, same palette and maps on any thread
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Median cut + k-means in Oklab, ordered and error diffusion dithering
+//
+
+#ifndef QUANTIZE_H
+#define QUANTIZE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+namespace quant
+{
+
+const int MAX_COLORS = 256;              // B&W included
+const int BLOCK      = 8;                // kernel lanes
+const int ITERATIONS = 8;                // k-means passes at most
+
+enum Dither { DITHER_NONE, DITHER_ORDERED, DITHER_DIFFUSION };
+
+struct Lab
+{
+  float L;
+  float a;
+  float b;
+};
+
+struct Color
+{
+  uint8_t R;
+  uint8_t G;
+  uint8_t B;
+};
+
+struct ImageError
+{
+  float mean;                            // Oklab distance x100
+  float max;
+};
+
+//--------------------------------------------------------
+// sRGB <-> Oklab
+//--------------------------------------------------------
+inline const float* linearTable()
+{
+  struct Table
+  {
+    float v[256];
+    Table()
+    {
+      for (int i = 0; i < 256; i++)
+      {
+        float c = i / 255.0f;
+        v[i] = c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+      }
+    }
+  };
+  static const Table table;              // thread safe first use
+  return table.v;
+}
+
+inline Lab toLab(uint8_t R, uint8_t G, uint8_t B)
+{
+  const float* lin = linearTable();
+  float r = lin[R], g = lin[G], b = lin[B];
+  float l = cbrtf(0.4122214708f * r + 0.5363325363f * g + 0.0514459929f * b);
+  float m = cbrtf(0.2119034982f * r + 0.6806995451f * g + 0.1073969566f * b);
+  float s = cbrtf(0.0883024619f * r + 0.2817188376f * g + 0.6299787005f * b);
+  Lab lab;
+  lab.L = 0.2104542553f * l + 0.7936177850f * m - 0.0040720468f * s;
+  lab.a = 1.9779984951f * l - 2.4285922050f * m + 0.4505937099f * s;
+  lab.b = 0.0259040371f * l + 0.7827717662f * m - 0.8086757660f * s;
+  return lab;
+}
+
+inline uint8_t toByte(float c)
+{
+  c = c <= 0.0031308f ? 12.92f * c : 1.055f * powf(c, 1 / 2.4f) - 0.055f;
+  c = c * 255 + 0.5f;
+  return c <= 0 ? 0 : c >= 255 ? 255 : (uint8_t)c;
+}
+
+inline Color toRgb(const Lab& lab)
+{
+  float l = lab.L + 0.3963377774f * lab.a + 0.2158037573f * lab.b;
+  float m = lab.L - 0.1055613458f * lab.a - 0.0638541728f * lab.b;
+  float s = lab.L - 0.0894841775f * lab.a - 1.2914855480f * lab.b;
+  l = l * l * l;
+  m = m * m * m;
+  s = s * s * s;
+  Color c;
+  c.R = toByte( 4.0767416621f * l - 3.3077115913f * m + 0.2309699292f * s);
+  c.G = toByte(-1.2684380046f * l + 2.6097574011f * m - 0.3413193965f * s);
+  c.B = toByte(-0.0041960863f * l - 0.7034186147f * m + 1.7076147010f * s);
+  return c;
+}
+
+inline float distance2(const Lab& x, const Lab& y)
+{
+  float dL = x.L - y.L, da = x.a - y.a, db = x.b - y.b;
+  return dL * dL + da * da + db * db;
+}
+
+//--------------------------------------------------------
+// Quantizer
+//--------------------------------------------------------
+class Quantizer
+{
+public:
+  Quantizer() : nbColors(0), padded(0) {}
+
+  //
+  // Palette of at most maxColors + B&W for the nbPixels R,G,B of all images
+  //
+  void build(const uint8_t* rgb, size_t nbPixels, int maxColors)
+  {
+    if (maxColors > MAX_COLORS - 2)
+      maxColors = MAX_COLORS - 2;
+    histogram(rgb, nbPixels);
+    medianCut(maxColors);
+    kmeans();
+    finish();
+  }
+
+  int size() const { return nbColors; }                  // B&W included
+  const Color& color(int idx) const { return colors[idx]; }
+
+  //
+  // Closest palette color, squared distance in dist
+  //
+  int nearest(const Lab& p, float* dist = NULL) const
+  {
+    float d[MAX_COLORS + BLOCK];
+    for (int k = 0; k < padded; k += BLOCK)     // vectorized, 8 lanes
+      for (int j = 0; j < BLOCK; j++)
+      {
+        float dL = palL[k + j] - p.L, da = palA[k + j] - p.a, db = palB[k + j] - p.b;
+        d[k + j] = dL * dL + da * da + db * db;
+      }
+    int best = 0;
+    for (int k = 1; k < nbColors; k++)
+      if (d[k] < d[best])
+        best = k;
+    if (dist)
+      *dist = d[best];
+    return best;
+  }
+
+  //
+  // Palette indices of one image of width x height R,G,B pixels
+  //
+  ImageError map(const uint8_t* rgb, int width, int height, Dither dither, uint8_t* out) const
+  {
+    static const uint8_t bayer[4][4] = { { 0, 8, 2, 10 }, { 12, 4, 14, 6 }, { 3, 11, 1, 9 }, { 15, 7, 13, 5 } };
+    ImageError err = { 0, 0 };
+    std::vector<Lab> diffused;
+    if (dither == DITHER_DIFFUSION)
+      diffused.assign((size_t)2 * (width + 2), Lab());
+
+    for (int y = 0; y < height; y++)
+    {
+      Lab* cur = dither == DITHER_DIFFUSION ? &diffused[(y & 1) * (width + 2) + 1] : NULL;
+      Lab* next = dither == DITHER_DIFFUSION ? &diffused[((y + 1) & 1) * (width + 2) + 1] : NULL;
+      if (next)
+        std::fill(next - 1, next + width + 1, Lab());
+      bool back = dither == DITHER_DIFFUSION && (y & 1);   // serpentine
+      for (int i = 0; i < width; i++)
+      {
+        int x = back ? width - 1 - i : i;
+        const uint8_t* px = rgb + 3 * ((size_t)y * width + x);
+        Lab src = toLab(px[0], px[1], px[2]);
+        int idx;
+        if (dither == DITHER_ORDERED)
+          idx = ordered(src, (bayer[y & 3][x & 3] + 0.5f) / 16);
+        else if (dither == DITHER_DIFFUSION)
+        {
+          Lab want = { src.L + cur[x].L, src.a + cur[x].a, src.b + cur[x].b };
+          idx = nearest(want);
+          Lab e = { want.L - palL[idx], want.a - palA[idx], want.b - palB[idx] };
+          int dx = back ? -1 : 1;
+          spread(cur[x + dx], e, 7 / 16.0f);
+          spread(next[x - dx], e, 3 / 16.0f);
+          spread(next[x], e, 5 / 16.0f);
+          spread(next[x + dx], e, 1 / 16.0f);
+        }
+        else
+          idx = nearest(src);
+        out[y * width + x] = (uint8_t)idx;
+
+        Lab shown = { palL[idx], palA[idx], palB[idx] };
+        float d = sqrtf(distance2(src, shown)) * 100;
+        err.mean += d;
+        err.max = d > err.max ? d : err.max;
+      }
+    }
+    if (width * height > 0)
+      err.mean /= (float)(width * height);
+    return err;
+  }
+
+private:
+  //
+  // Colors used and their pixel counts, sorted on the packed RGB value
+  //
+  void histogram(const uint8_t* rgb, size_t nbPixels)
+  {
+    std::vector<uint32_t> keys(nbPixels);
+    for (size_t p = 0; p < nbPixels; p++, rgb += 3)
+      keys[p] = ((uint32_t)rgb[0] << 16) | ((uint32_t)rgb[1] << 8) | rgb[2];
+    std::sort(keys.begin(), keys.end());
+
+    points.clear();
+    weights.clear();
+    for (size_t p = 0; p < nbPixels; )
+    {
+      size_t q = p;
+      while (q < nbPixels && keys[q] == keys[p])
+        q++;
+      points.push_back(toLab((uint8_t)(keys[p] >> 16), (uint8_t)(keys[p] >> 8), (uint8_t)keys[p]));
+      weights.push_back((float)(q - p));
+      p = q;
+    }
+  }
+
+  struct Box
+  {
+    int    begin;
+    int    end;
+    double error;                        // weighted sum of squares
+    int    axis;                         // of the largest spread
+    Lab    mean;
+  };
+
+  static float coord(const Lab& p, int axis) { return axis == 0 ? p.L : axis == 1 ? p.a : p.b; }
+
+  void measure(Box& box) const
+  {
+    double w = 0, s[3] = { 0, 0, 0 }, s2[3] = { 0, 0, 0 };
+    for (int i = box.begin; i < box.end; i++)
+    {
+      const Lab& p = points[order[i]];
+      double pw = weights[order[i]];
+      w += pw;
+      for (int k = 0; k < 3; k++)
+      {
+        s[k] += pw * coord(p, k);
+        s2[k] += pw * coord(p, k) * coord(p, k);
+      }
+    }
+    box.error = 0;
+    box.axis = 0;
+    double best = -1;
+    for (int k = 0; k < 3; k++)
+    {
+      double sse = s2[k] - s[k] * s[k] / w;
+      box.error += sse;
+      if (sse > best)
+        best = sse, box.axis = k;
+    }
+    box.mean.L = (float)(s[0] / w);
+    box.mean.a = (float)(s[1] / w);
+    box.mean.b = (float)(s[2] / w);
+  }
+
+  //
+  // Splits the box of largest error at its weighted median until maxColors boxes
+  //
+  void medianCut(int maxColors)
+  {
+    order.resize(points.size());
+    for (size_t i = 0; i < order.size(); i++)
+      order[i] = (int)i;
+    std::vector<Box> boxes(points.empty() ? 0 : 1);
+    if (!points.empty())
+    {
+      boxes[0].begin = 0;
+      boxes[0].end = (int)points.size();
+      measure(boxes[0]);
+    }
+
+    while ((int)boxes.size() < maxColors)
+    {
+      int pick = -1;
+      for (size_t b = 0; b < boxes.size(); b++)
+        if (boxes[b].end - boxes[b].begin > 1 && boxes[b].error > 0 &&
+            (pick < 0 || boxes[b].error > boxes[pick].error))
+          pick = (int)b;
+      if (pick < 0)
+        break;                           // every color has its own box
+
+      Box box = boxes[pick];
+      int axis = box.axis;
+      const std::vector<Lab>& pts = points;
+      std::sort(order.begin() + box.begin, order.begin() + box.end, [&pts, axis](int x, int y)
+      {
+        float cx = coord(pts[x], axis), cy = coord(pts[y], axis);
+        return cx < cy || (cx == cy && x < y);
+      });
+      double half = 0, acc = 0;
+      for (int i = box.begin; i < box.end; i++)
+        half += weights[order[i]];
+      half /= 2;
+      int cut = box.begin + 1;
+      for (int i = box.begin; i < box.end - 1 && acc + weights[order[i]] <= half; i++)
+      {
+        acc += weights[order[i]];
+        cut = i + 1;
+      }
+      if (cut <= box.begin)
+        cut = box.begin + 1;
+
+      Box lo = box, hi = box;
+      lo.end = cut;
+      hi.begin = cut;
+      measure(lo);
+      measure(hi);
+      boxes[pick] = lo;
+      boxes.push_back(hi);
+    }
+
+    centroids.resize(2 + boxes.size());
+    centroids[0] = toLab(0, 0, 0);
+    centroids[1] = toLab(255, 255, 255);
+    for (size_t b = 0; b < boxes.size(); b++)
+      centroids[2 + b] = boxes[b].mean;
+  }
+
+  //
+  // Lloyd iterations over the colors used, B&W do not move
+  //
+  void kmeans()
+  {
+    std::vector<int> owner(points.size(), -1);
+    for (int it = 0; it < ITERATIONS; it++)
+    {
+      load(centroids);
+      bool moved = false;
+      std::vector<double> sum(4 * centroids.size(), 0.0);
+      for (size_t p = 0; p < points.size(); p++)
+      {
+        int k = nearest(points[p]);
+        moved |= owner[p] != k;
+        owner[p] = k;
+        double w = weights[p];
+        sum[4 * k] += w;
+        sum[4 * k + 1] += w * points[p].L;
+        sum[4 * k + 2] += w * points[p].a;
+        sum[4 * k + 3] += w * points[p].b;
+      }
+      if (!moved)
+        break;
+      for (size_t k = 2; k < centroids.size(); k++)
+        if (sum[4 * k] > 0)              // an empty cluster keeps its place
+        {
+          centroids[k].L = (float)(sum[4 * k + 1] / sum[4 * k]);
+          centroids[k].a = (float)(sum[4 * k + 2] / sum[4 * k]);
+          centroids[k].b = (float)(sum[4 * k + 3] / sum[4 * k]);
+        }
+    }
+  }
+
+  //
+  // Palette in 8 bit RGB, the kernel then works on the colors really shown
+  //
+  void finish()
+  {
+    std::vector<Lab> shown(centroids.size());
+    for (size_t k = 0; k < centroids.size(); k++)
+    {
+      colors[k] = toRgb(centroids[k]);
+      shown[k] = toLab(colors[k].R, colors[k].G, colors[k].B);
+    }
+    load(shown);
+  }
+
+  void load(const std::vector<Lab>& pal)
+  {
+    nbColors = (int)pal.size();
+    padded = (nbColors + BLOCK - 1) / BLOCK * BLOCK;
+    for (int k = 0; k < padded; k++)
+    {
+      bool used = k < nbColors;
+      palL[k] = used ? pal[k].L : 1e9f;  // never the nearest
+      palA[k] = used ? pal[k].a : 0;
+      palB[k] = used ? pal[k].b : 0;
+    }
+  }
+
+  //
+  // Ordered dithering between the closest color and the one on the other
+  // side of the pixel, threshold in ]0, 1[
+  //
+  int ordered(const Lab& p, float threshold) const
+  {
+    int c1 = nearest(p);
+    Lab e = { p.L - palL[c1], p.a - palA[c1], p.b - palB[c1] };
+    Lab beyond = { p.L + e.L, p.a + e.a, p.b + e.b };
+    int c2 = nearest(beyond);
+    if (c2 == c1)
+      return c1;
+    Lab step = { palL[c2] - palL[c1], palA[c2] - palA[c1], palB[c2] - palB[c1] };
+    float len2 = step.L * step.L + step.a * step.a + step.b * step.b;
+    float f = (e.L * step.L + e.a * step.a + e.b * step.b) / len2;   // 0 at c1, 1 at c2
+    return threshold < f ? c2 : c1;
+  }
+
+  static void spread(Lab& to, const Lab& e, float w)
+  {
+    to.L += e.L * w;
+    to.a += e.a * w;
+    to.b += e.b * w;
+  }
+
+  std::vector<Lab>   points;             // colors used
+  std::vector<float> weights;            // their pixel counts
+  std::vector<int>   order;              // median cut boxes are ranges of it
+  std::vector<Lab>   centroids;
+  Color colors[MAX_COLORS];
+  int   nbColors;
+  int   padded;                          // nbColors rounded up to BLOCK
+  float palL[MAX_COLORS + BLOCK];
+  float palA[MAX_COLORS + BLOCK];
+  float palB[MAX_COLORS + BLOCK];
+};
+
+} // namespace quant
+
+#endif // QUANTIZE_H
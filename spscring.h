@@ -0,0 +1,123 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// spscring.h
+//
+// 1. Lock-free ring between one producer and one consumer
+// --> fixed ring of N slots of T, head written by the producer only, tail
+//     by the consumer only: no lock, no wait on either side
+// --> a full ring drops the item and counts it, the producer never waits
+//     for the consumer
+// --> push() / pop() copy a whole T; claim() / publish() and peek() /
+//     release() fill or read a slot in place, for big slots of which only
+//     a part is used
+// --> the command queues (cmdqueue.h) and the live packet ring (mpxlive.h)
+//     of MegaPix
+//
+// T. JOUBERT
+// v1.0   16 Oct. 2026     One ring for the command queues and the live packets
+//
+
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <stdint.h>
+#include <atomic>
+
+template <class T, int N>
+class SpscRing
+{
+public:
+  SpscRing() : head(0), tail(0), full(0) {}
+
+  //
+  // Producer, the free slot to fill then publish(), NULL when the ring is
+  // full (counted)
+  //
+  T* claim()
+  {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= (uint32_t)N)
+    {
+      drop();
+      return NULL;
+    }
+    return &slots[h % N];
+  }
+
+  void publish() { head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+  //
+  // Producer, counts an item it does not push
+  //
+  void drop() { full.fetch_add(1, std::memory_order_relaxed); }
+
+  //
+  // Consumer, the oldest slot to read then release(), NULL when empty
+  //
+  const T* peek() const
+  {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire))
+      return NULL;
+    return &slots[t % N];
+  }
+
+  void release() { tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+  //
+  // Producer, false when the ring is full
+  //
+  bool push(const T& item)
+  {
+    T* slot = claim();
+    if (slot == NULL)
+      return false;
+    *slot = item;
+    publish();
+    return true;
+  }
+
+  //
+  // Consumer, the oldest item, false when empty
+  //
+  bool pop(T& item)
+  {
+    const T* slot = peek();
+    if (slot == NULL)
+      return false;
+    item = *slot;
+    release();
+    return true;
+  }
+
+  uint32_t rejected() const { return full.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<uint32_t> head;                           // producer only writes
+  std::atomic<uint32_t> tail;                           // consumer only writes
+  std::atomic<uint32_t> full;                           // producer only writes
+  T        slots[N];
+};
+
+#endif // SPSCRING_H
@@ -0,0 +1,456 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// storebench.cpp
+//
+// 1. Test and bench of the MegaPix flash store (mpxstore.h) on Linux, the
+//    flash is a file (mpxstore::FileFlash) with the NOR rules of the ESP32
+// --> uploads: animations of 1 to 200 KB go through mpxudp::Receiver straight
+//     into the store, chunks in random order with duplicates, many times the
+//     size of the store so the log wraps; the player pins every 32nd upload,
+//     the pinned record must never change; every record is checked after each
+//     upload and the store is mounted again every 16 uploads
+// --> power cuts: uploads stopped at a random erase or write operation, then
+//     mounted again as after a reboot: every record found is intact, the
+//     records out of the way of the cut upload are all there, the cut one is
+//     complete or absent
+// --> read path: images validated and rendered in place from the mapped
+//     store, and after a copy in RAM as the firmware did before; mount time
+//     and upload rate
+//
+// usage: storebench [-kb n] [-uploads n] [-cuts n] [-file path]
+//        -file keeps the flash in path, it is erased first
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Uploads, power cuts, read path
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <random>
+#include <vector>
+#include "mpx.h"
+#include "mpxrender.h"
+#include "mpxudp.h"
+#include "mpxstore.h"
+#include "motifsMPX.h"
+
+#define VERSION "v1.0  2026-10-15"
+
+typedef mpxstore::Store<mpxstore::FileFlash> Store;
+typedef std::chrono::steady_clock Clock;
+
+struct Led
+{
+  uint8_t r, g, b;
+};
+
+static std::mt19937 rng(2023);
+static int failures = 0;
+
+static void fail(const char* what, uint32_t gen)
+{
+  if (failures++ < 10)
+    printf("!!! %s, generation %u !!!\n", what, gen);
+}
+
+static double msSince(Clock::time_point t0)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+//
+// Animation of generation gen, 1 to 200 noisy images: 1 KB to about 200 KB.
+// The generation is stored in the first palette color.
+//
+static std::vector<uint8_t> makeAnim(uint32_t gen)
+{
+  mpx::PaletteBuilder pal;
+  uint8_t map[mpx::PIXELS];
+  int nbImages = 1 + gen * 37 % 200;
+  std::vector<uint8_t> out(nbImages * (2 * mpx::PIXELS + 2) + 3 * mpx::PAL_SIZE);
+  uint32_t h = gen;
+
+  pal.index((uint8_t)gen, (uint8_t)(gen >> 8), (uint8_t)(1 + ((gen >> 16) & 0x7F)));
+  for (int c = 0; c < 40; c++)
+    pal.index((uint8_t)(6 * c), (uint8_t)(255 - 6 * c), 0x55);
+
+  size_t len = mpx::encodeHeader(out.data(), out.size(), pal, nbImages);
+  for (int n = 0; n < nbImages; n++)
+  {
+    for (int p = 0; p < mpx::PIXELS; p++)
+    {
+      h = h * 1103515245 + 12345;
+      map[p] = (uint8_t)((h >> 16) % 3 == 0 ? (h >> 20) % pal.size() : (p / 8 + n) % pal.size());
+    }
+    len += mpx::encodeImage(out.data() + len, out.size() - len, map, 1 + n % 50);
+  }
+  out.resize(len);
+  return out;
+}
+
+static uint32_t generationOf(const uint8_t* anim)
+{
+  return anim[2] | (anim[3] << 8) | ((uint32_t)(anim[4] - 1) << 16);
+}
+
+//
+// Record holds the animation of its generation: same length, CRC of the file
+// as in the header and as the one of the animation
+//
+static bool checkRecord(const Store& store, const mpxstore::Record& rec)
+{
+  static std::map<uint32_t, std::pair<size_t, uint32_t> > known;   // gen: length, CRC
+  const uint8_t* data = store.data(rec);
+
+  if (rec.length < 5 || !store.check(rec))
+    return false;
+  uint32_t gen = generationOf(data);
+  if (known.find(gen) == known.end())
+  {
+    std::vector<uint8_t> expected = makeAnim(gen);
+    known[gen] = std::make_pair(expected.size(), mpxudp::crc32(expected.data(), expected.size()));
+  }
+  return known[gen].first == rec.length && known[gen].second == rec.crc;
+}
+
+static bool checkAll(const Store& store, uint32_t gen)
+{
+  bool ok = true;
+  for (int i = 0; i < store.count(); i++)
+    if (!checkRecord(store, store.record(i)))
+    {
+      fail("record damaged", gen);
+      ok = false;
+    }
+  return ok;
+}
+
+static bool sameTable(const Store& a, const Store& b)
+{
+  if (a.count() != b.count())
+    return false;
+  for (int i = 0; i < a.count(); i++)
+    if (a.record(i).offset != b.record(i).offset || a.record(i).seq != b.record(i).seq ||
+        a.record(i).length != b.record(i).length || a.record(i).crc != b.record(i).crc)
+      return false;
+  return true;
+}
+
+//
+// DATA packets of file in random order with duplicates, false when the
+// device answers TOO_BIG or does not complete
+//
+static bool upload(mpxudp::Receiver& rx, const std::vector<uint8_t>& file, uint16_t session)
+{
+  uint8_t pkt[mpxudp::PACKET_SIZE];
+  uint8_t reply[mpxudp::REPLY_SIZE];
+  uint32_t crc = mpxudp::crc32(file.data(), file.size());
+  std::vector<int> order;
+
+  for (int i = 0; i < mpxudp::chunkCount(file.size()); i++)
+  {
+    order.push_back(i);
+    if (rng() % 4 == 0)
+      order.push_back(i);                      // duplicate
+  }
+  std::shuffle(order.begin(), order.end(), rng);
+  for (int index : order)
+  {
+    size_t len = mpxudp::makePacket(pkt, mpxudp::DATA, session, index, file.data(), file.size(), crc);
+    if (rx.onPacket(pkt, len, reply) > 0 && reply[5] == mpxudp::TOO_BIG)
+      return false;
+  }
+  size_t size;
+  return rx.takeComplete(size) && size == file.size();
+}
+
+//
+// Uploads through the Receiver, a player pinning every 32nd one
+//
+static void testUploads(mpxstore::FileFlash& flash, const char* path, int uploads)
+{
+  Store store(flash);
+  std::atomic<uint32_t> latest(mpxstore::NONE);
+  std::atomic<uint32_t> pinned(mpxstore::NONE);
+  mpxstore::Upload<Store> storage(store, latest, pinned);
+  mpxudp::Receiver rx(NULL, 0);
+  std::vector<uint8_t> pinnedFile;
+  std::vector<uint8_t> latestFile;
+  int refused = 0;
+  int remounts = 0;
+  double bytes = 0;
+
+  rx.setStorage(&storage);
+  store.mount();
+  Clock::time_point t0 = Clock::now();
+  for (uint32_t gen = 1; gen <= (uint32_t)uploads; gen++)
+  {
+    std::vector<uint8_t> file = makeAnim(gen);
+    if (!upload(rx, file, (uint16_t)gen))
+    {                                          // in the way of the pinned record
+      refused++;
+      pinned = latest.load();                  // the player moves on
+      pinnedFile = latestFile;
+      if (!upload(rx, file, (uint16_t)(gen + 0x8000)))
+      {
+        fail("upload refused", gen);
+        continue;
+      }
+    }
+    mpxstore::Record rec;
+    if (!store.commit(rec))
+    {
+      fail("commit failed", gen);
+      continue;
+    }
+    latest = rec.offset;
+    latestFile = file;
+    bytes += file.size();
+    if (gen % 32 == 0)
+    {
+      pinned = rec.offset;
+      pinnedFile = file;
+    }
+    if (pinned != mpxstore::NONE && memcmp(flash.map() + pinned + mpxstore::HEADER_SIZE,
+                                           pinnedFile.data(), pinnedFile.size()) != 0)
+      fail("pinned record changed", gen);
+    checkAll(store, gen);
+
+    if (gen % 16 == 0)                         // reboot
+    {
+      uint32_t size = flash.size();
+      if (path)                                // the file again
+      {
+        flash.end();
+        if (!flash.begin(path, size))
+        {
+          fail("flash file lost", gen);
+          return;
+        }
+      }
+      Store again(flash);
+      if (!again.mount() || !sameTable(store, again))
+        fail("mounted again, other records", gen);
+      remounts++;
+    }
+  }
+  double ms = msSince(t0);
+
+  printf("uploads              : %d, %.1f MB, %d refused for the pinned record\n",
+         uploads, bytes / 1e6, refused);
+  printf("records in the store : %d, mounted again %d times\n", store.count(), remounts);
+  printf("upload + checks      : %.0f ms\n\n", ms);
+}
+
+//
+// Uploads cut by a power loss, then mounted again
+//
+static void testCuts(mpxstore::FileFlash& flash, int cuts)
+{
+  Store store(flash);
+  int complete = 0;
+  int dropped = 0;
+  int lost = 0;
+
+  store.mount();
+  for (int c = 1; c <= cuts; c++)
+  {
+    uint32_t gen = 100000 + c;
+    std::vector<uint8_t> file = makeAnim(gen);
+    std::vector<mpxstore::Record> before;
+    for (int i = 0; i < store.count(); i++)
+      before.push_back(store.record(i));
+    uint32_t off = store.nextOffset(file.size());
+    uint32_t len = mpxstore::sectors(file.size()) * mpxstore::SECTOR_SIZE;
+
+    flash.cutAfter(rng() % 6, rng());          // removals, erase, file, header
+    mpxstore::Record rec;
+    bool added = store.add(file.data(), file.size(), rec);
+    flash.cutAfter(-1);
+
+    if (!store.mount())                        // reboot
+    {
+      fail("mount failed", gen);
+      return;
+    }
+    checkAll(store, gen);
+    for (size_t i = 0; i < before.size(); i++)
+    {
+      const mpxstore::Record& b = before[i];
+      bool inTheWay = b.offset < off + len && off < b.offset + mpxstore::sectors(b.length) * mpxstore::SECTOR_SIZE;
+      bool oldest = i == 0 && before.size() == mpxstore::MAX_RECORDS;
+      bool found = false;
+      for (int j = 0; j < store.count(); j++)
+        found |= store.record(j).offset == b.offset && store.record(j).seq == b.seq;
+      if (!found && !inTheWay && !oldest)
+      {
+        fail("record lost", gen);
+        lost++;
+      }
+    }
+    bool present = store.count() > 0 &&
+                   generationOf(store.data(store.record(store.count() - 1))) == gen;
+    if (added && !present)
+      fail("committed record missing", gen);
+    present ? complete++ : dropped++;
+  }
+
+  printf("power cuts           : %d, upload complete %d, dropped %d, records lost %d\n\n",
+         cuts, complete, dropped, lost);
+}
+
+//
+// Validate and render every image of data, returns the image count
+//
+static int playAll(const uint8_t* data, size_t len, Led* leds)
+{
+  static mpx::Animation anim;
+  uint8_t palCol[mpx::PAL_SIZE * 3];
+  Led pal[mpx::PAL_SIZE];
+
+  if (!mpx::validate(data, len, anim))
+    return 0;
+  mpx::readPalette(data, anim.hdr, palCol);
+  mpx::scalePalette(palCol, mpx::PAL_SIZE, 1, pal);
+  for (int n = 0; n < anim.idx.nbImages; n++)
+  {
+    mpx::Image img;
+    mpx::indexedImage(data, anim.idx, n, img);
+    mpx::renderVerified(img, pal, leds);
+  }
+  return anim.idx.nbImages;
+}
+
+//
+// Read path: in place from the mapped flash, or copied in RAM first
+//
+static void benchRead(mpxstore::FileFlash& flash)
+{
+  Store store(flash);
+  mpxstore::Record rec;
+  const char* motifs[] = { palette, donald, heart, mickey, perle, tjo };
+  const size_t sizes[] = { sizeof(palette), sizeof(donald), sizeof(heart),
+                           sizeof(mickey), sizeof(perle), sizeof(tjo) };
+  static Led leds[mpx::PIXELS];
+  double bytes = 0;
+
+  flash.erase(0, flash.size());
+  store.mount();
+  Clock::time_point t0 = Clock::now();
+  for (int i = 0; i < 6; i++)
+  {
+    store.add((const uint8_t*)motifs[i], sizes[i], rec);
+    bytes += sizes[i];
+  }
+  for (uint32_t gen = 1; bytes + 200000 < flash.size() * 0.75; gen += 7)
+  {
+    std::vector<uint8_t> file = makeAnim(gen);
+    if (!store.add(file.data(), file.size(), rec))
+      break;
+    bytes += file.size();
+  }
+  double addMs = msSince(t0);
+
+  int mounts = 0;
+  t0 = Clock::now();
+  while (msSince(t0) < 200)
+  {
+    Store again(flash);
+    again.mount();
+    mounts++;
+  }
+  double mountMs = msSince(t0) / mounts;
+
+  long images[2] = { 0, 0 };
+  double ns[2];
+  std::vector<uint8_t> ram;
+  for (int way = 0; way < 2; way++)            // in place, then copied
+  {
+    t0 = Clock::now();
+    while (msSince(t0) < 300)
+      for (int i = 0; i < store.count(); i++)
+      {
+        const mpxstore::Record& r = store.record(i);
+        if (way == 0)
+          images[way] += playAll(store.data(r), r.length, leds);
+        else
+        {
+          ram.assign(store.data(r), store.data(r) + r.length);
+          images[way] += playAll(ram.data(), ram.size(), leds);
+        }
+      }
+    ns[way] = msSince(t0) * 1e6 / (images[way] ? images[way] : 1);
+  }
+
+  printf("store                : %u KB, %d records, %.0f KB, written at %.1f MB/s\n",
+         flash.size() / 1024, store.count(), bytes / 1024, bytes / 1e3 / addMs);
+  printf("mount                : %.3f ms\n", mountMs);
+  printf("in place             : %.0f ns per image (validate + render)\n", ns[0]);
+  printf("copied in RAM        : %.0f ns per image\n", ns[1]);
+}
+
+int main(int argc, char** argv)
+{
+  mpxstore::FileFlash flash;
+  const char* path = NULL;
+  int kb = 1024;
+  int uploads = 400;
+  int cuts = 1000;
+
+  printf("%s %s\n\n", argv[0], VERSION);
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-kb") == 0 && i + 1 < argc)
+      kb = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-uploads") == 0 && i + 1 < argc)
+      uploads = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-cuts") == 0 && i + 1 < argc)
+      cuts = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-file") == 0 && i + 1 < argc)
+      path = argv[++i];
+    else
+    {
+      printf("syntaxe: %s [-kb n] [-uploads n] [-cuts n] [-file path]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (kb < 256 || !flash.begin(path, (uint32_t)kb * 1024))
+  {
+    printf("!!! cannot open a flash of %d KB in %s !!!\n", kb, path ? path : "a temporary file");
+    return 1;
+  }
+  flash.erase(0, flash.size());
+
+  testUploads(flash, path, uploads);
+  testCuts(flash, cuts);
+  benchRead(flash);
+
+  printf("\n%s\n", failures == 0 ? "OK" : "FAILED");
+  return failures == 0 ? 0 : 1;
+}
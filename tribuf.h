@@ -0,0 +1,97 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// tribuf.h
+//
+// 1. Triple buffer between the UDP task (writer) and loop() (reader)
+// --> the writer fills its back buffer, then publishes it with one atomic
+//     exchange against the middle buffer
+// --> the reader takes the middle buffer with one atomic exchange when a new
+//     one has been published, it keeps its front buffer until then
+// --> no lock, no wait: the writer never touches the buffer being read and
+//     the reader only sees complete buffers
+// --> one writer, one reader
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Lock-free publish of the UDP motif
+//
+
+#ifndef TRIBUF_H
+#define TRIBUF_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+template <size_t SIZE>
+class TripleBuffer
+{
+public:
+  TripleBuffer() : middle(1), back(0), front(2), published(1)
+  {
+    for (int i = 0; i < 3; i++)
+      sizes[i] = 0;
+  }
+
+  //
+  // Writer side
+  //
+  uint8_t* writeBuffer() { return banks[back]; }
+
+  const uint8_t* lastPublished() const { return banks[published]; }
+  size_t lastPublishedSize() const { return sizes[published]; }
+
+  void publish(size_t size)
+  {
+    sizes[back] = size;
+    published = back;
+    back = middle.exchange((uint8_t)(back | FRESH), std::memory_order_acq_rel) & INDEX;
+  }
+
+  //
+  // Reader side, true when a new buffer has been taken
+  //
+  bool acquire()
+  {
+    if (!(middle.load(std::memory_order_relaxed) & FRESH))
+      return false;
+    front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+    return true;
+  }
+
+  uint8_t* readBuffer() { return banks[front]; }
+  size_t readSize() const { return sizes[front]; }
+
+private:
+  static const uint8_t INDEX = 0x03;
+  static const uint8_t FRESH = 0x04;           // published, not taken yet
+
+  std::atomic<uint8_t> middle;
+  uint8_t  back;                               // writer only
+  uint8_t  front;                              // reader only
+  uint8_t  published;                          // writer only
+  size_t   sizes[3];
+  uint8_t  banks[3][SIZE];
+};
+
+#endif // TRIBUF_H
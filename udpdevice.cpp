@@ -0,0 +1,372 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// udpdevice.cpp
+//
+// 1. MegaPix UDP receiver stand-in on the loopback, Linux
+// --> same mpxudp::Receiver as the firmware, listens on 127.0.0.1:2023
+// --> drops a percentage of the packets in both directions (-loss)
+// --> prints every completed upload and checks it is a readable MPX
+// --> -bench uploads files of several sizes at several loss rates through
+//     mpxudp::upload(), reports throughput and retransmissions
+// --> plays the live frames of mpxlive.h (livesend.cpp) and prints the
+//     counters of the jitter buffer every second
+//
+// usage: udpdevice [-loss percent] [-port n] [-cap bytes] [-n uploads]
+//        udpdevice -bench
+//        then: SendMotifUDP snoopy.mpx 127.0.0.1 2023
+//        or:   livesend -delta -demo 300 127.0.0.1 2023
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Loopback device, loss and throughput bench
+// v1.1   15 Oct. 2026     Live frames
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include "mpx.h"
+#include "mpxudp.h"
+#include "mpxlive.h"
+#include "motifsMPX.h"
+
+#define VERSION "v1.1  2026-10-15"
+
+#define DEVICE_PORT   2023
+#define DEVICE_CAP    (16*1024)      // UDP_MAX_MPX of MegaPix.ino
+#define BENCH_TIMEOUT 20             // ms, loopback answers at once
+#define LIVE_POLL     2              // ms, frame display resolution
+
+typedef std::chrono::steady_clock Clock;
+
+//
+// Device side: receives, loses, answers
+//
+struct Device
+{
+  int              sock;
+  double           loss;             // 0..1, both directions
+  std::vector<uint8_t> buffer;
+  mpxudp::Receiver receiver;
+  std::mt19937     rng;
+  int              uploads;          // completed
+  int              dropped;          // simulated losses
+  std::vector<uint8_t> last;         // last completed file
+  mpxlive::Player  live;
+  Clock::time_point start;
+
+  Device(int sock, size_t capacity, double loss)
+    : sock(sock), loss(loss), buffer(capacity),
+      receiver(buffer.data(), capacity), rng(2023), uploads(0), dropped(0),
+      start(Clock::now()) {}
+
+  uint32_t millis() const
+  {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+  }
+
+  bool lose()
+  {
+    if (loss > 0 && std::uniform_real_distribution<double>(0, 1)(rng) < loss)
+    {
+      dropped++;
+      return true;
+    }
+    return false;
+  }
+
+  //
+  // One packet, false on timeout
+  //
+  bool step(int timeoutMs, bool verbose)
+  {
+    uint8_t pkt[2048];
+    uint8_t reply[mpxudp::REPLY_SIZE];
+    sockaddr_in from;
+    socklen_t fromLen = sizeof(from);
+    fd_set readable;
+    timeval tv = { timeoutMs / 1000, (timeoutMs % 1000) * 1000 };
+
+    FD_ZERO(&readable);
+    FD_SET(sock, &readable);
+    if (select(sock + 1, &readable, NULL, NULL, &tv) <= 0)
+      return false;
+    ssize_t len = recvfrom(sock, pkt, sizeof(pkt), 0, (sockaddr*)&from, &fromLen);
+    if (len <= 0 || lose())
+      return true;
+
+    if (mpxlive::isLive(pkt, len))
+    {
+      live.onPacket(pkt, len, millis());
+      return true;
+    }
+    if (!mpxudp::isFramed(pkt, len))
+    {
+      if (verbose)
+        printf("raw packet, %zd bytes (former protocol)\n", len);
+      return true;
+    }
+    size_t nb = receiver.onPacket(pkt, len, reply);
+    if (nb > 0 && !lose())
+      sendto(sock, reply, nb, 0, (sockaddr*)&from, fromLen);
+
+    size_t size;
+    if (receiver.takeComplete(size))
+    {
+      uploads++;
+      last.assign(buffer.begin(), buffer.begin() + size);
+      if (verbose)
+      {
+        mpx::Header hdr;
+        static mpx::FrameIndex idx;
+        bool ok = mpx::readHeader(last.data(), size, hdr) &&
+                  mpx::buildIndex(last.data(), size, hdr, idx);
+        printf("upload %d complete, %zu bytes, CRC %08X, %s", uploads, size,
+               mpxudp::crc32(last.data(), size), ok ? "MPX" : "not an MPX\n");
+        if (ok)
+          printf(" %d colors %d images\n", hdr.nbColors, hdr.nbImages);
+      }
+    }
+    return true;
+  }
+
+  //
+  // Live frames due, counters once per second while the stream is on
+  //
+  void play(uint32_t& lastReport)
+  {
+    uint32_t now = millis();
+    while (live.frame(now) != NULL)
+      ;
+    if (!live.active(now) || now - lastReport < 1000)
+      return;
+    lastReport = now;
+    const mpxlive::Stats& st = live.stats();
+    printf("live: %2u fps, shown %u, late %u, lost %u, overflow %u, delta miss %u, "
+           "latency %u/%u ms, jitter %u ms\n", st.fps, st.shown, st.late, st.lost,
+           st.overflow, st.deltaMiss, st.shown ? st.latencySum / st.shown : 0,
+           st.latencyMax, st.jitter);
+  }
+};
+
+static int openSocket(int port)
+{
+  int sock = socket(AF_INET, SOCK_DGRAM, 0);
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons((uint16_t)port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (sock < 0 || bind(sock, (sockaddr*)&addr, sizeof(addr)) < 0)
+  {
+    perror("udp socket");
+    exit(1);
+  }
+  return sock;
+}
+
+static int portOf(int sock)
+{
+  sockaddr_in addr;
+  socklen_t len = sizeof(addr);
+  getsockname(sock, (sockaddr*)&addr, &len);
+  return ntohs(addr.sin_port);
+}
+
+//
+// mpxudp::upload() link to the loopback device
+//
+struct LoopLink
+{
+  int         sock;
+  sockaddr_in addr;
+
+  bool send(const uint8_t* data, size_t len)
+  {
+    return sendto(sock, data, len, 0, (sockaddr*)&addr, sizeof(addr)) >= 0;
+  }
+
+  int recv(uint8_t* data, size_t size, int timeoutMs)
+  {
+    fd_set readable;
+    timeval tv = { timeoutMs / 1000, (timeoutMs % 1000) * 1000 };
+
+    FD_ZERO(&readable);
+    FD_SET(sock, &readable);
+    if (select(sock + 1, &readable, NULL, NULL, &tv) <= 0)
+      return 0;
+    return (int)recvfrom(sock, data, size, 0, NULL, NULL);
+  }
+};
+
+static const char* statusName(int status)
+{
+  switch (status)
+  {
+  case mpxudp::OK:        return "OK";
+  case mpxudp::TOO_BIG:   return "too big";
+  case mpxudp::CRC_ERROR: return "CRC error";
+  default:                return "no answer";
+  }
+}
+
+//
+// Uploads through the loopback, device in a thread
+//
+static int bench()
+{
+  static const double losses[] = { 0, 0.05, 0.20 };
+  static const size_t sizes[] = { sizeof(tjo), 16 * 1024, 256 * 1024 };
+  const size_t capacity = 512 * 1024;
+  int failures = 0;
+  uint16_t session = 1;
+
+  std::vector<uint8_t> data(1024 * 1024);
+  std::mt19937 rng(42);
+  for (uint8_t& b : data)
+    b = (uint8_t)rng();
+  memcpy(data.data(), tjo, sizeof(tjo));
+
+  printf("%-8s %7s %6s %5s | %9s %9s | %7s %6s %7s %8s | %s\n", "upload", "bytes",
+         "chunks", "loss", "ms", "KB/s", "packets", "resent", "queries", "timeouts", "result");
+
+  for (double loss : losses)
+  {
+    for (size_t size : sizes)
+    {
+      int devSock = openSocket(0);
+      Device device(devSock, capacity, loss);
+      std::atomic<bool> stop(false);
+      std::thread server([&]()
+      {
+        while (!stop)
+          device.step(10, false);
+      });
+
+      LoopLink link;
+      link.sock = openSocket(0);
+      memset(&link.addr, 0, sizeof(link.addr));
+      link.addr.sin_family = AF_INET;
+      link.addr.sin_port = htons((uint16_t)portOf(devSock));
+      link.addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+      mpxudp::Stats stats;
+      Clock::time_point start = Clock::now();
+      int status = mpxudp::upload(link, data.data(), size, session++, 4, BENCH_TIMEOUT, stats);
+      double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+      stop = true;
+      server.join();
+
+      bool same = status == mpxudp::OK && device.last.size() == size &&
+                  memcmp(device.last.data(), data.data(), size) == 0;
+      if (!same)
+        failures++;
+      printf("%-8s %7zu %6d %4.0f%% | %9.1f %9.0f | %7d %6d %7d %8d | %s%s\n",
+             size == sizeof(tjo) ? "tjo" : "random", size, mpxudp::chunkCount(size),
+             loss * 100, ms, size / ms, stats.packets, stats.resent, stats.queries,
+             stats.timeouts, statusName(status), same ? ", same bytes" : ", FAILED");
+      close(link.sock);
+      close(devSock);
+    }
+  }
+
+  // file bigger than the device
+  {
+    int devSock = openSocket(0);
+    Device device(devSock, DEVICE_CAP, 0);
+    std::atomic<bool> stop(false);
+    std::thread server([&]()
+    {
+      while (!stop)
+        device.step(10, false);
+    });
+    LoopLink link;
+    link.sock = openSocket(0);
+    memset(&link.addr, 0, sizeof(link.addr));
+    link.addr.sin_family = AF_INET;
+    link.addr.sin_port = htons((uint16_t)portOf(devSock));
+    link.addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    mpxudp::Stats stats;
+    int status = mpxudp::upload(link, data.data(), 64 * 1024, session++, 4, BENCH_TIMEOUT, stats);
+    stop = true;
+    server.join();
+    if (status != mpxudp::TOO_BIG)
+      failures++;
+    printf("%-8s %7d %6d %4d%% | %9s %9s | %7d %6d %7d %8d | %s\n", "16K dev", 64 * 1024,
+           mpxudp::chunkCount(64 * 1024), 0, "", "", stats.packets, stats.resent,
+           stats.queries, stats.timeouts, statusName(status));
+    close(link.sock);
+    close(devSock);
+  }
+  return failures ? 1 : 0;
+}
+
+int main(int argc, char** argv)
+{
+  double loss = 0;
+  int port = DEVICE_PORT;
+  size_t capacity = DEVICE_CAP;
+  int maxUploads = 0;
+
+  printf("%s %s\n\n", argv[0], VERSION);
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-bench") == 0)
+      return bench();
+    else if (strcmp(argv[i], "-loss") == 0 && i + 1 < argc)
+      loss = atof(argv[++i]) / 100;
+    else if (strcmp(argv[i], "-port") == 0 && i + 1 < argc)
+      port = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-cap") == 0 && i + 1 < argc)
+      capacity = (size_t)atol(argv[++i]);
+    else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+      maxUploads = atoi(argv[++i]);
+    else
+    {
+      printf("syntaxe: %s [-loss percent] [-port n] [-cap bytes] [-n uploads]\n", argv[0]);
+      printf("         %s -bench\n", argv[0]);
+      return 1;
+    }
+  }
+
+  Device device(openSocket(port), capacity, loss);
+  printf("listening on 127.0.0.1:%d, %zu bytes, %.0f%% loss\n", port, capacity, loss * 100);
+  uint32_t lastReport = 0;
+  while (maxUploads == 0 || device.uploads < maxUploads)
+  {
+    device.step(LIVE_POLL, true);
+    device.play(lastReport);
+  }
+  printf("%d packets lost on purpose\n", device.dropped);
+  return 0;
+}
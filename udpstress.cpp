@@ -0,0 +1,218 @@
+/*
+  ---------------------------------- license ------------------------------------
+  Copyright (C) 2023 Thierry JOUBERT.  All Rights Reserved.
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of
+  this software and associated documentation files (the "Software"), to deal in
+  the Software without restriction, including without limitation the rights to
+  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+  the Software, and to permit persons to whom the Software is furnished to do so,
+  subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+  -------------------------------------------------------------------------------
+*/
+
+// udpstress.cpp
+//
+// 1. Stress test of the MegaPix UDP motif path (mpxudp.h + tribuf.h)
+// --> the writer thread plays the UDP task: it cuts one MPX animation per
+//     generation in chunks, feeds them in random order with duplicates to an
+//     mpxudp::Receiver working in the back buffer, publishes on completion
+// --> the reader thread plays loop(): it takes the published motif, indexes
+//     and decodes all its images, checks every byte against the animation of
+//     that generation, then checks the bytes again once decoded
+// --> the generation is stored in the palette, the number of images changes
+//     with it so a torn motif fails the index or the comparison
+// --> the reader must never see an older generation than the one it holds
+//
+// usage: udpstress [generations]
+//        a ThreadSanitizer build checks the memory ordering:
+//        cmake -S . -B tsan -DCMAKE_CXX_FLAGS=-fsanitize=thread
+//
+// T. JOUBERT
+// v1.0   15 Oct. 2026     Concurrent writer and reader
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include "mpx.h"
+#include "mpxudp.h"
+#include "tribuf.h"
+
+#define VERSION "v1.0  2026-10-15"
+
+#define UDP_MAX_MPX  (16*1024)       // MegaPix.ino
+#define GENERATIONS  20000
+
+typedef std::chrono::steady_clock Clock;
+
+//
+// Animation of generation gen, 1 to 20 images
+//
+static size_t makeMotif(uint32_t gen, uint8_t* out, size_t cap)
+{
+  mpx::PaletteBuilder pal;
+  uint8_t map[mpx::PIXELS];
+  int nbImages = 1 + gen % 20;
+
+  pal.index((uint8_t)gen, (uint8_t)(gen >> 8), (uint8_t)(1 + ((gen >> 16) & 0x7F)));
+  for (int c = 0; c < 6; c++)
+    pal.index((uint8_t)(40 * c), (uint8_t)(255 - 30 * c), 0x55);
+
+  size_t len = mpx::encodeHeader(out, cap, pal, nbImages);
+  for (int n = 0; n < nbImages; n++)
+  {
+    for (int p = 0; p < mpx::PIXELS; p++)
+      map[p] = (uint8_t)(((p / (1 + (gen + n) % 5)) + n) % pal.size());
+    len += mpx::encodeImage(out + len, cap - len, map, 1 + n);
+  }
+  return len;
+}
+
+static uint32_t generationOf(const uint8_t* motif)
+{
+  return motif[2] | (motif[3] << 8) | ((uint32_t)(motif[4] - 1) << 16);
+}
+
+//
+// Reader side check, same steps as AnimateMPX()
+//
+static bool checkMotif(const uint8_t* motif, size_t size, uint32_t& gen)
+{
+  static uint8_t expected[UDP_MAX_MPX];
+  static mpx::FrameIndex idx;
+  uint8_t map[mpx::PIXELS];
+  mpx::Header hdr;
+  mpx::Image img;
+
+  if (size < 5 || motif[size] != 0)
+    return false;
+  gen = generationOf(motif);
+  if (makeMotif(gen, expected, sizeof(expected)) != size ||
+      memcmp(expected, motif, size) != 0)
+    return false;
+  if (!mpx::readHeader(motif, size, hdr) || !mpx::buildIndex(motif, size, hdr, idx))
+    return false;
+  for (int n = 0; n < idx.nbImages; n++)
+  {
+    mpx::indexedImage(motif, idx, n, img);
+    if (mpx::decodeImage(img, map) != mpx::PIXELS)
+      return false;
+  }
+  return memcmp(expected, motif, size) == 0;   // not overwritten meanwhile
+}
+
+int main(int argc, char** argv)
+{
+  static TripleBuffer<UDP_MAX_MPX + 1> udpMotif;
+  uint32_t generations = argc > 1 ? (uint32_t)atol(argv[1]) : GENERATIONS;
+  std::atomic<bool> done(false);
+  std::atomic<uint32_t> written(0);
+
+  printf("%s %s\n\n", argv[0], VERSION);
+  if (generations == 0)
+  {
+    printf("syntaxe: %s [generations]\n", argv[0]);
+    return 1;
+  }
+
+  // motif shown at startup, as setup() does
+  size_t first = makeMotif(0, udpMotif.writeBuffer(), UDP_MAX_MPX);
+  udpMotif.writeBuffer()[first] = 0;
+  udpMotif.publish(first);
+
+  Clock::time_point start = Clock::now();
+
+  std::thread writer([&]()
+  {
+    static uint8_t motif[UDP_MAX_MPX];
+    uint8_t pkt[mpxudp::PACKET_SIZE];
+    uint8_t reply[mpxudp::REPLY_SIZE];
+    mpxudp::Receiver uploader(udpMotif.writeBuffer(), UDP_MAX_MPX);
+    std::mt19937 rng(2023);
+    std::vector<int> order;
+
+    for (uint32_t gen = 1; gen <= generations; gen++)
+    {
+      size_t size = makeMotif(gen, motif, sizeof(motif));
+      uint32_t crc = mpxudp::crc32(motif, size);
+      int nbChunks = mpxudp::chunkCount(size);
+
+      order.clear();
+      for (int i = 0; i < nbChunks; i++)
+      {
+        order.push_back(i);
+        if (rng() % 4 == 0)
+          order.push_back(i);                  // duplicate
+      }
+      std::shuffle(order.begin(), order.end(), rng);
+
+      for (int index : order)
+      {
+        size_t len = mpxudp::makePacket(pkt, mpxudp::DATA, (uint16_t)gen, index, motif, size, crc);
+        uploader.onPacket(pkt, len, reply);
+      }
+      size_t complete;
+      if (!uploader.takeComplete(complete) || complete != size)
+      {
+        printf("generation %u: upload not complete\n", gen);
+        break;
+      }
+      udpMotif.writeBuffer()[complete] = 0;
+      udpMotif.publish(complete);
+      uploader.setBuffer(udpMotif.writeBuffer());
+      written = gen;
+    }
+    done = true;
+  });
+
+  int acquired = 0;
+  int checks = 0;
+  int torn = 0;
+  int older = 0;
+  uint32_t held = 0;
+  bool last = false;
+
+  while (!last)
+  {
+    last = done;                               // one more pass after the end
+    if (udpMotif.acquire())
+      acquired++;
+    uint32_t gen;
+    checks++;
+    if (!checkMotif(udpMotif.readBuffer(), udpMotif.readSize(), gen))
+      torn++;
+    else if (gen < held)
+      older++;
+    else
+      held = gen;
+  }
+  writer.join();
+  double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+  bool ok = torn == 0 && older == 0 && held == written;
+  printf("generations written  : %u\n", (unsigned)written);
+  printf("motifs acquired      : %d\n", acquired);
+  printf("motifs checked       : %d\n", checks);
+  printf("torn motifs          : %d\n", torn);
+  printf("older than held      : %d\n", older);
+  printf("last generation seen : %u\n", held);
+  printf("%.0f ms, %s\n", ms, ok ? "OK" : "FAILED");
+  return ok ? 0 : 1;
+}